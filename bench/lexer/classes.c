@@ -0,0 +1,124 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unicode/uchar.h>
+#include <unicode/utf8.h>
+
+#include "source/cortecs/lexer/classes.h"
+#include "source/cortecs/lexer/unicode_classes.h"
+
+// Compares classifying codepoints with the ICU properties the lexer used to call
+// against the generated table, then tokenizes the same mixed-script source.
+
+#define INPUT_SIZE (16 * 1024 * 1024)
+#define REPEATS 5
+
+static const char *mixed_lines[] = {
+    "function ผลรวม(รายการ) {\n",
+    "    let ผลลัพธ์ = 0\n",
+    "    let café = Größe.berechnen(ผลลัพธ์, 12)\n",
+    "    let λόγος = Σύνολο(αριθμός) + 3\n",
+    "    let значение = Список.длина(элементы)\n",
+    "    let 变量 = 函数(参数, ๑๒๓)\n",
+    "    return ผลลัพธ์ + รายการ.ขนาด() * ไ้\n",
+    "}\n",
+};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static uint32_t generate_input(char *buffer, const char **lines, uint32_t num_lines) {
+    uint32_t length = 0;
+    for (uint32_t i = 0; true; i = (i + 1) % num_lines) {
+        uint32_t line_length = strlen(lines[i]);
+        if (length + line_length > INPUT_SIZE) {
+            return length;
+        }
+        memcpy(buffer + length, lines[i], line_length);
+        length += line_length;
+    }
+}
+
+static uint8_t classify_icu(UChar32 codepoint) {
+    uint8_t class = 0;
+    if (u_isalpha(codepoint)) {
+        class |= CLASS_ALPHA;
+    }
+    if (u_isdigit(codepoint)) {
+        class |= CLASS_DIGIT;
+    }
+    if (u_isupper(codepoint)) {
+        class |= CLASS_UPPER;
+    }
+    if (u_isalnum(codepoint)) {
+        class |= CLASS_NAME;
+    }
+    return class;
+}
+
+static uint8_t classify_table(UChar32 codepoint) {
+    uint32_t index = (uint32_t)codepoint;
+    return unicode_class_blocks[(unicode_class_index[index >> UNICODE_CLASSES_SHIFT] << UNICODE_CLASSES_SHIFT) | (index & UNICODE_CLASSES_MASK)];
+}
+
+static void run_classify(const char *name, uint8_t (*classify)(UChar32 codepoint), const UChar32 *codepoints, uint32_t num_codepoints) {
+    uint32_t checksum = 0;
+    double best = 1e9;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        double start = now_seconds();
+        for (uint32_t i = 0; i < num_codepoints; i++) {
+            checksum += classify(codepoints[i]);
+        }
+        double elapsed = now_seconds() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    printf("%-8s %8.1f Mcodepoints/s (checksum %" PRIu32 ")\n", name, (double)num_codepoints / best / 1e6, checksum);
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+
+    char *input = malloc(INPUT_SIZE);
+    uint32_t length = generate_input(input, mixed_lines, sizeof(mixed_lines) / sizeof(mixed_lines[0]));
+
+    // only the non-ascii codepoints go through the table. ascii has its own in the lexer
+    UChar32 *codepoints = malloc(length * sizeof(UChar32));
+    uint32_t num_codepoints = 0;
+    for (int32_t offset = 0; offset < (int32_t)length;) {
+        UChar32 codepoint;
+        U8_NEXT_OR_FFFD(input, offset, (int32_t)length, codepoint);
+        if (codepoint >= 0x80) {
+            codepoints[num_codepoints] = codepoint;
+            num_codepoints++;
+        }
+    }
+    printf("mixed script, %" PRIu32 " bytes, %" PRIu32 " non-ascii codepoints, %d byte table\n", length, num_codepoints, UNICODE_CLASSES_SIZE);
+
+    run_classify("icu", classify_icu, codepoints, num_codepoints);
+    run_classify("table", classify_table, codepoints, num_codepoints);
+
+    double start = now_seconds();
+    ecs_defer_begin(world);
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+    ecs_defer_end(world);
+    double elapsed = now_seconds() - start;
+    printf("%-8s %8.1f MB/s %8.1f Mtokens/s\n", "tokenize", (double)length / (1024.0 * 1024.0) / elapsed, (double)tokens.size / elapsed / 1e6);
+
+    free(codepoints);
+    free(input);
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
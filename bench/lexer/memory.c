@@ -0,0 +1,161 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/string.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unicode/utext.h>
+
+#include "test_configs.h"
+
+// Measures the gc allocations made for token text while lexing the lexer
+// test corpora and compares them against allocating every token's text.
+
+#define TOKENS_PER_CONFIG 10000
+// tokens are generated with lengths between the config's min length and this
+#define MAX_TOKEN_LENGTH 32
+
+typedef struct {
+    const char *name;
+    cortecs_lexer_test_config_t *config;
+} named_config_t;
+
+typedef struct {
+    uint64_t tokens;
+    cortecs_gc_stats_t inline_text;
+    cortecs_gc_stats_t allocated_text;
+} measurement_t;
+
+static void add_stats(cortecs_gc_stats_t *total, cortecs_gc_stats_t before, cortecs_gc_stats_t after) {
+    total->allocations += after.allocations - before.allocations;
+    total->allocated_bytes += after.allocated_bytes - before.allocated_bytes;
+}
+
+static uint32_t generate_token(cortecs_lexer_test_config_t config, char *out) {
+    uint32_t max_length = config.max_length < MAX_TOKEN_LENGTH ? config.max_length : MAX_TOKEN_LENGTH;
+    uint32_t length = config.min_length + rand() % (max_length - config.min_length + 1);
+
+    while (true) {
+        cortecs_lexer_test_state_t state = {
+            .state = 0,
+            .length = length,
+        };
+        for (uint32_t i = 0; i < length; i++) {
+            state.index = i;
+            cortecs_lexer_test_result_t result = config.next(state, rand());
+            state.state = result.next_state;
+            out[i] = result.next_char;
+        }
+        out[length] = 0;
+
+        if (!config.should_skip_token(out, length)) {
+            return length;
+        }
+    }
+}
+
+static measurement_t measure(cortecs_lexer_test_config_t config) {
+    measurement_t out = {0};
+    char token[MAX_TOKEN_LENGTH + 1];
+
+    ecs_defer_begin(world);
+    for (uint32_t i = 0; i < TOKENS_PER_CONFIG; i++) {
+        uint32_t length = generate_token(config, token);
+
+        UErrorCode status = U_ZERO_ERROR;
+        UText *text = utext_openUTF8(NULL, token, length, &status);
+
+        cortecs_gc_stats_t before = cortecs_gc_stats();
+        cortecs_lexer_token_t lexed = cortecs_lexer_next(text);
+        cortecs_gc_stats_t after = cortecs_gc_stats();
+        add_stats(&out.inline_text, before, after);
+        utext_close(text);
+
+        // what the token text costs when it's always gc allocated
+        before = cortecs_gc_stats();
+        cortecs_gc_alloc_array(CN(Cortecs, Char), CN(Cortecs, String, capacity)(lexed.text));
+        after = cortecs_gc_stats();
+        add_stats(&out.allocated_text, before, after);
+
+        out.tokens++;
+    }
+    ecs_defer_end(world);
+
+    return out;
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    srand(0);
+
+    named_config_t configs[] = {
+        {"space", &cortecs_lexer_test_space_config},
+        {"new_line", &cortecs_lexer_test_new_line_config},
+        {"name", &cortecs_lexer_test_name_config},
+        {"type", &cortecs_lexer_test_type_config},
+        {"int", &cortecs_lexer_test_int_config},
+        {"bad_int", &cortecs_lexer_test_bad_int_config},
+        {"float", &cortecs_lexer_test_float_config},
+        {"bad_float", &cortecs_lexer_test_bad_float_config},
+        {"operator", &cortecs_lexer_test_operator_config},
+        {"function", &cortecs_lexer_test_function_config},
+        {"let", &cortecs_lexer_test_let_config},
+        {"return", &cortecs_lexer_test_return_config},
+        {"if", &cortecs_lexer_test_if_config},
+        {"open_paren", &cortecs_lexer_test_open_paren_config},
+        {"close_paren", &cortecs_lexer_test_close_paren_config},
+        {"comma", &cortecs_lexer_test_comma_config},
+        {"semicolon", &cortecs_lexer_test_semicolon_config},
+        {"dot", &cortecs_lexer_test_dot_config},
+    };
+    uint32_t num_configs = sizeof(configs) / sizeof(named_config_t);
+
+    // the gc allocated string value was just the content pointer
+    uint64_t allocated_value_size = sizeof(CN(Cortecs, Array, CT(CN(Cortecs, Char))));
+    uint64_t inline_value_size = sizeof(CN(Cortecs, String));
+
+    printf("%-12s %8s %12s %12s %14s %14s\n", "config", "tokens", "allocs", "allocs(sso)", "bytes", "bytes(sso)");
+    measurement_t total = {0};
+    for (uint32_t i = 0; i < num_configs; i++) {
+        measurement_t result = measure(*configs[i].config);
+        uint64_t bytes = result.allocated_text.allocated_bytes + result.tokens * allocated_value_size;
+        uint64_t inline_bytes = result.inline_text.allocated_bytes + result.tokens * inline_value_size;
+        printf(
+            "%-12s %8" PRIu64 " %12" PRIu64 " %12" PRIu64 " %14" PRIu64 " %14" PRIu64 "\n",
+            configs[i].name,
+            result.tokens,
+            result.allocated_text.allocations,
+            result.inline_text.allocations,
+            bytes,
+            inline_bytes
+        );
+
+        total.tokens += result.tokens;
+        add_stats(&total.inline_text, (cortecs_gc_stats_t){0}, result.inline_text);
+        add_stats(&total.allocated_text, (cortecs_gc_stats_t){0}, result.allocated_text);
+    }
+
+    uint64_t bytes = total.allocated_text.allocated_bytes + total.tokens * allocated_value_size;
+    uint64_t inline_bytes = total.inline_text.allocated_bytes + total.tokens * inline_value_size;
+    printf(
+        "%-12s %8" PRIu64 " %12" PRIu64 " %12" PRIu64 " %14" PRIu64 " %14" PRIu64 "\n",
+        "total",
+        total.tokens,
+        total.allocated_text.allocations,
+        total.inline_text.allocations,
+        bytes,
+        inline_bytes
+    );
+    printf(
+        "allocations: %.1f%% fewer, bytes: %.1f%% fewer\n",
+        100.0 * (1.0 - (double)total.inline_text.allocations / (double)total.allocated_text.allocations),
+        100.0 * (1.0 - (double)inline_bytes / (double)bytes)
+    );
+
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
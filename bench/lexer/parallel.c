@@ -0,0 +1,78 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Tokenizes a large file on an increasing number of threads.
+
+#define INPUT_SIZE (64 * 1024 * 1024)
+#define REPEATS 3
+
+static const char *lines[] = {
+    "function fibonacci(n) {\n",
+    "    let previous = 0\n",
+    "    let current = 1u\n",
+    "    if (n < 2) { return n }\n",
+    "    let scale = 0.5d * Scale.factor(previous, current)\n",
+    "    return fibonacci(n - 1) + fibonacci(n - 2)\n",
+    "}\n",
+};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static void run_benchmark(const char *input, uint32_t length, uint32_t num_threads) {
+    double best = 1e9;
+    uint32_t size = 0;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        ecs_defer_begin(world);
+        double start = now_seconds();
+        cortecs_lexer_tokens_t tokens = num_threads == 1 ? cortecs_lexer_tokenize(input, length) : cortecs_lexer_tokenize_parallel(input, length, num_threads);
+        double elapsed = now_seconds() - start;
+        ecs_defer_end(world);
+        best = elapsed < best ? elapsed : best;
+        size = tokens.size;
+    }
+
+    char name[16];
+    snprintf(name, sizeof(name), num_threads == 0 ? "auto" : "%" PRIu32, num_threads);
+    printf("%-8s %8.1f MB/s %8.1f Mtokens/s\n", name, (double)length / (1024.0 * 1024.0) / best, (double)size / best / 1e6);
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+
+    char *input = malloc(INPUT_SIZE);
+    uint32_t length = 0;
+    for (uint32_t i = 0; true; i = (i + 1) % (sizeof(lines) / sizeof(lines[0]))) {
+        uint32_t line_length = strlen(lines[i]);
+        if (length + line_length > INPUT_SIZE) {
+            break;
+        }
+        memcpy(input + length, lines[i], line_length);
+        length += line_length;
+    }
+    printf("%" PRIu32 " bytes, %ld cpus\n", length, sysconf(_SC_NPROCESSORS_ONLN));
+
+    static const uint32_t num_threads[] = {1, 2, 4, 8, 0};
+    for (size_t i = 0; i < sizeof(num_threads) / sizeof(num_threads[0]); i++) {
+        run_benchmark(input, length, num_threads[i]);
+    }
+
+    free(input);
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/lines.h>
+#include <cortecs/span.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Times finding the line and column of random tokens in a 100k line file by
+// adding up the spans before them against a binary search over the line starts.
+
+#define NUM_LINES 100000
+#define NUM_LINEAR_QUERIES 100
+#define NUM_QUERIES 1000000
+
+static const char *lines[] = {
+    "function fibonacci(n) {\n",
+    "    let previous = 0\n",
+    "    let current = 1u\n",
+    "    if (n < 2) { return n }\n",
+    "    let ผลลัพธ์ = 0.5d * Scale.factor(previous, current)\n",
+    "    return fibonacci(n - 1) + fibonacci(n - 2)\n",
+    "}\n",
+};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+
+    const uint32_t num_lines = sizeof(lines) / sizeof(lines[0]);
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        length += strlen(lines[i % num_lines]);
+    }
+    char *input = malloc(length);
+    length = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        uint32_t line_length = strlen(lines[i % num_lines]);
+        memcpy(input + length, lines[i % num_lines], line_length);
+        length += line_length;
+    }
+
+    ecs_defer_begin(world);
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+    printf("%d lines, %" PRIu32 " bytes, %" PRIu32 " tokens\n", NUM_LINES, length, tokens.size);
+
+    srand(0);
+    uint64_t checksum = 0;
+    double start = now_seconds();
+    for (int i = 0; i < NUM_LINEAR_QUERIES; i++) {
+        uint32_t index = rand() % tokens.size;
+        cortecs_span_t position = {.lines = 0, .columns = 0};
+        for (uint32_t j = 0; j < index; j++) {
+            position = cortecs_span_add(position, cortecs_lexer_tokens_get(tokens, j).span);
+        }
+        checksum += position.lines + position.columns;
+    }
+    printf("%-10s %12.1f ns/query (checksum %" PRIu64 ")\n", "spans", (now_seconds() - start) / NUM_LINEAR_QUERIES * 1e9, checksum);
+
+    start = now_seconds();
+    cortecs_lexer_lines_t index = cortecs_lexer_lines_of(input, length);
+    printf("%-10s %12.1f us\n", "lines_of", (now_seconds() - start) * 1e6);
+    start = now_seconds();
+    index = cortecs_lexer_tokens_lines(tokens);
+    printf("%-10s %12.1f us\n", "from tokens", (now_seconds() - start) * 1e6);
+
+    srand(0);
+    checksum = 0;
+    start = now_seconds();
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        uint32_t offset = tokens.offsets->elements[rand() % tokens.size];
+        cortecs_span_t position = cortecs_lexer_lines_position(index, input, length, offset);
+        checksum += position.lines + position.columns;
+    }
+    printf("%-10s %12.1f ns/query\n", "position", (now_seconds() - start) / NUM_QUERIES * 1e9);
+
+    start = now_seconds();
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        cortecs_span_t position = {.lines = rand() % NUM_LINES, .columns = rand() % 40};
+        checksum += cortecs_lexer_lines_offset(index, input, length, position);
+    }
+    printf("%-10s %12.1f ns/query (checksum %" PRIu64 ")\n", "offset", (now_seconds() - start) / NUM_QUERIES * 1e9, checksum);
+    ecs_defer_end(world);
+
+    free(input);
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Times relexing single character edits in a 100k line file against tokenizing the whole file.
+
+#define NUM_LINES 100000
+#define NUM_EDITS 1000
+
+static const char *lines[] = {
+    "function fibonacci(n) {\n",
+    "    let previous = 0\n",
+    "    let current = 1u\n",
+    "    if (n < 2) { return n }\n",
+    "    let scale = 0.5d * Scale.factor(previous, current)\n",
+    "    return fibonacci(n - 1) + fibonacci(n - 2)\n",
+    "}\n",
+};
+
+// what an editor types or deletes
+static const char edits[] = {'a', 'Z', '1', '.', ' ', '\n', '(', '+', 'd'};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static void keep_tokens(cortecs_lexer_tokens_t tokens) {
+    cortecs_gc_inc(tokens.tags);
+    cortecs_gc_inc(tokens.offsets);
+    cortecs_gc_inc(tokens.lengths);
+    cortecs_gc_inc(tokens.lines);
+    cortecs_gc_inc(tokens.columns);
+}
+
+static void release_tokens(cortecs_lexer_tokens_t tokens) {
+    cortecs_gc_dec(tokens.tags);
+    cortecs_gc_dec(tokens.offsets);
+    cortecs_gc_dec(tokens.lengths);
+    cortecs_gc_dec(tokens.lines);
+    cortecs_gc_dec(tokens.columns);
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+
+    const uint32_t num_lines = sizeof(lines) / sizeof(lines[0]);
+    uint32_t capacity = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        capacity += strlen(lines[i % num_lines]);
+    }
+    capacity += NUM_EDITS;
+    char *input = malloc(capacity);
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        uint32_t line_length = strlen(lines[i % num_lines]);
+        memcpy(input + length, lines[i % num_lines], line_length);
+        length += line_length;
+    }
+
+    ecs_defer_begin(world);
+    double start = now_seconds();
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+    double tokenize_elapsed = now_seconds() - start;
+    keep_tokens(tokens);
+    ecs_defer_end(world);
+    printf("%d lines, %" PRIu32 " bytes, %" PRIu32 " tokens\n", NUM_LINES, length, tokens.size);
+    printf("%-10s %10.1f us\n", "tokenize", tokenize_elapsed * 1e6);
+
+    srand(0);
+    double relex_total = 0;
+    double relex_max = 0;
+    double apply_total = 0;
+    uint64_t relexed = 0;
+    for (int i = 0; i < NUM_EDITS; i++) {
+        // half inserts and half deletes of one byte
+        cortecs_lexer_edit_t edit = {.offset = rand() % length, .removed = 0, .inserted = 0};
+        if (i % 2 == 0) {
+            edit.inserted = 1;
+            memmove(input + edit.offset + 1, input + edit.offset, length - edit.offset);
+            input[edit.offset] = edits[rand() % sizeof(edits)];
+            length++;
+        } else {
+            edit.removed = 1;
+            memmove(input + edit.offset, input + edit.offset + 1, length - edit.offset - 1);
+            length--;
+        }
+
+        ecs_defer_begin(world);
+        start = now_seconds();
+        cortecs_lexer_relex_t relex = cortecs_lexer_relex(tokens, input, length, edit);
+        double elapsed = now_seconds() - start;
+        relex_total += elapsed;
+        relex_max = elapsed > relex_max ? elapsed : relex_max;
+        relexed += relex.inserted.size;
+
+        start = now_seconds();
+        cortecs_lexer_tokens_t applied = cortecs_lexer_tokens_apply(tokens, relex, edit);
+        apply_total += now_seconds() - start;
+
+        keep_tokens(applied);
+        release_tokens(tokens);
+        tokens = applied;
+        ecs_defer_end(world);
+    }
+
+    printf("%-10s %10.2f us mean %8.2f us max %6.1f tokens relexed per edit\n", "relex", relex_total / NUM_EDITS * 1e6, relex_max * 1e6, (double)relexed / NUM_EDITS);
+    printf("%-10s %10.1f us mean\n", "apply", apply_total / NUM_EDITS * 1e6);
+
+    ecs_defer_begin(world);
+    release_tokens(tokens);
+    ecs_defer_end(world);
+    free(input);
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include <cortecs/gc.h>
+#include <cortecs/kernel.h>
+#include <cortecs/span.h>
+#include <cortecs/string.h>
+#include <cortecs/world.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Measures cortecs_span_of over whole files with every string kernel
+// implementation and the byte at a time loop it replaced.
+
+#define INPUT_SIZE (16 * 1024 * 1024)
+#define RUNS 16
+
+static const CN(Cortecs, Kernel, Isa) isas[] = {
+    CORTECS_KERNEL_ISA_SCALAR,
+    CORTECS_KERNEL_ISA_SSE2,
+    CORTECS_KERNEL_ISA_AVX2,
+};
+#define NUM_ISAS (sizeof(isas) / sizeof(isas[0]))
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+// lines of 0 to 80 codepoints. thai_ratio is the percent of 3 byte thai codepoints
+static CN(Cortecs, String) generate_input(int thai_ratio) {
+    char *buffer = malloc(INPUT_SIZE);
+    uint32_t i = 0;
+    while (i + 4 <= INPUT_SIZE) {
+        int line_length = rand() % 81;
+        for (int j = 0; j < line_length && i + 4 <= INPUT_SIZE; j++) {
+            if (rand() % 100 < thai_ratio) {
+                // U+0E01 to U+0E2E
+                buffer[i++] = (char)0xE0;
+                buffer[i++] = (char)0xB8;
+                buffer[i++] = (char)(0x81 + rand() % 0x2E);
+            } else {
+                buffer[i++] = (char)('a' + rand() % 26);
+            }
+        }
+        buffer[i++] = '\n';
+    }
+
+    CN(Cortecs, String) input = CN(Cortecs, String, from_bytes)(buffer, i);
+    cortecs_gc_inc(input.content);
+    free(buffer);
+    return input;
+}
+
+// the byte at a time loop cortecs_span_of used before the string kernels
+static cortecs_span_t span_of_bytes(const char *bytes, uint32_t length) {
+    cortecs_span_t out = {
+        .lines = 0,
+        .columns = 0,
+    };
+
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t current_char = bytes[i];
+        if (current_char == 0) {
+            break;
+        }
+
+        if (current_char == '\n') {
+            out.columns = 0;
+            out.lines++;
+            continue;
+        }
+
+        out.columns++;
+    }
+
+    return out;
+}
+
+static void report(const char *name, double elapsed, uint32_t size, cortecs_span_t span) {
+    double megabytes = (double)size * RUNS / (1024.0 * 1024.0);
+    printf("%-10s %10.1f MB/s (lines %" PRIu32 ", columns %" PRIu32 ")\n", name, megabytes / elapsed, span.lines, span.columns);
+}
+
+static void run_benchmark(int thai_ratio) {
+    srand(0);
+    CN(Cortecs, String) input = generate_input(thai_ratio);
+    const char *bytes = CN(Cortecs, String, cstr)(&input);
+    uint32_t size = CN(Cortecs, String, capacity)(input);
+    printf("\n%d%% thai, %" PRIu32 " bytes\n", thai_ratio, size);
+
+    cortecs_span_t span;
+    double start = now_seconds();
+    for (int run = 0; run < RUNS; run++) {
+        span = span_of_bytes(bytes, size);
+    }
+    report("bytewise", now_seconds() - start, size, span);
+
+    for (size_t isa = 0; isa < NUM_ISAS; isa++) {
+        if (!CN(Cortecs, Kernel, set_isa)(isas[isa])) {
+            continue;
+        }
+
+        start = now_seconds();
+        for (int run = 0; run < RUNS; run++) {
+            span = cortecs_span_of(input);
+        }
+        report(CN(Cortecs, Kernel, isa_name)(isas[isa]), now_seconds() - start, size, span);
+    }
+    CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, detect_isa)());
+
+    cortecs_gc_dec(input.content);
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+
+    ecs_defer_begin(world);
+    run_benchmark(0);
+    run_benchmark(50);
+    ecs_defer_end(world);
+
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/string.h>
+#include <cortecs/symbol.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unicode/utext.h>
+
+#include "test_configs.h"
+
+// Lexes corpora generated from the lexer test configs with every lexer entry point
+// and reports throughput and gc allocations per token. The corpora are built from a
+// fixed seed so runs are comparable.
+
+#define CORPUS_SIZE (8 * 1024 * 1024)
+// tokens are generated with lengths between the config's min length and this
+#define MAX_TOKEN_LENGTH 16
+// tokens are lexed in batches so the gc can collect between batches
+#define BATCH_SIZE 4096
+#define STREAM_CHUNK_SIZE (64 * 1024)
+
+typedef struct {
+    cortecs_lexer_test_config_t *config;
+    uint32_t weight;
+    // letters are replaced with non-ascii letters of the same case so the token keeps its tag
+    bool is_unicode;
+} weighted_config_t;
+
+typedef struct {
+    const char *name;
+    weighted_config_t *configs;
+    uint32_t num_configs;
+} corpus_t;
+
+#define CORPUS(NAME, CONFIGS) \
+    { .name = NAME, .configs = CONFIGS, .num_configs = sizeof(CONFIGS) / sizeof(weighted_config_t) }
+
+static weighted_config_t ascii_configs[] = {
+    {&cortecs_lexer_test_name_config, 20, false},
+    {&cortecs_lexer_test_type_config, 5, false},
+    {&cortecs_lexer_test_space_config, 25, false},
+    {&cortecs_lexer_test_new_line_config, 5, false},
+    {&cortecs_lexer_test_int_config, 5, false},
+    {&cortecs_lexer_test_float_config, 2, false},
+    {&cortecs_lexer_test_operator_config, 6, false},
+    {&cortecs_lexer_test_function_config, 1, false},
+    {&cortecs_lexer_test_let_config, 3, false},
+    {&cortecs_lexer_test_return_config, 1, false},
+    {&cortecs_lexer_test_if_config, 1, false},
+    {&cortecs_lexer_test_open_paren_config, 4, false},
+    {&cortecs_lexer_test_close_paren_config, 4, false},
+    {&cortecs_lexer_test_open_curly_config, 1, false},
+    {&cortecs_lexer_test_close_curly_config, 1, false},
+    {&cortecs_lexer_test_comma_config, 3, false},
+    {&cortecs_lexer_test_dot_config, 3, false},
+};
+
+static weighted_config_t unicode_configs[] = {
+    {&cortecs_lexer_test_name_config, 20, true},
+    {&cortecs_lexer_test_type_config, 5, true},
+    {&cortecs_lexer_test_space_config, 25, false},
+    {&cortecs_lexer_test_new_line_config, 5, false},
+    {&cortecs_lexer_test_int_config, 5, false},
+    {&cortecs_lexer_test_operator_config, 6, false},
+    {&cortecs_lexer_test_let_config, 3, false},
+    {&cortecs_lexer_test_open_paren_config, 4, false},
+    {&cortecs_lexer_test_close_paren_config, 4, false},
+    {&cortecs_lexer_test_comma_config, 3, false},
+    {&cortecs_lexer_test_dot_config, 3, false},
+};
+
+static weighted_config_t operator_configs[] = {
+    {&cortecs_lexer_test_operator_config, 40, false},
+    {&cortecs_lexer_test_name_config, 15, false},
+    {&cortecs_lexer_test_int_config, 10, false},
+    {&cortecs_lexer_test_float_config, 5, false},
+    {&cortecs_lexer_test_space_config, 15, false},
+    {&cortecs_lexer_test_open_paren_config, 5, false},
+    {&cortecs_lexer_test_close_paren_config, 5, false},
+};
+
+static weighted_config_t whitespace_configs[] = {
+    {&cortecs_lexer_test_space_config, 40, false},
+    {&cortecs_lexer_test_new_line_config, 30, false},
+    {&cortecs_lexer_test_name_config, 15, false},
+    {&cortecs_lexer_test_operator_config, 5, false},
+    {&cortecs_lexer_test_int_config, 5, false},
+    {&cortecs_lexer_test_semicolon_config, 5, false},
+};
+
+static corpus_t corpora[] = {
+    CORPUS("ascii", ascii_configs),
+    CORPUS("unicode", unicode_configs),
+    CORPUS("operator", operator_configs),
+    CORPUS("whitespace", whitespace_configs),
+};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static uint32_t generate_token(cortecs_lexer_test_config_t config, char *out) {
+    uint32_t max_length = config.max_length < MAX_TOKEN_LENGTH ? config.max_length : MAX_TOKEN_LENGTH;
+    uint32_t length = config.min_length + rand() % (max_length - config.min_length + 1);
+
+    while (true) {
+        cortecs_lexer_test_state_t state = {
+            .state = 0,
+            .length = length,
+        };
+        for (uint32_t i = 0; i < length; i++) {
+            state.index = i;
+            cortecs_lexer_test_result_t result = config.next(state, rand());
+            state.state = result.next_state;
+            out[i] = result.next_char;
+        }
+
+        if (!config.should_skip_token(out, length)) {
+            return length;
+        }
+    }
+}
+
+// lowercase letters become thai consonants U+0E01 to U+0E1A and uppercase letters
+// become greek capitals U+0391 to U+03A1 so names stay names and types stay types
+static uint32_t append_unicode(char *out, const char *token, uint32_t length) {
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        char c = token[i];
+        if (c >= 'a' && c <= 'z') {
+            out[size++] = (char)0xE0;
+            out[size++] = (char)0xB8;
+            out[size++] = (char)(0x81 + (c - 'a'));
+        } else if (c >= 'A' && c <= 'Z') {
+            out[size++] = (char)0xCE;
+            out[size++] = (char)(0x91 + (c - 'A') % 17);
+        } else {
+            out[size++] = c;
+        }
+    }
+    return size;
+}
+
+static uint32_t generate_corpus(corpus_t corpus, char *out) {
+    uint32_t total_weight = 0;
+    for (uint32_t i = 0; i < corpus.num_configs; i++) {
+        total_weight += corpus.configs[i].weight;
+    }
+
+    char token[MAX_TOKEN_LENGTH];
+    uint32_t length = 0;
+    while (true) {
+        uint32_t choice = rand() % total_weight;
+        uint32_t index = 0;
+        while (choice >= corpus.configs[index].weight) {
+            choice -= corpus.configs[index].weight;
+            index++;
+        }
+
+        // every byte of a token can become three
+        if (length + 3 * MAX_TOKEN_LENGTH > CORPUS_SIZE) {
+            return length;
+        }
+        uint32_t token_length = generate_token(*corpus.configs[index].config, token);
+        if (corpus.configs[index].is_unicode) {
+            length += append_unicode(out + length, token, token_length);
+        } else {
+            memcpy(out + length, token, token_length);
+            length += token_length;
+        }
+    }
+}
+
+static void report(const char *name, double elapsed, uint32_t length, uint64_t tokens, cortecs_gc_stats_t before, cortecs_gc_stats_t after) {
+    double megabytes = (double)length / (1024.0 * 1024.0);
+    double allocations = (double)(after.allocations - before.allocations) / (double)tokens;
+    double bytes = (double)(after.allocated_bytes - before.allocated_bytes) / (double)tokens;
+    printf("%-10s %8.1f MB/s %8.1f Mtokens/s %8.2f allocs/token %8.1f bytes/token\n", name, megabytes / elapsed, (double)tokens / elapsed / 1e6, allocations, bytes);
+}
+
+static void run_utext(const char *name, const char *input, uint32_t length, cortecs_lexer_config_t config) {
+    UErrorCode status = U_ZERO_ERROR;
+    UText *text = utext_openUTF8(NULL, input, length, &status);
+    uint64_t tokens = 0;
+    cortecs_gc_stats_t before = cortecs_gc_stats();
+    double start = now_seconds();
+    for (bool done = false; !done;) {
+        ecs_defer_begin(world);
+        for (uint32_t i = 0; i < BATCH_SIZE && !done; i++) {
+            done = cortecs_lexer_next_with_config(text, config).length == 0;
+            tokens += !done;
+        }
+        ecs_defer_end(world);
+    }
+    report(name, now_seconds() - start, length, tokens, before, cortecs_gc_stats());
+    utext_close(text);
+}
+
+static void run_utf8(const char *name, const char *input, uint32_t length, cortecs_lexer_config_t config) {
+    uint32_t offset = 0;
+    uint64_t tokens = 0;
+    cortecs_gc_stats_t before = cortecs_gc_stats();
+    double start = now_seconds();
+    for (bool done = false; !done;) {
+        ecs_defer_begin(world);
+        for (uint32_t i = 0; i < BATCH_SIZE && !done; i++) {
+            done = cortecs_lexer_next_utf8_with_config(input, length, &offset, config).length == 0;
+            tokens += !done;
+        }
+        ecs_defer_end(world);
+    }
+    report(name, now_seconds() - start, length, tokens, before, cortecs_gc_stats());
+}
+
+static void run_stream(const char *name, const char *input, uint32_t length, cortecs_lexer_config_t config) {
+    cortecs_lexer_stream_t stream;
+    cortecs_lexer_stream_init(&stream, config);
+    uint32_t pushed = 0;
+    bool is_finished = false;
+    uint64_t tokens = 0;
+    cortecs_gc_stats_t before = cortecs_gc_stats();
+    double start = now_seconds();
+    for (bool done = false; !done;) {
+        ecs_defer_begin(world);
+        for (uint32_t i = 0; i < BATCH_SIZE && !done; i++) {
+            cortecs_lexer_token_t token;
+            if (cortecs_lexer_stream_next(&stream, &token)) {
+                tokens++;
+            } else if (is_finished) {
+                done = true;
+            } else if (pushed == length) {
+                cortecs_lexer_stream_finish(&stream);
+                is_finished = true;
+            } else {
+                uint32_t chunk_length = length - pushed < STREAM_CHUNK_SIZE ? length - pushed : STREAM_CHUNK_SIZE;
+                cortecs_lexer_stream_push(&stream, input + pushed, chunk_length);
+                pushed += chunk_length;
+            }
+        }
+        ecs_defer_end(world);
+    }
+    report(name, now_seconds() - start, length, tokens, before, cortecs_gc_stats());
+    cortecs_lexer_stream_cleanup(&stream);
+}
+
+static void run_tokenize(const char *name, const char *input, uint32_t length, uint32_t num_threads) {
+    cortecs_gc_stats_t before = cortecs_gc_stats();
+    double start = now_seconds();
+    ecs_defer_begin(world);
+    cortecs_lexer_tokens_t tokens = num_threads == 1 ? cortecs_lexer_tokenize(input, length) : cortecs_lexer_tokenize_parallel(input, length, num_threads);
+    ecs_defer_end(world);
+    report(name, now_seconds() - start, length, tokens.size, before, cortecs_gc_stats());
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    CN(Cortecs, Symbol, init)();
+
+    cortecs_lexer_config_t eager = {.intern_names = false, .lazy_text = false};
+    cortecs_lexer_config_t interned = {.intern_names = true, .lazy_text = false};
+    cortecs_lexer_config_t lazy = {.intern_names = false, .lazy_text = true};
+
+    char *input = malloc(CORPUS_SIZE);
+    for (uint32_t i = 0; i < sizeof(corpora) / sizeof(corpora[0]); i++) {
+        srand(i);
+        uint32_t length = generate_corpus(corpora[i], input);
+        printf("\n%s, %" PRIu32 " bytes\n", corpora[i].name, length);
+
+        run_utext("utext", input, length, eager);
+        run_utf8("utf8", input, length, eager);
+        run_utf8("interned", input, length, interned);
+        run_utf8("lazy", input, length, lazy);
+        run_stream("stream", input, length, eager);
+        run_tokenize("tokenize", input, length, 1);
+        run_tokenize("parallel", input, length, 0);
+    }
+    free(input);
+
+    CN(Cortecs, Symbol, cleanup)();
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/string.h>
+#include <cortecs/symbol.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unicode/utext.h>
+
+// Compares lexing through a UText with lexing utf-8 bytes directly, with
+// streaming the bytes in chunks and with tokenizing the whole input into columns.
+
+#define INPUT_SIZE (16 * 1024 * 1024)
+// tokens are lexed in batches so the gc can collect between batches
+#define BATCH_SIZE 4096
+#define STREAM_CHUNK_SIZE (64 * 1024)
+
+static const char *ascii_lines[] = {
+    "function fibonacci(n) {\n",
+    "    let previous = 0\n",
+    "    let current = 1u\n",
+    "    if (n < 2) { return n }\n",
+    "    let scale = 0.5d * Scale.factor(previous, current)\n",
+    "    return fibonacci(n - 1) + fibonacci(n - 2)\n",
+    "}\n",
+};
+
+static const char *thai_lines[] = {
+    "function ผลรวม(รายการ) {\n",
+    "    let ผลลัพธ์ = 0\n",
+    "    return ผลลัพธ์ + รายการ.ขนาด()\n",
+    "}\n",
+};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static uint32_t generate_input(char *buffer, const char **lines, uint32_t num_lines) {
+    uint32_t length = 0;
+    for (uint32_t i = 0; true; i = (i + 1) % num_lines) {
+        uint32_t line_length = strlen(lines[i]);
+        if (length + line_length > INPUT_SIZE) {
+            return length;
+        }
+        memcpy(buffer + length, lines[i], line_length);
+        length += line_length;
+    }
+}
+
+static bool is_end(cortecs_lexer_token_t token) {
+    return CN(Cortecs, String, is_null)(token.text) && token.symbol.entry == NULL;
+}
+
+static void report(const char *name, double elapsed, uint32_t length, uint64_t tokens) {
+    double megabytes = (double)length / (1024.0 * 1024.0);
+    printf("%-8s %8.1f MB/s %8.1f Mtokens/s\n", name, megabytes / elapsed, (double)tokens / elapsed / 1e6);
+}
+
+static void run_benchmark(const char *name, const char **lines, uint32_t num_lines) {
+    char *input = malloc(INPUT_SIZE);
+    uint32_t length = generate_input(input, lines, num_lines);
+    cortecs_lexer_config_t config = {.intern_names = true};
+    printf("\n%s, %" PRIu32 " bytes\n", name, length);
+
+    UErrorCode status = U_ZERO_ERROR;
+    UText *text = utext_openUTF8(NULL, input, length, &status);
+    uint64_t tokens = 0;
+    double start = now_seconds();
+    for (bool done = false; !done;) {
+        ecs_defer_begin(world);
+        for (uint32_t i = 0; i < BATCH_SIZE && !done; i++) {
+            done = is_end(cortecs_lexer_next_with_config(text, config));
+            tokens += !done;
+        }
+        ecs_defer_end(world);
+    }
+    report("utext", now_seconds() - start, length, tokens);
+    utext_close(text);
+
+    uint32_t offset = 0;
+    tokens = 0;
+    start = now_seconds();
+    for (bool done = false; !done;) {
+        ecs_defer_begin(world);
+        for (uint32_t i = 0; i < BATCH_SIZE && !done; i++) {
+            done = is_end(cortecs_lexer_next_utf8_with_config(input, length, &offset, config));
+            tokens += !done;
+        }
+        ecs_defer_end(world);
+    }
+    report("utf8", now_seconds() - start, length, tokens);
+
+    // without interning or text this is the cost of the transition table
+    cortecs_lexer_config_t lazy = {.intern_names = false, .lazy_text = true};
+    offset = 0;
+    tokens = 0;
+    start = now_seconds();
+    while (cortecs_lexer_next_utf8_with_config(input, length, &offset, lazy).length > 0) {
+        tokens++;
+    }
+    report("lazy", now_seconds() - start, length, tokens);
+
+    // the input arrives in pipe sized chunks
+    cortecs_lexer_stream_t chunks;
+    cortecs_lexer_stream_init(&chunks, config);
+    uint32_t pushed = 0;
+    bool is_finished = false;
+    tokens = 0;
+    start = now_seconds();
+    for (bool done = false; !done;) {
+        ecs_defer_begin(world);
+        for (uint32_t i = 0; i < BATCH_SIZE && !done; i++) {
+            cortecs_lexer_token_t token;
+            if (cortecs_lexer_stream_next(&chunks, &token)) {
+                tokens++;
+            } else if (is_finished) {
+                done = true;
+            } else if (pushed == length) {
+                cortecs_lexer_stream_finish(&chunks);
+                is_finished = true;
+            } else {
+                uint32_t chunk_length = length - pushed < STREAM_CHUNK_SIZE ? length - pushed : STREAM_CHUNK_SIZE;
+                cortecs_lexer_stream_push(&chunks, input + pushed, chunk_length);
+                pushed += chunk_length;
+            }
+        }
+        ecs_defer_end(world);
+    }
+    report("stream", now_seconds() - start, length, tokens);
+    cortecs_lexer_stream_cleanup(&chunks);
+
+    // tokenize doesn't intern names or build text so this is also the cost of a lazy token
+    start = now_seconds();
+    ecs_defer_begin(world);
+    cortecs_lexer_tokens_t stream = cortecs_lexer_tokenize(input, length);
+    ecs_defer_end(world);
+    report("tokenize", now_seconds() - start, length, stream.size);
+
+    uint32_t significant = 0;
+    start = now_seconds();
+    for (uint32_t i = cortecs_lexer_tokens_skip_whitespace(stream, 0); i < stream.size; i = cortecs_lexer_tokens_skip_whitespace(stream, i + 1)) {
+        significant++;
+    }
+    double elapsed = now_seconds() - start;
+    printf("%-8s %8.1f Mtokens/s %" PRIu32 " of %" PRIu32 " tokens aren't whitespace\n", "skip", (double)stream.size / elapsed / 1e6, significant, stream.size);
+
+    free(input);
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    CN(Cortecs, Symbol, init)();
+
+    run_benchmark("ascii", ascii_lines, sizeof(ascii_lines) / sizeof(ascii_lines[0]));
+    run_benchmark("thai", thai_lines, sizeof(thai_lines) / sizeof(thai_lines[0]));
+
+    CN(Cortecs, Symbol, cleanup)();
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include <cortecs/ast_entities.h>
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/parser.h>
+#include <cortecs/span.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Spawns a 20k line file as entities and edits a function in the middle of it. Reports
+// how many spans each edit changes against the number of nodes and how long shifting
+// and resolving take against spawning the whole file again.
+
+#define NUM_LINES 20000
+#define REPEATS 5
+
+static const char *lines[] = {
+    "function fibonacci(n: I32, scale: F32): I32 {\n",
+    "    let previous = fibonacci(n - 1, scale)\n",
+    "    let current = fibonacci(n - 2, scale * 0.5)\n",
+    "    let total = previous * 2 + current / (n - 1) == -scale | n <= 1\n",
+    "    println(previous, current, Total)\n",
+    "    return previous + current\n",
+    "}\n",
+    "\n",
+};
+
+static const char *inserted = "function f() {\n    let inserted = previous * 2\n}\n";
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static double resolve(void) {
+    double best = 1e9;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        double start = now_seconds();
+        cortecs_ast_entities_resolve();
+        double elapsed = now_seconds() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+static void report_edit(const char *name, uint32_t num_shifted, uint32_t num_nodes, double shift, double resolve) {
+    printf("%-10s %8" PRIu32 " spans of %" PRIu32 " nodes %8.3f ms shift %8.2f ms resolve\n", name, num_shifted, num_nodes, shift * 1e3, resolve * 1e3);
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    cortecs_span_init();
+    cortecs_ast_entities_init();
+
+    const uint32_t num_lines = sizeof(lines) / sizeof(lines[0]);
+    uint32_t capacity = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        capacity += strlen(lines[i % num_lines]);
+    }
+    char *input = malloc(capacity);
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        uint32_t line_length = strlen(lines[i % num_lines]);
+        memcpy(input + length, lines[i % num_lines], line_length);
+        length += line_length;
+    }
+
+    ecs_defer_begin(world);
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+    cortecs_ast_t ast = cortecs_parser_parse(input, tokens);
+    uint32_t num_nodes = ast.size;
+    ecs_entity_t *entities = malloc(ast.size * sizeof(ecs_entity_t));
+
+    // the body of the function in the middle of the file and its first let
+    uint32_t function = cortecs_ast_child(ast, ast.root, ast.num_children->elements[ast.root] / 2);
+    uint32_t body = cortecs_ast_child(ast, function, ast.num_children->elements[function] - 1);
+    uint32_t let = cortecs_ast_child(ast, body, 0);
+
+    double start = now_seconds();
+    ecs_entity_t root = cortecs_ast_entities_spawn(ast, tokens, ast.root, 0, (cortecs_span_t){.lines = 0, .columns = 0}, entities);
+    ecs_defer_end(world);
+    double spawn = now_seconds() - start;
+    printf("%d lines, %" PRIu32 " nodes\n", NUM_LINES, num_nodes);
+    printf("%-10s %8.2f ms %8.2f ms resolve\n", "spawn", spawn * 1e3, resolve() * 1e3);
+
+    // renaming previous to previously moves the rest of its line
+    cortecs_span_t name_end = ecs_get(world, entities[let], cortecs_ast_position_t)->start;
+    name_end.columns += strlen("let previous");
+    start = now_seconds();
+    uint32_t num_shifted = cortecs_ast_entities_shift(entities[let], name_end, (cortecs_span_t){.lines = name_end.lines, .columns = name_end.columns + 2});
+    double shift = now_seconds() - start;
+    report_edit("rename", num_shifted, num_nodes, shift, resolve());
+
+    // a new line before the let moves everything after it down
+    cortecs_span_t body_start = ecs_get(world, entities[body], cortecs_ast_position_t)->start;
+    cortecs_span_t line_start = {
+        .lines = name_end.lines,
+        .columns = 0,
+    };
+    start = now_seconds();
+    num_shifted = cortecs_ast_entities_shift(entities[body], line_start, (cortecs_span_t){.lines = line_start.lines + 1, .columns = 0});
+    ecs_defer_begin(world);
+    cortecs_lexer_tokens_t inserted_tokens = cortecs_lexer_tokenize(inserted, strlen(inserted));
+    cortecs_ast_t inserted_ast = cortecs_parser_parse(inserted, inserted_tokens);
+    uint32_t inserted_function = cortecs_ast_child(inserted_ast, inserted_ast.root, 0);
+    uint32_t inserted_body = cortecs_ast_child(inserted_ast, inserted_function, 0);
+    // the let starts at its keyword
+    cortecs_span_t let_span = {
+        .lines = line_start.lines - body_start.lines,
+        .columns = strlen("    "),
+    };
+    cortecs_ast_entities_spawn(inserted_ast, inserted_tokens, cortecs_ast_child(inserted_ast, inserted_body, 0), entities[body], let_span, NULL);
+    ecs_defer_end(world);
+    shift = now_seconds() - start;
+    report_edit("insert", num_shifted, num_nodes, shift, resolve());
+
+    ecs_delete(world, root);
+    free(entities);
+    free(input);
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/parser.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Parses a 100k line file and reports nodes per second and the bytes the tree takes per node.
+
+#define NUM_LINES 100000
+#define REPEATS 5
+
+static const char *lines[] = {
+    "function fibonacci(n: I32, scale: F32): I32 {\n",
+    "    let previous = fibonacci(n - 1, scale)\n",
+    "    let current = fibonacci(n - 2, scale * 0.5)\n",
+    "    let total = previous * 2 + current / (n - 1) == -scale | n <= 1\n",
+    "    println(previous, current, Total)\n",
+    "    return previous + current\n",
+    "}\n",
+    "\n",
+};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+
+    const uint32_t num_lines = sizeof(lines) / sizeof(lines[0]);
+    uint32_t capacity = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        capacity += strlen(lines[i % num_lines]);
+    }
+    char *input = malloc(capacity);
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        uint32_t line_length = strlen(lines[i % num_lines]);
+        memcpy(input + length, lines[i % num_lines], line_length);
+        length += line_length;
+    }
+
+    ecs_defer_begin(world);
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+    cortecs_gc_inc(tokens.tags);
+    cortecs_gc_inc(tokens.offsets);
+    cortecs_gc_inc(tokens.lengths);
+    cortecs_gc_inc(tokens.lines);
+    cortecs_gc_inc(tokens.columns);
+    ecs_defer_end(world);
+    printf("%d lines, %" PRIu32 " bytes, %" PRIu32 " tokens\n", NUM_LINES, length, tokens.size);
+
+    double best = 1e9;
+    cortecs_ast_t ast;
+    cortecs_gc_stats_t before;
+    cortecs_gc_stats_t after;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        ecs_defer_begin(world);
+        before = cortecs_gc_stats();
+        double start = now_seconds();
+        ast = cortecs_parser_parse(input, tokens);
+        double elapsed = now_seconds() - start;
+        after = cortecs_gc_stats();
+        ecs_defer_end(world);
+        best = elapsed < best ? elapsed : best;
+    }
+
+    // the tag, token, token range and child range of every node and the node's entry in its parent's children
+    uint64_t column_bytes = (uint64_t)ast.size * (sizeof(uint8_t) + 5 * sizeof(uint32_t)) + (uint64_t)(ast.size - 1) * sizeof(uint32_t);
+    printf("%" PRIu32 " nodes, %" PRIu32 " errors\n", ast.size, ast.num_errors);
+    printf("%-10s %8.1f Mnodes/s %8.1f MB/s %8.2f ms\n", "parse", (double)ast.size / best / 1e6, (double)length / (1024.0 * 1024.0) / best, best * 1e3);
+    printf("%-10s %8.1f bytes/node %8.1f gc bytes/node %" PRIu64 " gc allocations\n", "tree", (double)column_bytes / ast.size, (double)(after.allocated_bytes - before.allocated_bytes) / ast.size, after.allocations - before.allocations);
+
+    ecs_defer_begin(world);
+    cortecs_gc_dec(tokens.tags);
+    cortecs_gc_dec(tokens.offsets);
+    cortecs_gc_dec(tokens.lengths);
+    cortecs_gc_dec(tokens.lines);
+    cortecs_gc_dec(tokens.columns);
+    ecs_defer_end(world);
+    free(input);
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/parser.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Edits a function in the middle of a 50k line file and reports how long relexing and
+// reparsing the edit take against parsing the whole file again, and how many nodes change.
+
+#define NUM_LINES 50000
+#define REPEATS 20
+
+static const char *lines[] = {
+    "function fibonacci(n: I32, scale: F32): I32 {\n",
+    "    let previous = fibonacci(n - 1, scale)\n",
+    "    let current = fibonacci(n - 2, scale * 0.5)\n",
+    "    let total = previous * 2 + current / (n - 1) == -scale | n <= 1\n",
+    "    println(previous, current, Total)\n",
+    "    return previous + current\n",
+    "}\n",
+    "\n",
+};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+typedef struct {
+    const char *name;
+    // what's inserted in place of the removed bytes after the start of the middle function's first let
+    uint32_t offset;
+    uint32_t removed;
+    const char *inserted;
+} edit_t;
+
+static const edit_t edits[] = {
+    // previous becomes previously
+    {"rename", sizeof("    let previous") - 1, 0, "ly"},
+    {"operator", sizeof("    let previous = fibonacci(n ") - 1, 1, "+"},
+    {"new line", 0, 0, "    let inserted = previous * 2\n"},
+    // the body is unclosed until the next function's }
+    {"unclose", sizeof("    let previous = fibonacci(n - 1, scale)\n    let current = fibonacci(n - 2, scale * 0.5)\n    let total = previous * 2 + current / (n - 1) == -scale | n <= 1\n    println(previous, current, Total)\n    return previous + current\n") - 1, 1, ""},
+};
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+
+    const uint32_t num_lines = sizeof(lines) / sizeof(lines[0]);
+    uint32_t capacity = 64;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        capacity += strlen(lines[i % num_lines]);
+    }
+    char *input = malloc(capacity);
+    char *edited = malloc(capacity);
+    uint32_t length = 0;
+    uint32_t middle = 0;
+    for (uint32_t i = 0; i < NUM_LINES; i++) {
+        if (i == NUM_LINES / 2 / num_lines * num_lines + 1) {
+            middle = length;
+        }
+        uint32_t line_length = strlen(lines[i % num_lines]);
+        memcpy(input + length, lines[i % num_lines], line_length);
+        length += line_length;
+    }
+
+    ecs_defer_begin(world);
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+    double start = now_seconds();
+    cortecs_ast_t ast = cortecs_parser_parse(input, tokens);
+    double parse = now_seconds() - start;
+    printf("%d lines, %" PRIu32 " tokens, %" PRIu32 " nodes\n", NUM_LINES, tokens.size, ast.size);
+    printf("%-10s %8.3f ms\n", "parse", parse * 1e3);
+
+    for (uint32_t i = 0; i < sizeof(edits) / sizeof(edits[0]); i++) {
+        cortecs_lexer_edit_t edit = {
+            .offset = middle + edits[i].offset,
+            .removed = edits[i].removed,
+            .inserted = strlen(edits[i].inserted),
+        };
+        memcpy(edited, input, edit.offset);
+        memcpy(edited + edit.offset, edits[i].inserted, edit.inserted);
+        memcpy(edited + edit.offset + edit.inserted, input + edit.offset + edit.removed, length - edit.offset - edit.removed);
+        uint32_t edited_length = length - edit.removed + edit.inserted;
+
+        double best = 1e9;
+        cortecs_parser_reparse_t reparse;
+        cortecs_lexer_relex_t relex;
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            start = now_seconds();
+            relex = cortecs_lexer_relex(tokens, edited, edited_length, edit);
+            reparse = cortecs_parser_reparse(ast, tokens, edited, relex, edit);
+            double elapsed = now_seconds() - start;
+            best = elapsed < best ? elapsed : best;
+        }
+        start = now_seconds();
+        cortecs_ast_t applied = cortecs_parser_apply(ast, relex, reparse);
+        double apply = now_seconds() - start;
+
+        printf("%-10s %8.3f ms reparse %8" PRIu32 " nodes %8" PRIu32 " changed %8.3f ms apply %8" PRIu32 " nodes\n", edits[i].name, best * 1e3, reparse.inserted.size, reparse.changed->size, apply * 1e3, applied.size);
+    }
+    ecs_defer_end(world);
+
+    free(input);
+    free(edited);
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
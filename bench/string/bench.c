@@ -0,0 +1,80 @@
+#include <cortecs/gc.h>
+#include <cortecs/string.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// strings are allocated in batches so the gc can collect between batches
+#define BATCH_SIZE 1024
+#define NUM_BATCHES 1024
+
+static const char *inputs[] = {
+    "x",
+    "let",
+    "identifier",
+    "0.5d",
+    "a_much_longer_identifier_name_that_still_fits_in_a_line",
+};
+#define NUM_INPUTS (sizeof(inputs) / sizeof(inputs[0]))
+
+typedef CN(Cortecs, String) (*constructor_t)(const char *input, uint32_t length);
+
+static CN(Cortecs, String) construct_new(const char *input, uint32_t length) {
+    (void)length;
+    return CN(Cortecs, String, new)("%s", input);
+}
+
+static CN(Cortecs, String) construct_from_cstr(const char *input, uint32_t length) {
+    (void)length;
+    return CN(Cortecs, String, from_cstr)(input);
+}
+
+static CN(Cortecs, String) construct_from_bytes(const char *input, uint32_t length) {
+    return CN(Cortecs, String, from_bytes)(input, length);
+}
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static void run_benchmark(const char *name, constructor_t constructor) {
+    uint32_t lengths[NUM_INPUTS];
+    for (uint32_t i = 0; i < NUM_INPUTS; i++) {
+        lengths[i] = strlen(inputs[i]);
+    }
+
+    uint64_t checksum = 0;
+    double start = now_seconds();
+    for (uint32_t batch = 0; batch < NUM_BATCHES; batch++) {
+        ecs_defer_begin(world);
+        for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+            uint32_t input = i % NUM_INPUTS;
+            CN(Cortecs, String) out = constructor(inputs[input], lengths[input]);
+            checksum += CN(Cortecs, String, capacity)(out);
+        }
+        ecs_defer_end(world);
+    }
+    double elapsed = now_seconds() - start;
+
+    uint64_t count = (uint64_t)BATCH_SIZE * NUM_BATCHES;
+    printf("%-12s %10.1f ns/string (checksum %" PRIu64 ")\n", name, elapsed * 1e9 / (double)count, checksum);
+}
+
+int main() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+
+    run_benchmark("new", construct_new);
+    run_benchmark("from_cstr", construct_from_cstr);
+    run_benchmark("from_bytes", construct_from_bytes);
+
+    cortecs_gc_cleanup();
+    cortecs_world_cleanup();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include <cortecs/kernel.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// every kernel processes this many bytes per measurement regardless of the input size
+#define BYTES_PER_RUN (UINT64_C(1) << 30)
+
+static const uint32_t sizes[] = {16, 256, 64 * 1024};
+#define NUM_SIZES (sizeof(sizes) / sizeof(sizes[0]))
+
+static const CN(Cortecs, Kernel, Isa) isas[] = {
+    CORTECS_KERNEL_ISA_SCALAR,
+    CORTECS_KERNEL_ISA_SSE2,
+    CORTECS_KERNEL_ISA_AVX2,
+};
+#define NUM_ISAS (sizeof(isas) / sizeof(isas[0]))
+
+typedef uint64_t (*kernel_t)(const char *left, const char *right, uint32_t length);
+
+static uint64_t run_equals(const char *left, const char *right, uint32_t length) {
+    return CN(Cortecs, Kernel, equals)(left, right, length);
+}
+
+static uint64_t run_hash(const char *left, const char *right, uint32_t length) {
+    (void)right;
+    return CN(Cortecs, Kernel, hash)(left, length, 0);
+}
+
+static uint64_t run_validate_utf8(const char *left, const char *right, uint32_t length) {
+    (void)right;
+    return CN(Cortecs, Kernel, validate_utf8)(left, length);
+}
+
+static uint64_t run_count_codepoints(const char *left, const char *right, uint32_t length) {
+    (void)right;
+    return CN(Cortecs, Kernel, count_codepoints)(left, length);
+}
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+// fills the buffer with valid utf-8. thai_ratio is the percent of 3 byte thai codepoints
+static void fill(char *buffer, uint32_t size, int thai_ratio) {
+    uint32_t i = 0;
+    while (i < size) {
+        if (i + 3 <= size && rand() % 100 < thai_ratio) {
+            // U+0E01 to U+0E2E
+            buffer[i++] = (char)0xE0;
+            buffer[i++] = (char)0xB8;
+            buffer[i++] = (char)(0x81 + rand() % 0x2E);
+        } else {
+            buffer[i++] = (char)('a' + rand() % 26);
+        }
+    }
+}
+
+static void run_benchmark(const char *name, kernel_t kernel, const char *left, const char *right, uint32_t size) {
+    uint64_t iterations = BYTES_PER_RUN / size;
+    for (size_t isa = 0; isa < NUM_ISAS; isa++) {
+        if (!CN(Cortecs, Kernel, set_isa)(isas[isa])) {
+            continue;
+        }
+
+        uint64_t checksum = 0;
+        double start = now_seconds();
+        for (uint64_t i = 0; i < iterations; i++) {
+            checksum += kernel(left, right, size);
+        }
+        double elapsed = now_seconds() - start;
+        printf("%-18s %-6s %8" PRIu32 " bytes %8.2f GB/s (checksum %" PRIu64 ")\n", name, CN(Cortecs, Kernel, isa_name)(isas[isa]), size, (double)(iterations * size) / elapsed / 1e9, checksum);
+    }
+}
+
+int main() {
+    printf("detected isa: %s\n", CN(Cortecs, Kernel, isa_name)(CN(Cortecs, Kernel, detect_isa)()));
+
+    for (int thai_ratio = 0; thai_ratio <= 50; thai_ratio += 50) {
+        printf("\n%d%% thai\n", thai_ratio);
+        for (size_t i = 0; i < NUM_SIZES; i++) {
+            srand(0);
+            char *left = malloc(sizes[i]);
+            char *right = malloc(sizes[i]);
+            fill(left, sizes[i], thai_ratio);
+            memcpy(right, left, sizes[i]);
+
+            run_benchmark("equals", run_equals, left, right, sizes[i]);
+            run_benchmark("hash", run_hash, left, right, sizes[i]);
+            run_benchmark("validate_utf8", run_validate_utf8, left, right, sizes[i]);
+            run_benchmark("count_codepoints", run_count_codepoints, left, right, sizes[i]);
+
+            free(left);
+            free(right);
+        }
+    }
+    return 0;
+}
\ No newline at end of file
@@ -74,10 +74,7 @@ static void log_source_location(
 ) {
     cJSON_AddStringToObject(message, "file", file);
     cJSON_AddStringToObject(message, "function", function);
-
-    char buffer[sizeof("2,147,483,647")];
-    snprintf(buffer, sizeof(buffer), "%" PRId32, line);
-    cJSON_AddStringToObject(message, "line", buffer);
+    cJSON_AddNumberToObject(message, "line", line);
 }
 
 static void log_type_info(
@@ -99,22 +96,16 @@ static void log_allocation_info(
     snprintf(buffer, sizeof(buffer), "0x%" PRIxPTR, (uintptr_t)allocation);
     cJSON_AddStringToObject(message, "pointer", buffer);
 
-    // only 32 bits. won't overflow buffer
-    snprintf(buffer, sizeof(buffer), "%" PRIu32, (uint32_t)(entity & ECS_ENTITY_MASK));
-    cJSON_AddStringToObject(message, "entity_id", buffer);
-
-    // only 16 bits. won't overflow buffer
-    snprintf(buffer, sizeof(buffer), "%" PRIu16, (uint16_t)ECS_GENERATION(entity));
-    cJSON_AddStringToObject(message, "entity_generation", buffer);
+    cJSON_AddNumberToObject(message, "entity_id", (uint32_t)(entity & ECS_ENTITY_MASK));
+    cJSON_AddNumberToObject(message, "entity_generation", (uint16_t)ECS_GENERATION(entity));
 }
 
 static void log_event_id(
     cJSON *message,
     uint64_t event_id
 ) {
-    char buffer[sizeof("18,446,744,073,709,551,615")];
-    snprintf(buffer, sizeof(buffer), "%" PRIu64, event_id);
-    cJSON_AddStringToObject(message, "event_id", buffer);
+    // event ids stay well below 2^53 so they're exactly representable as a json number
+    cJSON_AddNumberToObject(message, "event_id", (double)event_id);
 }
 
 static void log_dec(
@@ -345,6 +336,8 @@ static int get_size_class(uint32_t size_of_allocation) {
     return CORTECS_GC_NUM_SIZES;
 }
 
+static cortecs_gc_stats_t stats;
+
 static void *alloc(
     uint32_t size_of_allocation,
     cortecs_finalizer_index finalizer_index,
@@ -363,9 +356,12 @@ static void *alloc(
         gc_buffer_ptr *buffer = ecs_emplace_id(world, entity, gc_buffers[CORTECS_GC_NUM_SIZES], NULL);
         allocation = malloc(sizeof(gc_header) + size_of_allocation);
         buffer->ptr = allocation;
+        stats.allocated_bytes += sizeof(gc_header) + size_of_allocation;
     } else {
         allocation = ecs_emplace_id(world, entity, gc_buffers[size_class], NULL);
+        stats.allocated_bytes += sizeof(gc_header) + buffer_sizes[size_class];
     }
+    stats.allocations++;
 
     gc_header *header = allocation;
     header->entity = entity;
@@ -445,6 +441,8 @@ void cortecs_gc_init_impl(
     // log_path needs to be const char * because it's impossible
     // to construct a cortecs_string before GC is initialized
     const char *log_path,
+    // optional. when NULL the log is never rotated
+    const struct CN(Cortecs, Log, Config) *log_config,
     const char *file,
     const char *function,
     int line
@@ -493,6 +491,11 @@ void cortecs_gc_init_impl(
     };
     ecs_observer_init(world, &dec_desc);
 
+    stats = (cortecs_gc_stats_t){
+        .allocations = 0,
+        .allocated_bytes = 0,
+    };
+
     // initialize log stream
     dec_event_id = 1;
     if (log_path != NULL) {
@@ -503,9 +506,13 @@ void cortecs_gc_init_impl(
         // these drop the alloc and dec messages created during memory allocation.
         // we spoof these messages after the init message for log completeness
         uint64_t string_event_id = dec_event_id;
-        CN(Cortecs, String) log_path_string = CN(Cortecs, String, new)("%s", log_path);
+        CN(Cortecs, String) log_path_string = CN(Cortecs, String, from_cstr)(log_path);
         uint64_t log_stream_event_id = dec_event_id;
-        log_stream = CN(Cortecs, Log, open)(log_path_string);
+        if (log_config != NULL) {
+            log_stream = CN(Cortecs, Log, open_with_config)(log_path_string, *log_config);
+        } else {
+            log_stream = CN(Cortecs, Log, open)(log_path_string);
+        }
 
         // log init message
         cJSON *message = create_log_message("cortecs_gc_init");
@@ -515,13 +522,16 @@ void cortecs_gc_init_impl(
         cJSON_Delete(message);
 
         // spoof log_path_string log messages
-        log_alloc(
-            "cortecs_gc_alloc",
-            file,
-            function,
-            line,
-            cortecs_finalizer_index_name(CN(Cortecs, Char)), false, log_path_string.content, get_entity(log_path_string.content), get_size_class(sizeof(CN(Cortecs, Char))));
-        log_dec(log_path_string.content, "enqueue_dec", file, function, line, string_event_id);
+        // short paths are stored inline and never allocated
+        if (!CN(Cortecs, String, is_inline)(log_path_string)) {
+            log_alloc(
+                "cortecs_gc_alloc",
+                file,
+                function,
+                line,
+                cortecs_finalizer_index_name(CN(Cortecs, Char)), false, log_path_string.content, get_entity(log_path_string.content), get_size_class(sizeof(CN(Cortecs, Char))));
+            log_dec(log_path_string.content, "enqueue_dec", file, function, line, string_event_id);
+        }
 
         // spoof log_stream log messages
         log_alloc(
@@ -569,6 +579,10 @@ void cortecs_gc_cleanup_impl(
     }
 }
 
+cortecs_gc_stats_t cortecs_gc_stats() {
+    return stats;
+}
+
 bool cortecs_gc_is_alive(void *allocation) {
     // TODO this api should be removed in favor of using logs
     gc_header header = *(gc_header *)allocation;
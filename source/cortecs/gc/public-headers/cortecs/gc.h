@@ -2,11 +2,18 @@
 #define CORTECS_GC_GC_H
 
 #include <cortecs/finalizer.h>
+#include <cortecs/mangle.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+// defined in cortecs/log.h. forward declared to keep the gc headers
+// independent of the log headers
+struct CN(Cortecs, Log, Config);
+
 void cortecs_gc_init_impl(
     const char *log_path,
+    const struct CN(Cortecs, Log, Config) *log_config,
     const char *file,
     const char *function,
     int line
@@ -14,10 +21,19 @@ void cortecs_gc_init_impl(
 #define cortecs_gc_init(LOG_PATH) \
     cortecs_gc_init_impl(         \
         LOG_PATH,                 \
+        NULL,                     \
         __FILE__,                 \
         __func__,                 \
         __LINE__                  \
     )
+#define cortecs_gc_init_with_log_config(LOG_PATH, LOG_CONFIG) \
+    cortecs_gc_init_impl(                                     \
+        LOG_PATH,                                             \
+        LOG_CONFIG,                                           \
+        __FILE__,                                             \
+        __func__,                                             \
+        __LINE__                                              \
+    )
 
 void cortecs_gc_cleanup_impl(
     const char *file,
@@ -97,4 +113,13 @@ void cortecs_gc_dec_impl(
 
 bool cortecs_gc_is_alive(void *allocation);
 
+// running totals since the gc was initialized
+typedef struct {
+    uint64_t allocations;
+    // includes the gc header and rounding up to the size class
+    uint64_t allocated_bytes;
+} cortecs_gc_stats_t;
+
+cortecs_gc_stats_t cortecs_gc_stats();
+
 #endif
\ No newline at end of file
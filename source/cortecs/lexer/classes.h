@@ -0,0 +1,15 @@
+#ifndef CORTECS_LEXER_CLASSES_H
+#define CORTECS_LEXER_CLASSES_H
+
+// the character classes the lexer dispatches on. shared by lexer.c and
+// unicode_classes_gen.c which generates the table for non-ascii codepoints
+#define CLASS_ALPHA (1 << 0)
+#define CLASS_DIGIT (1 << 1)
+#define CLASS_UPPER (1 << 2)
+#define CLASS_SPACE (1 << 3)
+#define CLASS_OPERATOR (1 << 4)
+// characters that start their own token or end the input
+#define CLASS_PUNCTUATION (1 << 5)
+#define CLASS_NAME (1 << 6)
+
+#endif
\ No newline at end of file
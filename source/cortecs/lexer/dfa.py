@@ -0,0 +1,267 @@
+# Generates dfa.h: the transition table the byte lexer runs.
+# Run by the dfa genrule in BUILD with the path of classes.h.
+#
+# Every token is a rule over sets of input symbols. The symbols are the ascii
+# bytes and the classes.h class of every non-ascii codepoint. The rules are
+# compiled to an NFA, then a DFA by subset construction, minimized, and symbols
+# with the same column in every state are merged into one equivalence class.
+# When several rules match the same text the earlier rule wins. Keywords are
+# names here and are picked out by the perfect hash from keywords.py.
+
+import re
+import sys
+
+ASCII_SIZE = 128
+# the classes.h class of a non-ascii codepoint is one byte
+NUM_SYMBOLS = ASCII_SIZE + 256
+
+classes = {}
+with open(sys.argv[1]) as header:
+    for name, bit in re.findall(r"#define (CLASS_\w+) \(1 << (\d+)\)", header.read()):
+        classes[name] = 1 << int(bit)
+
+
+def chars(text):
+    return frozenset(ord(c) for c in text)
+
+
+def unicode(predicate):
+    return frozenset(ASCII_SIZE + c for c in range(256) if predicate(c))
+
+
+def has(c, *names):
+    return all(c & classes[name] for name in names)
+
+
+LOWER = chars("abcdefghijklmnopqrstuvwxyz")
+UPPER = chars("ABCDEFGHIJKLMNOPQRSTUVWXYZ")
+DIGITS = chars("0123456789")
+PUNCTUATION = chars("(){}[]'\"`,:;.\n\0")
+SPACE = chars(" \t\r\f\v")
+OPERATOR = chars("!#$%&*+-/<=>?@\\^|~")
+
+ALPHA = LOWER | UPPER | unicode(lambda c: has(c, "CLASS_ALPHA"))
+TYPE_START = UPPER | unicode(lambda c: has(c, "CLASS_ALPHA", "CLASS_UPPER"))
+NAME_START = (ALPHA - TYPE_START) | chars("_")
+DIGIT = DIGITS | unicode(lambda c: has(c, "CLASS_DIGIT"))
+NAME = LOWER | UPPER | DIGITS | chars("_") | unicode(lambda c: has(c, "CLASS_NAME"))
+# ascii without a class and codepoints that aren't letters or digits
+INVALID = (frozenset(range(ASCII_SIZE)) - LOWER - UPPER - DIGITS - chars("_") - PUNCTUATION - SPACE - OPERATOR) | unicode(lambda c: not (c & (classes["CLASS_ALPHA"] | classes["CLASS_DIGIT"])))
+
+
+# regular expressions as tuples
+def one(symbols):
+    return ("set", symbols)
+
+
+def seq(*parts):
+    return ("seq", parts)
+
+
+def alt(*parts):
+    return ("alt", parts)
+
+
+def star(part):
+    return ("star", part)
+
+
+def plus(part):
+    return seq(part, star(part))
+
+
+def opt(part):
+    return alt(part, seq())
+
+
+FLOAT_PREFIX = alt(seq(plus(one(DIGIT)), one(chars(".")), star(one(DIGIT))), seq(one(chars(".")), plus(one(DIGIT))))
+
+RULES = [
+    ("CORTECS_LEXER_TAG_INT", seq(plus(one(DIGIT)), opt(seq(opt(one(chars("uU"))), one(chars("bBsSlL")))))),
+    ("CORTECS_LEXER_TAG_BAD_INT", seq(plus(one(DIGIT)), plus(one(NAME)))),
+    ("CORTECS_LEXER_TAG_FLOAT", seq(FLOAT_PREFIX, opt(one(chars("dD"))))),
+    ("CORTECS_LEXER_TAG_BAD_FLOAT", seq(FLOAT_PREFIX, plus(one(NAME)))),
+    ("CORTECS_LEXER_TAG_DOT", one(chars("."))),
+    ("CORTECS_LEXER_TAG_NEW_LINE", one(chars("\n"))),
+    ("CORTECS_LEXER_TAG_OPEN_PAREN", one(chars("("))),
+    ("CORTECS_LEXER_TAG_CLOSE_PAREN", one(chars(")"))),
+    ("CORTECS_LEXER_TAG_OPEN_CURLY", one(chars("{"))),
+    ("CORTECS_LEXER_TAG_CLOSE_CURLY", one(chars("}"))),
+    ("CORTECS_LEXER_TAG_OPEN_SQUARE", one(chars("["))),
+    ("CORTECS_LEXER_TAG_CLOSE_SQUARE", one(chars("]"))),
+    ("CORTECS_LEXER_TAG_SINGLE_QUOTE", one(chars("'"))),
+    ("CORTECS_LEXER_TAG_DOUBLE_QUOTE", one(chars("\""))),
+    ("CORTECS_LEXER_TAG_BACK_QUOTE", one(chars("`"))),
+    ("CORTECS_LEXER_TAG_COMMA", one(chars(","))),
+    ("CORTECS_LEXER_TAG_COLON", one(chars(":"))),
+    ("CORTECS_LEXER_TAG_SEMICOLON", one(chars(";"))),
+    ("CORTECS_LEXER_TAG_NAME", seq(one(NAME_START), star(one(NAME)))),
+    ("CORTECS_LEXER_TAG_TYPE", seq(one(TYPE_START), star(one(NAME)))),
+    ("CORTECS_LEXER_TAG_SPACE", plus(one(SPACE))),
+    ("CORTECS_LEXER_TAG_OPERATOR", plus(one(OPERATOR))),
+    # a nul is a token of its own but doesn't continue an invalid token
+    ("CORTECS_LEXER_TAG_INVALID", seq(one(INVALID | chars("\0")), star(one(INVALID)))),
+]
+
+
+class Nfa:
+    def __init__(self):
+        # per state: a list of (symbols, state) and a list of epsilon states
+        self.edges = []
+        self.epsilons = []
+        # the index of the rule a state accepts
+        self.accepts = {}
+
+    def state(self):
+        self.edges.append([])
+        self.epsilons.append([])
+        return len(self.edges) - 1
+
+    # builds the fragment for the expression between start and end
+    def build(self, expression, start, end):
+        kind, value = expression
+        if kind == "set":
+            self.edges[start].append((value, end))
+        elif kind == "seq":
+            current = start
+            for part in value:
+                after = self.state()
+                self.build(part, current, after)
+                current = after
+            self.epsilons[current].append(end)
+        elif kind == "alt":
+            for part in value:
+                self.build(part, start, end)
+        elif kind == "star":
+            loop = self.state()
+            self.epsilons[start].append(loop)
+            self.epsilons[loop].append(end)
+            self.build(value, loop, loop)
+
+    def closure(self, states):
+        stack = list(states)
+        result = set(states)
+        while stack:
+            for state in self.epsilons[stack.pop()]:
+                if state not in result:
+                    result.add(state)
+                    stack.append(state)
+        return frozenset(result)
+
+
+def build_nfa():
+    nfa = Nfa()
+    start = nfa.state()
+    for rule, (_, expression) in enumerate(RULES):
+        end = nfa.state()
+        nfa.accepts[end] = rule
+        nfa.build(expression, start, end)
+    return nfa, start
+
+
+# returns the transitions and the accepted rule of every state. state 0 is the dead state
+def build_dfa(nfa, nfa_start):
+    dead = frozenset()
+    start = nfa.closure([nfa_start])
+    ids = {dead: 0, start: 1}
+    sets = [dead, start]
+    transitions = []
+    index = 0
+    while index < len(sets):
+        current = sets[index]
+        row = []
+        for symbol in range(NUM_SYMBOLS):
+            targets = [target for state in current for symbols, target in nfa.edges[state] if symbol in symbols]
+            target = nfa.closure(targets) if targets else dead
+            if target not in ids:
+                ids[target] = len(sets)
+                sets.append(target)
+            row.append(ids[target])
+        transitions.append(row)
+        index += 1
+
+    accepts = [min((nfa.accepts[state] for state in states if state in nfa.accepts), default=None) for states in sets]
+    return transitions, accepts
+
+
+# merges states that accept the same rule and move to the same states. the dead and start states keep their numbers
+def minimize(transitions, accepts):
+    partition = [("dead" if state == 0 else "start" if state == 1 else accepts[state]) for state in range(len(transitions))]
+    while True:
+        signatures = [(partition[state], tuple(partition[target] for target in transitions[state])) for state in range(len(transitions))]
+        numbers = {}
+        for signature in [signatures[0], signatures[1]] + signatures:
+            numbers.setdefault(signature, len(numbers))
+        refined = [numbers[signature] for signature in signatures]
+        if len(set(refined)) == len(set(partition)):
+            break
+        partition = refined
+
+    num_states = len(set(partition))
+    minimized = [None] * num_states
+    minimized_accepts = [None] * num_states
+    for state in range(len(transitions)):
+        minimized[partition[state]] = [partition[target] for target in transitions[state]]
+        minimized_accepts[partition[state]] = accepts[state]
+    return minimized, minimized_accepts
+
+
+def equivalence_classes(transitions):
+    columns = {}
+    symbol_classes = []
+    for symbol in range(NUM_SYMBOLS):
+        column = tuple(row[symbol] for row in transitions)
+        symbol_classes.append(columns.setdefault(column, len(columns)))
+    return symbol_classes, list(columns)
+
+
+nfa, nfa_start = build_nfa()
+transitions, accepts = minimize(*build_dfa(nfa, nfa_start))
+symbol_classes, columns = equivalence_classes(transitions)
+
+if len(transitions) > 256 or len(columns) > 256:
+    raise Exception("the table doesn't fit in uint8_t")
+if 0 in transitions[1]:
+    raise Exception("every symbol has to start a token")
+# the lexer stops at the first symbol without a transition and never backs up
+for state in range(2, len(transitions)):
+    if accepts[state] is None:
+        raise Exception("every state after the start has to accept a token")
+
+print("// generated by source/cortecs/lexer/dfa.py. do not edit")
+print("#ifndef CORTECS_LEXER_DFA_H")
+print("#define CORTECS_LEXER_DFA_H")
+print()
+print("#include <cortecs/tokens.h>")
+print("#include <stdint.h>")
+print()
+print("#define DFA_NUM_STATES {}".format(len(transitions)))
+print("#define DFA_NUM_CLASSES {}".format(len(columns)))
+print("// no transition. the token ends before the symbol")
+print("#define DFA_STOP 0")
+print("#define DFA_START 1")
+print()
+print("// the equivalence class of an ascii byte")
+print("static const uint8_t dfa_ascii_classes[{}] = {{".format(ASCII_SIZE))
+for start in range(0, ASCII_SIZE, 32):
+    print("    " + " ".join("{},".format(symbol_classes[symbol]) for symbol in range(start, start + 32)))
+print("};")
+print()
+print("// the equivalence class of a non-ascii codepoint by its classes.h class")
+print("static const uint8_t dfa_unicode_classes[256] = {")
+for start in range(ASCII_SIZE, NUM_SYMBOLS, 32):
+    print("    " + " ".join("{},".format(symbol_classes[symbol]) for symbol in range(start, start + 32)))
+print("};")
+print()
+print("static const uint8_t dfa_transitions[DFA_NUM_STATES][DFA_NUM_CLASSES] = {")
+for row in transitions:
+    print("    {" + ", ".join(str(row[symbol_classes.index(c)]) for c in range(len(columns))) + "},")
+print("};")
+print()
+print("// the tag of the token that ends in each state")
+print("static const uint8_t dfa_tags[DFA_NUM_STATES] = {")
+for state, rule in enumerate(accepts):
+    print("    {},".format(RULES[rule][0] if rule is not None else "CORTECS_LEXER_TAG_INVALID"))
+print("};")
+print()
+print("#endif")
@@ -0,0 +1,74 @@
+# Generates keywords.h: a perfect hash over the keywords of the language.
+# Run by the keywords genrule in BUILD. Adding a keyword is adding a line to KEYWORDS
+# and its tag to cortecs_lexer_tag_t.
+#
+# The hash only reads the first byte, the last byte and the length so a name
+# is classified in constant time. The generator searches for multipliers that
+# give every keyword its own slot in the smallest power of two table.
+
+KEYWORDS = [
+    ("if", "CORTECS_LEXER_TAG_IF"),
+    ("let", "CORTECS_LEXER_TAG_LET"),
+    ("return", "CORTECS_LEXER_TAG_RETURN"),
+    ("function", "CORTECS_LEXER_TAG_FUNCTION"),
+]
+
+MAX_MULTIPLIER = 256
+
+
+def keyword_hash(keyword, first, last, size):
+    return (ord(keyword[0]) * first + ord(keyword[-1]) * last + len(keyword)) & (size - 1)
+
+
+def search():
+    size = 1
+    while size < len(KEYWORDS):
+        size *= 2
+
+    while True:
+        for first in range(1, MAX_MULTIPLIER):
+            for last in range(1, MAX_MULTIPLIER):
+                slots = {keyword_hash(keyword, first, last, size) for keyword, _ in KEYWORDS}
+                if len(slots) == len(KEYWORDS):
+                    return size, first, last
+        size *= 2
+
+
+for keyword, _ in KEYWORDS:
+    if not keyword.isascii() or not keyword.islower():
+        raise Exception("keywords must be lowercase ascii: " + keyword)
+
+size, first, last = search()
+table = [None] * size
+for keyword, tag in KEYWORDS:
+    table[keyword_hash(keyword, first, last, size)] = (keyword, tag)
+
+print("// generated by source/cortecs/lexer/keywords.py. do not edit")
+print("#ifndef CORTECS_LEXER_KEYWORDS_H")
+print("#define CORTECS_LEXER_KEYWORDS_H")
+print()
+print("#include <cortecs/tokens.h>")
+print("#include <stdint.h>")
+print()
+print("#define KEYWORD_MAX_LENGTH {}".format(max(len(keyword) for keyword, _ in KEYWORDS)))
+print("#define KEYWORD_TABLE_SIZE {}".format(size))
+print("#define KEYWORD_HASH(FIRST, LAST, LENGTH) \\")
+print("    (((uint32_t)(uint8_t)(FIRST) * {} + (uint32_t)(uint8_t)(LAST) * {} + (uint32_t)(LENGTH)) & (KEYWORD_TABLE_SIZE - 1))".format(first, last))
+print()
+print("typedef struct {")
+print("    const char *keyword;")
+print("    // empty slots have a length of 0 so they never match a name")
+print("    uint32_t length;")
+print("    cortecs_lexer_tag_t tag;")
+print("} keyword_entry_t;")
+print()
+print("static const keyword_entry_t keyword_table[KEYWORD_TABLE_SIZE] = {")
+for entry in table:
+    if entry is None:
+        print("    {.keyword = \"\", .length = 0, .tag = CORTECS_LEXER_TAG_NAME},")
+    else:
+        keyword, tag = entry
+        print("    {{.keyword = \"{}\", .length = {}, .tag = {}}},".format(keyword, len(keyword), tag))
+print("};")
+print()
+print("#endif")
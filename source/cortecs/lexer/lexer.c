@@ -3,8 +3,10 @@
 #include <cortecs/lexer.h>
 #include <cortecs/span.h>
 #include <cortecs/string.h>
+#include <cortecs/symbol.h>
 #include <cortecs/tokens.h>
 #include <ctype.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,27 +16,177 @@
 #include <unicode/utext.h>
 #include <unicode/utf16.h>
 #include <unicode/utypes.h>
+#include <unistd.h>
+
+#include "source/cortecs/lexer/classes.h"
+#include "source/cortecs/lexer/dfa.h"
+#include "source/cortecs/lexer/keywords.h"
+#include "source/cortecs/lexer/unicode_classes.h"
 
 typedef struct {
+    // exactly one of text and bytes is set
     UText *text;
+    const uint8_t *bytes;
+    uint32_t length;
+    // the offset of the next byte when lexing bytes
+    uint32_t offset;
+    // an ill-formed sequence was replaced with U+FFFD so the token's text can't be copied from bytes
+    bool has_replacement;
+
     int64_t start;
     int32_t u8_length;
     int32_t num_codepoints;
     cortecs_span_t span;
+    cortecs_lexer_config_t config;
 } lexer_state_t;
 
+// ASCII codepoints are classified with this table and everything else with the generated unicode_classes.h.
+// bytes 0x80-0xFF have no class so the ascii fast path stops at them
+static const uint8_t ascii_classes[256] = {
+    [0] = CLASS_PUNCTUATION,
+    ['\n'] = CLASS_PUNCTUATION,
+    [' '] = CLASS_SPACE,
+    ['\t'] = CLASS_SPACE,
+    ['\r'] = CLASS_SPACE,
+    ['\f'] = CLASS_SPACE,
+    ['\v'] = CLASS_SPACE,
+    ['a' ... 'z'] = CLASS_ALPHA | CLASS_NAME,
+    ['A' ... 'Z'] = CLASS_ALPHA | CLASS_UPPER | CLASS_NAME,
+    ['0' ... '9'] = CLASS_DIGIT | CLASS_NAME,
+    ['_'] = CLASS_PUNCTUATION | CLASS_NAME,
+    ['.'] = CLASS_PUNCTUATION,
+    ['('] = CLASS_PUNCTUATION,
+    [')'] = CLASS_PUNCTUATION,
+    ['{'] = CLASS_PUNCTUATION,
+    ['}'] = CLASS_PUNCTUATION,
+    ['['] = CLASS_PUNCTUATION,
+    [']'] = CLASS_PUNCTUATION,
+    ['\''] = CLASS_PUNCTUATION,
+    ['"'] = CLASS_PUNCTUATION,
+    ['`'] = CLASS_PUNCTUATION,
+    [','] = CLASS_PUNCTUATION,
+    [':'] = CLASS_PUNCTUATION,
+    [';'] = CLASS_PUNCTUATION,
+    ['!'] = CLASS_OPERATOR,
+    ['#'] = CLASS_OPERATOR,
+    ['$'] = CLASS_OPERATOR,
+    ['%'] = CLASS_OPERATOR,
+    ['&'] = CLASS_OPERATOR,
+    ['*'] = CLASS_OPERATOR,
+    ['+'] = CLASS_OPERATOR,
+    ['-'] = CLASS_OPERATOR,
+    ['/'] = CLASS_OPERATOR,
+    ['<'] = CLASS_OPERATOR,
+    ['='] = CLASS_OPERATOR,
+    ['>'] = CLASS_OPERATOR,
+    ['?'] = CLASS_OPERATOR,
+    ['@'] = CLASS_OPERATOR,
+    ['\\'] = CLASS_OPERATOR,
+    ['^'] = CLASS_OPERATOR,
+    ['|'] = CLASS_OPERATOR,
+    ['~'] = CLASS_OPERATOR,
+};
+
+static bool is_ascii(UChar32 codepoint) {
+    // U_SENTINEL is negative and fails this check
+    return (uint32_t)codepoint < 128;
+}
+
+// the generated table has the same classes as u_isalpha, u_isdigit, u_isupper and u_isalnum
+static uint8_t class_of(UChar32 codepoint) {
+    if (is_ascii(codepoint)) {
+        return ascii_classes[codepoint];
+    }
+
+    // U_SENTINEL is negative and wraps past the last codepoint
+    uint32_t index = (uint32_t)codepoint;
+    if (index > UCHAR_MAX_VALUE) {
+        return 0;
+    }
+    return unicode_class_blocks[(unicode_class_index[index >> UNICODE_CLASSES_SHIFT] << UNICODE_CLASSES_SHIFT) | (index & UNICODE_CLASSES_MASK)];
+}
+
+static bool is_alpha(UChar32 codepoint) {
+    return class_of(codepoint) & CLASS_ALPHA;
+}
+
+static bool is_digit(UChar32 codepoint) {
+    return class_of(codepoint) & CLASS_DIGIT;
+}
+
+static bool is_upper(UChar32 codepoint) {
+    return class_of(codepoint) & CLASS_UPPER;
+}
+
+// [a-zA-Z0-9_]
+static bool is_name(UChar32 codepoint) {
+    return class_of(codepoint) & CLASS_NAME;
+}
+
 static UChar32 current_codepoint(lexer_state_t *state) {
-    return utext_current32(state->text);
+    if (state->bytes == NULL) {
+        return utext_current32(state->text);
+    }
+
+    if (state->offset >= state->length) {
+        return U_SENTINEL;
+    }
+
+    uint8_t byte = state->bytes[state->offset];
+    if (byte < 0x80) {
+        return byte;
+    }
+
+    // matches the UText which replaces ill-formed sequences with U+FFFD
+    UChar32 codepoint;
+    int32_t offset = state->offset;
+    U8_NEXT_OR_FFFD(state->bytes, offset, (int32_t)state->length, codepoint);
+    return codepoint;
 }
 
 static void next_codepoint(lexer_state_t *state) {
-    utext_next32(state->text);
+    if (state->bytes == NULL) {
+        utext_next32(state->text);
+        return;
+    }
+
+    if (state->offset >= state->length) {
+        return;
+    }
+
+    if (state->bytes[state->offset] < 0x80) {
+        state->offset++;
+        return;
+    }
+
+    UChar32 codepoint;
+    int32_t offset = state->offset;
+    U8_NEXT_OR_FFFD(state->bytes, offset, (int32_t)state->length, codepoint);
+    state->offset = offset;
+}
+
+static int64_t get_index(lexer_state_t *state) {
+    if (state->bytes == NULL) {
+        return utext_getNativeIndex(state->text);
+    }
+    return state->offset;
+}
+
+static void set_index(lexer_state_t *state, int64_t index) {
+    if (state->bytes == NULL) {
+        utext_setNativeIndex(state->text, index);
+        return;
+    }
+    state->offset = index;
 }
 
 static void accumulate_codepoint(lexer_state_t *state, UChar32 codepoint) {
     next_codepoint(state);
     state->u8_length += U8_LENGTH(codepoint);
     state->num_codepoints++;
+    if (codepoint == 0xFFFD) {
+        state->has_replacement = true;
+    }
 
     // characters that take multiple code points seem to have a span that
     // based on number of codepointers and not a single character
@@ -42,37 +194,92 @@ static void accumulate_codepoint(lexer_state_t *state, UChar32 codepoint) {
     state->span.columns++;
 }
 
-static cortecs_lexer_token_t construct_result(cortecs_lexer_tag_t tag, lexer_state_t *state) {
-    // allocate a buffer for the utf-8 encoding of the token + null terminator
-    // TODO figure out the correct string API for this use case
-    char *content = malloc((state->u8_length + 1) * sizeof(char));
+// names are usually short. longer names fall back to malloc
+#define SYMBOL_BUFFER_SIZE 256
 
-    // reset the UText to the start of this token and copy it into the buffer
-    utext_setNativeIndex(state->text, state->start);
+// the token's bytes when they can be used without reencoding
+static const char *token_bytes(lexer_state_t *state) {
+    if (state->bytes == NULL || state->has_replacement) {
+        return NULL;
+    }
+    return (const char *)state->bytes + state->start;
+}
+
+static CN(Cortecs, Symbol) intern_symbol(lexer_state_t *state) {
+    const char *bytes = token_bytes(state);
+    if (bytes != NULL) {
+        return CN(Cortecs, Symbol, intern)(bytes, state->u8_length);
+    }
+
+    char buffer[SYMBOL_BUFFER_SIZE];
+    char *content = buffer;
+    if (state->u8_length > SYMBOL_BUFFER_SIZE) {
+        content = malloc(state->u8_length * sizeof(char));
+    }
+
+    // reset to the start of this token and copy it into the buffer
+    set_index(state, state->start);
     int32_t next_offset = 0;
     for (int i = 0; i < state->num_codepoints; i++) {
         UChar32 codepoint = current_codepoint(state);
         U8_APPEND_UNSAFE(content, next_offset, codepoint);
         next_codepoint(state);
     }
-    content[state->u8_length] = 0;
 
-    CN(Cortecs, String) out = CN(Cortecs, String, new)("%s", content);
+    CN(Cortecs, Symbol) symbol = CN(Cortecs, Symbol, intern)(content, state->u8_length);
+
+    if (content != buffer) {
+        free(content);
+    }
+
+    return symbol;
+}
+
+static CN(Cortecs, String) construct_text(lexer_state_t *state) {
+    const char *bytes = token_bytes(state);
+    if (bytes != NULL) {
+        return CN(Cortecs, String, from_bytes)(bytes, state->u8_length);
+    }
+
+    CN(Cortecs, String, Builder) builder = CN(Cortecs, String, Builder, new)(state->u8_length);
+
+    // reset to the start of this token and copy it into the builder
+    set_index(state, state->start);
+    for (int i = 0; i < state->num_codepoints; i++) {
+        CN(Cortecs, String, Builder, append_codepoint)(&builder, current_codepoint(state));
+        next_codepoint(state);
+    }
 
-    free(content);
+    return CN(Cortecs, String, Builder, finish)(&builder);
+}
 
-    return (cortecs_lexer_token_t){
+static cortecs_lexer_token_t construct_result(cortecs_lexer_tag_t tag, lexer_state_t *state) {
+    cortecs_lexer_token_t token = {
         .tag = tag,
         .span = state->span,
-        .text = out,
+        .offset = state->start,
+        .length = get_index(state) - state->start,
+        .text = {.content = NULL},
+        .symbol = {.entry = NULL},
     };
+
+    if (state->config.intern_names && (tag == CORTECS_LEXER_TAG_NAME || tag == CORTECS_LEXER_TAG_TYPE)) {
+        // the text isn't allocated. the symbol table owns the text of the token
+        token.symbol = intern_symbol(state);
+        return token;
+    }
+
+    if (!state->config.lazy_text) {
+        token.text = construct_text(state);
+    }
+    return token;
 }
 
 static cortecs_lexer_token_t lex_float_bad(lexer_state_t *state) {
     // (\d+\.\d*[a-ce-zA-CE-Z_][a-zA-Z0-9_]*) | (\.\d+[a-ce-zA-CE-Z_][a-zA-Z0-9_]*) | (\d+\.\d*[dD][a-zA-Z0-9_]+) | (\.\d+[dD][a-zA-Z0-9_]+)
     while (true) {
         UChar32 codepoint = current_codepoint(state);
-        if (u_isalnum(codepoint) || codepoint == '_') {
+        if (is_name(codepoint)) {
             accumulate_codepoint(state, codepoint);
             continue;
         }
@@ -96,7 +303,7 @@ static cortecs_lexer_token_t lex_float(lexer_state_t *state) {
 
     while (true) {
         UChar32 codepoint = current_codepoint(state);
-        if (u_isdigit(codepoint)) {
+        if (is_digit(codepoint)) {
             accumulate_codepoint(state, codepoint);
             continue;
         }
@@ -106,7 +313,7 @@ static cortecs_lexer_token_t lex_float(lexer_state_t *state) {
             break;
         }
 
-        if (u_isalpha(codepoint) || codepoint == '_') {
+        if (is_alpha(codepoint) || codepoint == '_') {
             accumulate_codepoint(state, codepoint);
             return lex_float_bad(state);
         }
@@ -115,7 +322,7 @@ static cortecs_lexer_token_t lex_float(lexer_state_t *state) {
     }
 
     UChar32 codepoint = current_codepoint(state);
-    if (u_isalnum(codepoint) || codepoint == '_') {
+    if (is_name(codepoint)) {
         accumulate_codepoint(state, codepoint);
         return lex_float_bad(state);
     }
@@ -125,7 +332,7 @@ static cortecs_lexer_token_t lex_float(lexer_state_t *state) {
 
 static cortecs_lexer_token_t lex_dot(lexer_state_t *state) {
     UChar32 codepoint = current_codepoint(state);
-    if (u_isdigit(codepoint)) {
+    if (is_digit(codepoint)) {
         // the token is a float literal matching \.\d+[dD]?
         accumulate_codepoint(state, codepoint);
         return lex_float(state);
@@ -137,7 +344,7 @@ static cortecs_lexer_token_t lex_dot(lexer_state_t *state) {
 static cortecs_lexer_token_t lex_int_bad(lexer_state_t *state) {
     while (true) {
         UChar32 codepoint = current_codepoint(state);
-        if (u_isalnum(codepoint) || codepoint == '_') {
+        if (is_name(codepoint)) {
             accumulate_codepoint(state, codepoint);
             continue;
         }
@@ -158,7 +365,7 @@ static cortecs_lexer_token_t lex_int(lexer_state_t *state) {
             return lex_float(state);
         }
 
-        if (u_isdigit(codepoint)) {
+        if (is_digit(codepoint)) {
             accumulate_codepoint(state, codepoint);
             continue;
         }
@@ -183,7 +390,7 @@ static cortecs_lexer_token_t lex_int(lexer_state_t *state) {
     }
 
     UChar32 codepoint = current_codepoint(state);
-    if (u_isalnum(codepoint) || codepoint == '_') {
+    if (is_name(codepoint)) {
         accumulate_codepoint(state, codepoint);
         return lex_int_bad(state);
     }
@@ -193,64 +400,49 @@ static cortecs_lexer_token_t lex_int(lexer_state_t *state) {
 
 // All ASCII characters are represented with the same numerical value
 // in UTF-16 just with twice the space usage.
-#define U8_LENGTH_OF_ASCII(kw) (sizeof(kw) - 1)
-#define U8_IF_LENGTH U8_LENGTH_OF_ASCII("if")
-#define U8_LET_LENGTH U8_LENGTH_OF_ASCII("let")
-#define U8_RETURN_LENGTH U8_LENGTH_OF_ASCII("return")
-#define U8_FUNCTION_LENGTH U8_LENGTH_OF_ASCII("function")
-
-static bool check_keyword(lexer_state_t *state, const char *keyword) {
-    int64_t end = utext_getNativeIndex(state->text);
-
-    bool are_equal = true;
-    utext_setNativeIndex(state->text, state->start);
-    for (uint32_t i = 0; keyword[i] != 0; i++) {
-        UChar32 codepoint = utext_current32(state->text);
-        utext_next32(state->text);
-
-        // ASCII characters are encoded with the same value in utf-32
-        if (codepoint != keyword[i]) {
-            are_equal = false;
-            break;
-        }
+// keywords are short lowercase ascii. a UText can't be read back without rewinding
+// so the name's ascii prefix is collected while it's scanned
+typedef struct {
+    char bytes[KEYWORD_MAX_LENGTH];
+    // more than KEYWORD_MAX_LENGTH when the name can't be a keyword
+    uint32_t length;
+} keyword_candidate_t;
+
+static void append_candidate(keyword_candidate_t *candidate, UChar32 codepoint) {
+    if (candidate->length < KEYWORD_MAX_LENGTH && is_ascii(codepoint)) {
+        candidate->bytes[candidate->length] = (char)codepoint;
+        candidate->length++;
+        return;
     }
-    utext_setNativeIndex(state->text, end);
-
-    return are_equal;
+    candidate->length = KEYWORD_MAX_LENGTH + 1;
 }
 
-static bool is_first_codepoint_upper(lexer_state_t *state) {
-    int64_t end = utext_getNativeIndex(state->text);
-    utext_setNativeIndex(state->text, state->start);
-    UChar32 codepoint = utext_current32(state->text);
-    utext_setNativeIndex(state->text, end);
-    return u_isupper(codepoint);
+// the keyword's tag or NAME
+static cortecs_lexer_tag_t keyword_tag(const char *bytes, uint32_t length) {
+    if (length <= KEYWORD_MAX_LENGTH) {
+        const keyword_entry_t *entry = &keyword_table[KEYWORD_HASH(bytes[0], bytes[length - 1], length)];
+        if (entry->length == length && memcmp(bytes, entry->keyword, length) == 0) {
+            return entry->tag;
+        }
+    }
+    return CORTECS_LEXER_TAG_NAME;
 }
 
-static cortecs_lexer_tag_t get_name_tag(lexer_state_t *state) {
-    if (state->u8_length == U8_IF_LENGTH && check_keyword(state, "if")) {
-        return CORTECS_LEXER_TAG_IF;
-    }
-    if (state->u8_length == U8_LET_LENGTH && check_keyword(state, "let")) {
-        return CORTECS_LEXER_TAG_LET;
-    }
-    if (state->u8_length == U8_RETURN_LENGTH && check_keyword(state, "return")) {
-        return CORTECS_LEXER_TAG_RETURN;
-    }
-    if (state->u8_length == U8_FUNCTION_LENGTH && check_keyword(state, "function")) {
-        return CORTECS_LEXER_TAG_FUNCTION;
-    }
-    if (is_first_codepoint_upper(state)) {
+static cortecs_lexer_tag_t get_name_tag(keyword_candidate_t *candidate, UChar32 first_codepoint) {
+    if (is_upper(first_codepoint)) {
         return CORTECS_LEXER_TAG_TYPE;
     }
-    return CORTECS_LEXER_TAG_NAME;
+    return keyword_tag(candidate->bytes, candidate->length);
 }
 
-static cortecs_lexer_token_t lex_name(lexer_state_t *state) {
+static cortecs_lexer_token_t lex_name(lexer_state_t *state, UChar32 first_codepoint) {
     // [a-zA-Z][a-zA-Z0-9_]*
+    keyword_candidate_t candidate = {.length = 0};
+    append_candidate(&candidate, first_codepoint);
     while (true) {
         UChar32 codepoint = current_codepoint(state);
-        if (u_isalnum(codepoint) || codepoint == '_') {
+        if (is_name(codepoint)) {
+            append_candidate(&candidate, codepoint);
             accumulate_codepoint(state, codepoint);
             continue;
         }
@@ -258,12 +450,11 @@ static cortecs_lexer_token_t lex_name(lexer_state_t *state) {
         break;
     }
 
-    return construct_result(get_name_tag(state), state);
+    return construct_result(get_name_tag(&candidate, first_codepoint), state);
 }
 
 static bool is_space(UChar32 codepoint) {
-    return codepoint == ' ' || codepoint == '\t' || codepoint == '\r' ||
-           codepoint == '\f' || codepoint == '\v';
+    return is_ascii(codepoint) && (ascii_classes[codepoint] & CLASS_SPACE);
 }
 
 static cortecs_lexer_token_t lex_whitespace(lexer_state_t *state) {
@@ -282,12 +473,7 @@ static cortecs_lexer_token_t lex_whitespace(lexer_state_t *state) {
 }
 
 static bool is_operator(UChar32 codepoint) {
-    return codepoint == '!' || codepoint == '#' || codepoint == '$' ||
-           codepoint == '%' || codepoint == '&' || codepoint == '*' ||
-           codepoint == '+' || codepoint == '-' || codepoint == '/' ||
-           codepoint == '<' || codepoint == '=' || codepoint == '>' ||
-           codepoint == '?' || codepoint == '@' || codepoint == '\\' ||
-           codepoint == '^' || codepoint == '|' || codepoint == '~';
+    return is_ascii(codepoint) && (ascii_classes[codepoint] & CLASS_OPERATOR);
 }
 
 static cortecs_lexer_token_t lex_operator(lexer_state_t *state) {
@@ -306,31 +492,17 @@ static cortecs_lexer_token_t lex_operator(lexer_state_t *state) {
 }
 
 static bool is_invalid(UChar32 codepoint) {
-    if (codepoint == '.' || codepoint == '(' || codepoint == ')' ||
-        codepoint == '{' || codepoint == '}' || codepoint == '[' ||
-        codepoint == ']' || codepoint == '\'' || codepoint == '"' ||
-        codepoint == '`' || codepoint == ',' || codepoint == ':' ||
-        codepoint == ';' || codepoint == '_' || codepoint == '\n' || codepoint == 0) {
-        return false;
-    }
-
-    if (u_isalpha(codepoint)) {
-        return false;
-    }
-
-    if (u_isdigit(codepoint)) {
-        return false;
-    }
-
-    if (is_space(codepoint)) {
+    // the end of the input
+    if (codepoint == U_SENTINEL) {
         return false;
     }
 
-    if (is_operator(codepoint)) {
-        return false;
+    if (is_ascii(codepoint)) {
+        return ascii_classes[codepoint] == 0;
     }
 
-    return true;
+    // spaces and operators are all ascii
+    return (class_of(codepoint) & (CLASS_ALPHA | CLASS_DIGIT)) == 0;
 }
 
 static cortecs_lexer_token_t lex_invalid(lexer_state_t *state) {
@@ -347,33 +519,15 @@ static cortecs_lexer_token_t lex_invalid(lexer_state_t *state) {
     return construct_result(CORTECS_LEXER_TAG_INVALID, state);
 }
 
-cortecs_lexer_token_t cortecs_lexer_next(UText *text) {
-    if (text == NULL) {
-        return (cortecs_lexer_token_t){
-            .tag = CORTECS_LEXER_TAG_INVALID,
-            .text = {.content = NULL},
-            .span = {
-                .lines = 0,
-                .columns = 0,
-            },
-        };
-    }
-
-    lexer_state_t state = {
-        .text = text,
-        .start = utext_getNativeIndex(text),
-        .u8_length = 0,
-        .num_codepoints = 0,
-        .span = {
-            .lines = 0,
-            .columns = 0,
-        },
-    };
-
-    UChar32 codepoint = utext_current32(text);
+// lexes a UText one codepoint at a time. bytes are lexed by lex_table with the table generated
+// from dfa.py which describes the same tokens. the tests check that the two agree
+static cortecs_lexer_token_t lex(lexer_state_t *state) {
+    UChar32 codepoint = current_codepoint(state);
     if (codepoint == U_SENTINEL) {
         return (cortecs_lexer_token_t){
             .tag = CORTECS_LEXER_TAG_INVALID,
+            .offset = state->start,
+            .length = 0,
             .text = {.content = NULL},
             .span = {
                 .lines = 0,
@@ -382,70 +536,681 @@ cortecs_lexer_token_t cortecs_lexer_next(UText *text) {
         };
     }
 
-    accumulate_codepoint(&state, codepoint);
+    accumulate_codepoint(state, codepoint);
     switch (codepoint) {
         case '.': {
-            return lex_dot(&state);
+            return lex_dot(state);
         }
         case '\n': {
-            state.span.columns = 0;
-            state.span.lines++;
-            return construct_result(CORTECS_LEXER_TAG_NEW_LINE, &state);
+            state->span.columns = 0;
+            state->span.lines++;
+            return construct_result(CORTECS_LEXER_TAG_NEW_LINE, state);
         }
         case '(': {
-            return construct_result(CORTECS_LEXER_TAG_OPEN_PAREN, &state);
+            return construct_result(CORTECS_LEXER_TAG_OPEN_PAREN, state);
         }
         case ')': {
-            return construct_result(CORTECS_LEXER_TAG_CLOSE_PAREN, &state);
+            return construct_result(CORTECS_LEXER_TAG_CLOSE_PAREN, state);
         }
         case '{': {
-            return construct_result(CORTECS_LEXER_TAG_OPEN_CURLY, &state);
+            return construct_result(CORTECS_LEXER_TAG_OPEN_CURLY, state);
         }
         case '}': {
-            return construct_result(CORTECS_LEXER_TAG_CLOSE_CURLY, &state);
+            return construct_result(CORTECS_LEXER_TAG_CLOSE_CURLY, state);
         }
         case '[': {
-            return construct_result(CORTECS_LEXER_TAG_OPEN_SQUARE, &state);
+            return construct_result(CORTECS_LEXER_TAG_OPEN_SQUARE, state);
         }
         case ']': {
-            return construct_result(CORTECS_LEXER_TAG_CLOSE_SQUARE, &state);
+            return construct_result(CORTECS_LEXER_TAG_CLOSE_SQUARE, state);
         }
         case '\'': {
-            return construct_result(CORTECS_LEXER_TAG_SINGLE_QUOTE, &state);
+            return construct_result(CORTECS_LEXER_TAG_SINGLE_QUOTE, state);
         }
         case '"': {
-            return construct_result(CORTECS_LEXER_TAG_DOUBLE_QUOTE, &state);
+            return construct_result(CORTECS_LEXER_TAG_DOUBLE_QUOTE, state);
         }
         case '`': {
-            return construct_result(CORTECS_LEXER_TAG_BACK_QUOTE, &state);
+            return construct_result(CORTECS_LEXER_TAG_BACK_QUOTE, state);
         }
         case ',': {
-            return construct_result(CORTECS_LEXER_TAG_COMMA, &state);
+            return construct_result(CORTECS_LEXER_TAG_COMMA, state);
         }
         case ':': {
-            return construct_result(CORTECS_LEXER_TAG_COLON, &state);
+            return construct_result(CORTECS_LEXER_TAG_COLON, state);
         }
         case ';': {
-            return construct_result(CORTECS_LEXER_TAG_SEMICOLON, &state);
+            return construct_result(CORTECS_LEXER_TAG_SEMICOLON, state);
         }
         default: {
-            if (u_isalpha(codepoint) || codepoint == '_') {
-                return lex_name(&state);
+            if (is_alpha(codepoint) || codepoint == '_') {
+                return lex_name(state, codepoint);
             }
 
-            if (u_isdigit(codepoint)) {
-                return lex_int(&state);
+            if (is_digit(codepoint)) {
+                return lex_int(state);
             }
 
             if (is_space(codepoint)) {
-                return lex_whitespace(&state);
+                return lex_whitespace(state);
             }
 
             if (is_operator(codepoint)) {
-                return lex_operator(&state);
+                return lex_operator(state);
+            }
+
+            return lex_invalid(state);
+        }
+    }
+}
+
+static cortecs_lexer_token_t lex_table(lexer_state_t *state) {
+    const uint8_t *bytes = state->bytes;
+    uint32_t length = state->length;
+    uint32_t offset = state->offset;
+    uint32_t dfa_state = DFA_START;
+    int32_t u8_length = 0;
+    int32_t num_codepoints = 0;
+    bool has_replacement = false;
+    while (offset < length) {
+        uint8_t byte = bytes[offset];
+        if (byte < 0x80) {
+            uint32_t next_state = dfa_transitions[dfa_state][dfa_ascii_classes[byte]];
+            if (next_state == DFA_STOP) {
+                break;
+            }
+            dfa_state = next_state;
+            offset++;
+            u8_length++;
+            num_codepoints++;
+            continue;
+        }
+
+        // matches the UText which replaces ill-formed sequences with U+FFFD
+        UChar32 codepoint;
+        int32_t next_offset = offset;
+        U8_NEXT_OR_FFFD(bytes, next_offset, (int32_t)length, codepoint);
+        uint32_t next_state = dfa_transitions[dfa_state][dfa_unicode_classes[class_of(codepoint)]];
+        if (next_state == DFA_STOP) {
+            break;
+        }
+        dfa_state = next_state;
+        offset = next_offset;
+        u8_length += U8_LENGTH(codepoint);
+        num_codepoints++;
+        has_replacement = has_replacement || codepoint == 0xFFFD;
+    }
+
+    state->offset = offset;
+    state->u8_length = u8_length;
+    state->num_codepoints = num_codepoints;
+    state->has_replacement = has_replacement;
+    if (dfa_state == DFA_START) {
+        // the end of the input
+        return (cortecs_lexer_token_t){
+            .tag = CORTECS_LEXER_TAG_INVALID,
+            .offset = state->start,
+            .length = 0,
+            .text = {.content = NULL},
+            .span = {
+                .lines = 0,
+                .columns = 0,
+            },
+        };
+    }
+
+    cortecs_lexer_tag_t tag = dfa_tags[dfa_state];
+    if (tag == CORTECS_LEXER_TAG_NEW_LINE) {
+        state->span = (cortecs_span_t){.lines = 1, .columns = 0};
+    } else {
+        state->span = (cortecs_span_t){.lines = 0, .columns = num_codepoints};
+    }
+
+    // names are never ill-formed so their bytes are the text
+    if (tag == CORTECS_LEXER_TAG_NAME) {
+        tag = keyword_tag((const char *)bytes + state->start, u8_length);
+    }
+    return construct_result(tag, state);
+}
+
+cortecs_lexer_token_t cortecs_lexer_next(UText *text) {
+    return cortecs_lexer_next_with_config(text, (cortecs_lexer_config_t){.intern_names = false, .lazy_text = false});
+}
+
+cortecs_lexer_token_t cortecs_lexer_next_with_config(UText *text, cortecs_lexer_config_t config) {
+    if (text == NULL) {
+        return (cortecs_lexer_token_t){
+            .tag = CORTECS_LEXER_TAG_INVALID,
+            .text = {.content = NULL},
+            .span = {
+                .lines = 0,
+                .columns = 0,
+            },
+        };
+    }
+
+    lexer_state_t state = {
+        .text = text,
+        .bytes = NULL,
+        .start = utext_getNativeIndex(text),
+        .u8_length = 0,
+        .num_codepoints = 0,
+        .span = {
+            .lines = 0,
+            .columns = 0,
+        },
+        .config = config,
+    };
+    return lex(&state);
+}
+
+cortecs_lexer_token_t cortecs_lexer_next_utf8(const char *bytes, uint32_t length, uint32_t *offset) {
+    return cortecs_lexer_next_utf8_with_config(bytes, length, offset, (cortecs_lexer_config_t){.intern_names = false, .lazy_text = false});
+}
+
+cortecs_lexer_token_t cortecs_lexer_next_utf8_with_config(const char *bytes, uint32_t length, uint32_t *offset, cortecs_lexer_config_t config) {
+    if (bytes == NULL) {
+        return (cortecs_lexer_token_t){
+            .tag = CORTECS_LEXER_TAG_INVALID,
+            .text = {.content = NULL},
+            .span = {
+                .lines = 0,
+                .columns = 0,
+            },
+        };
+    }
+
+    lexer_state_t state = {
+        .text = NULL,
+        .bytes = (const uint8_t *)bytes,
+        .length = length,
+        .offset = *offset,
+        .has_replacement = false,
+        .start = *offset,
+        .u8_length = 0,
+        .num_codepoints = 0,
+        .span = {
+            .lines = 0,
+            .columns = 0,
+        },
+        .config = config,
+    };
+    cortecs_lexer_token_t token = lex_table(&state);
+    *offset = state.offset;
+    return token;
+}
+
+// tokens are collected in malloc'd columns then copied into exactly sized gc columns
+// so the result is a single allocation per column
+typedef struct {
+    uint32_t size;
+    uint32_t capacity;
+    uint8_t *tags;
+    uint32_t *offsets;
+    uint32_t *lengths;
+    uint32_t *lines;
+    uint32_t *columns;
+} token_columns_t;
+
+// most tokens are a few bytes so this rarely has to grow
+#define BYTES_PER_TOKEN_ESTIMATE 2
+
+static void grow_columns(token_columns_t *columns, uint32_t capacity) {
+    columns->capacity = capacity;
+    columns->tags = realloc(columns->tags, capacity * sizeof(uint8_t));
+    columns->offsets = realloc(columns->offsets, capacity * sizeof(uint32_t));
+    columns->lengths = realloc(columns->lengths, capacity * sizeof(uint32_t));
+    columns->lines = realloc(columns->lines, capacity * sizeof(uint32_t));
+    columns->columns = realloc(columns->columns, capacity * sizeof(uint32_t));
+}
+
+static void push_token(token_columns_t *columns, cortecs_lexer_token_t token) {
+    if (columns->size == columns->capacity) {
+        grow_columns(columns, columns->capacity * 2);
+    }
+    columns->tags[columns->size] = token.tag;
+    columns->offsets[columns->size] = token.offset;
+    columns->lengths[columns->size] = token.length;
+    columns->lines[columns->size] = token.span.lines;
+    columns->columns[columns->size] = token.span.columns;
+    columns->size++;
+}
+
+// lexes the token at the state's offset into the columns. returns false at the end of the input
+static bool lex_into(lexer_state_t *state, token_columns_t *columns) {
+    if (state->offset >= state->length) {
+        return false;
+    }
+
+    state->has_replacement = false;
+    state->start = state->offset;
+    state->u8_length = 0;
+    state->num_codepoints = 0;
+    state->span = (cortecs_span_t){.lines = 0, .columns = 0};
+    cortecs_lexer_token_t token = lex_table(state);
+    if (token.length == 0) {
+        return false;
+    }
+
+    push_token(columns, token);
+    return true;
+}
+
+static cortecs_lexer_tokens_t alloc_tokens(uint32_t size) {
+    return (cortecs_lexer_tokens_t){
+        .size = size,
+        .tags = cortecs_gc_alloc_array(CN(Cortecs, U8), size),
+        .offsets = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .lengths = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .lines = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .columns = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+    };
+}
+
+static void move_column(void *elements, void *column, uint32_t size, uint32_t size_of_element) {
+    if (size > 0) {
+        memcpy(elements, column, size * size_of_element);
+    }
+    free(column);
+}
+
+static cortecs_lexer_tokens_t finish_columns(token_columns_t *columns) {
+    cortecs_lexer_tokens_t tokens = alloc_tokens(columns->size);
+    move_column(tokens.tags->elements, columns->tags, columns->size, sizeof(uint8_t));
+    move_column(tokens.offsets->elements, columns->offsets, columns->size, sizeof(uint32_t));
+    move_column(tokens.lengths->elements, columns->lengths, columns->size, sizeof(uint32_t));
+    move_column(tokens.lines->elements, columns->lines, columns->size, sizeof(uint32_t));
+    move_column(tokens.columns->elements, columns->columns, columns->size, sizeof(uint32_t));
+    return tokens;
+}
+
+static lexer_state_t tokenize_state(const char *bytes, uint32_t length, uint32_t offset) {
+    return (lexer_state_t){
+        .text = NULL,
+        .bytes = (const uint8_t *)bytes,
+        .length = bytes == NULL ? 0 : length,
+        .offset = offset,
+        .config = {.intern_names = false, .lazy_text = true},
+    };
+}
+
+cortecs_lexer_tokens_t cortecs_lexer_tokenize(const char *bytes, uint32_t length) {
+    token_columns_t columns = {.size = 0, .capacity = 0};
+    grow_columns(&columns, length / BYTES_PER_TOKEN_ESTIMATE + 16);
+
+    lexer_state_t state = tokenize_state(bytes, length, 0);
+    while (lex_into(&state, &columns)) {
+    }
+    return finish_columns(&columns);
+}
+
+// chunks end after a newline. a newline is always a token of its own and doesn't look
+// past itself so lexing can restart after any newline
+typedef struct {
+    const char *bytes;
+    uint32_t start;
+    uint32_t end;
+    token_columns_t columns;
+    // false when the chunk didn't end with a newline token. a token that spans lines was cut short
+    bool is_restartable;
+} chunk_t;
+
+// inputs smaller than this aren't split when the number of threads is chosen automatically
+#define PARALLEL_MIN_CHUNK_SIZE (256 * 1024)
+#define PARALLEL_MAX_THREADS 64
+
+static void *lex_chunk(void *argument) {
+    chunk_t *chunk = argument;
+    grow_columns(&chunk->columns, (chunk->end - chunk->start) / BYTES_PER_TOKEN_ESTIMATE + 16);
+
+    lexer_state_t state = tokenize_state(chunk->bytes, chunk->end, chunk->start);
+    while (lex_into(&state, &chunk->columns)) {
+    }
+
+    uint32_t size = chunk->columns.size;
+    chunk->is_restartable = size > 0 && chunk->columns.tags[size - 1] == CORTECS_LEXER_TAG_NEW_LINE;
+    return NULL;
+}
+
+static uint32_t choose_num_threads(uint32_t length, uint32_t num_threads) {
+    if (num_threads == 0) {
+        long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        uint32_t max_chunks = length / PARALLEL_MIN_CHUNK_SIZE;
+        num_threads = num_cpus < 1 ? 1 : (uint32_t)num_cpus;
+        num_threads = num_threads < max_chunks ? num_threads : max_chunks;
+    }
+    if (num_threads < 1) {
+        return 1;
+    }
+    return num_threads < PARALLEL_MAX_THREADS ? num_threads : PARALLEL_MAX_THREADS;
+}
+
+// splits the input into chunks of about the same size that end after a newline
+static uint32_t split_chunks(const char *bytes, uint32_t length, uint32_t num_threads, chunk_t *chunks) {
+    uint32_t num_chunks = 0;
+    uint32_t start = 0;
+    for (uint32_t i = 1; i <= num_threads && start < length; i++) {
+        uint32_t end = length;
+        if (i < num_threads) {
+            // the previous chunk's line already reached past this chunk's share
+            uint32_t target = (uint32_t)((uint64_t)length * i / num_threads);
+            if (target <= start) {
+                continue;
+            }
+            const char *newline = memchr(bytes + target - 1, '\n', length - (target - 1));
+            end = newline == NULL ? length : (uint32_t)(newline - bytes) + 1;
+        }
+
+        chunks[num_chunks] = (chunk_t){
+            .bytes = bytes,
+            .start = start,
+            .end = end,
+            .columns = {.size = 0, .capacity = 0},
+            .is_restartable = false,
+        };
+        num_chunks++;
+        start = end;
+    }
+    return num_chunks;
+}
+
+static void free_columns(token_columns_t *columns) {
+    free(columns->tags);
+    free(columns->offsets);
+    free(columns->lengths);
+    free(columns->lines);
+    free(columns->columns);
+}
+
+cortecs_lexer_tokens_t cortecs_lexer_tokenize_parallel(const char *bytes, uint32_t length, uint32_t num_threads) {
+    if (bytes == NULL) {
+        return cortecs_lexer_tokenize(bytes, length);
+    }
+
+    num_threads = choose_num_threads(length, num_threads);
+    if (num_threads == 1 || length == 0) {
+        return cortecs_lexer_tokenize(bytes, length);
+    }
+
+    chunk_t chunks[PARALLEL_MAX_THREADS];
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    bool is_started[PARALLEL_MAX_THREADS];
+    uint32_t num_chunks = split_chunks(bytes, length, num_threads, chunks);
+
+    // the calling thread lexes the first chunk. chunks whose thread can't be started are lexed after it
+    for (uint32_t i = 1; i < num_chunks; i++) {
+        is_started[i] = pthread_create(&threads[i], NULL, lex_chunk, &chunks[i]) == 0;
+    }
+    lex_chunk(&chunks[0]);
+    for (uint32_t i = 1; i < num_chunks; i++) {
+        if (is_started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            lex_chunk(&chunks[i]);
+        }
+    }
+
+    // every chunk but the last has to end with a newline token to be stitched together
+    bool is_restartable = true;
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < num_chunks; i++) {
+        is_restartable = is_restartable && (i == num_chunks - 1 || chunks[i].is_restartable);
+        size += chunks[i].columns.size;
+    }
+    if (!is_restartable) {
+        for (uint32_t i = 0; i < num_chunks; i++) {
+            free_columns(&chunks[i].columns);
+        }
+        return cortecs_lexer_tokenize(bytes, length);
+    }
+
+    // offsets are already absolute and spans are relative to the token so the chunks are copied as is
+    cortecs_lexer_tokens_t tokens = alloc_tokens(size);
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < num_chunks; i++) {
+        token_columns_t *columns = &chunks[i].columns;
+        move_column(tokens.tags->elements + index, columns->tags, columns->size, sizeof(uint8_t));
+        move_column(tokens.offsets->elements + index, columns->offsets, columns->size, sizeof(uint32_t));
+        move_column(tokens.lengths->elements + index, columns->lengths, columns->size, sizeof(uint32_t));
+        move_column(tokens.lines->elements + index, columns->lines, columns->size, sizeof(uint32_t));
+        move_column(tokens.columns->elements + index, columns->columns, columns->size, sizeof(uint32_t));
+        index += columns->size;
+    }
+    return tokens;
+}
+
+// edits are usually a few characters so only a few tokens are relexed
+#define RELEX_CAPACITY 16
+
+// the first token that can change. every token only looks one codepoint past its end
+// so the tokens before the token containing the byte before the edit are unchanged.
+// one more token is relexed in case the edit splits a multi-byte codepoint
+static uint32_t first_relexed_token(cortecs_lexer_tokens_t tokens, uint32_t offset) {
+    uint32_t low = 0;
+    uint32_t high = tokens.size;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (tokens.offsets->elements[middle] < offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    // low is the first token at or after the edit
+    return low < 2 ? 0 : low - 2;
+}
+
+cortecs_lexer_relex_t cortecs_lexer_relex(cortecs_lexer_tokens_t tokens, const char *bytes, uint32_t length, cortecs_lexer_edit_t edit) {
+    uint32_t start = first_relexed_token(tokens, edit.offset);
+    uint32_t offset = start < tokens.size ? tokens.offsets->elements[start] : 0;
+    uint32_t old_length = length + edit.removed - edit.inserted;
+    uint32_t edit_end = edit.offset + edit.inserted;
+
+    token_columns_t columns = {.size = 0, .capacity = 0};
+    grow_columns(&columns, RELEX_CAPACITY);
+
+    // relex until a new token ends where an old token after the edit starts.
+    // lexing is restartable at any token boundary so the rest of the old tokens are unchanged
+    lexer_state_t state = tokenize_state(bytes, length, offset);
+    uint32_t old_index = start;
+    while (lex_into(&state, &columns)) {
+        if (state.offset < edit_end) {
+            continue;
+        }
+
+        uint32_t old_offset = state.offset - edit.inserted + edit.removed;
+        while (old_index < tokens.size && tokens.offsets->elements[old_index] < old_offset) {
+            old_index++;
+        }
+        if (old_index < tokens.size && tokens.offsets->elements[old_index] == old_offset) {
+            break;
+        }
+    }
+
+    // the end of the input resynchronizes with the end of the old tokens
+    if (state.offset >= state.length) {
+        assert(state.offset - edit.inserted + edit.removed == old_length);
+        old_index = tokens.size;
+    }
+
+    return (cortecs_lexer_relex_t){
+        .start = start,
+        .removed = old_index - start,
+        .inserted = finish_columns(&columns),
+    };
+}
+
+static void copy_tokens(cortecs_lexer_tokens_t to, uint32_t to_index, cortecs_lexer_tokens_t from, uint32_t from_index, uint32_t size) {
+    memcpy(to.tags->elements + to_index, from.tags->elements + from_index, size * sizeof(uint8_t));
+    memcpy(to.offsets->elements + to_index, from.offsets->elements + from_index, size * sizeof(uint32_t));
+    memcpy(to.lengths->elements + to_index, from.lengths->elements + from_index, size * sizeof(uint32_t));
+    memcpy(to.lines->elements + to_index, from.lines->elements + from_index, size * sizeof(uint32_t));
+    memcpy(to.columns->elements + to_index, from.columns->elements + from_index, size * sizeof(uint32_t));
+}
+
+cortecs_lexer_tokens_t cortecs_lexer_tokens_apply(cortecs_lexer_tokens_t tokens, cortecs_lexer_relex_t relex, cortecs_lexer_edit_t edit) {
+    uint32_t suffix_start = relex.start + relex.removed;
+    uint32_t suffix_size = tokens.size - suffix_start;
+    cortecs_lexer_tokens_t result = alloc_tokens(relex.start + relex.inserted.size + suffix_size);
+    copy_tokens(result, 0, tokens, 0, relex.start);
+    copy_tokens(result, relex.start, relex.inserted, 0, relex.inserted.size);
+
+    uint32_t result_index = relex.start + relex.inserted.size;
+    copy_tokens(result, result_index, tokens, suffix_start, suffix_size);
+    // unsigned arithmetic wraps so this also moves tokens back when the edit removed bytes
+    uint32_t shift = edit.inserted - edit.removed;
+    for (uint32_t i = result_index; i < result.size; i++) {
+        result.offsets->elements[i] += shift;
+    }
+    return result;
+}
+
+// most tokens fit without growing the partial token
+#define STREAM_TEXT_CAPACITY 64
+
+void cortecs_lexer_stream_init(cortecs_lexer_stream_t *stream, cortecs_lexer_config_t config) {
+    *stream = (cortecs_lexer_stream_t){
+        .config = config,
+        .chunk = NULL,
+        .chunk_length = 0,
+        .chunk_offset = 0,
+        .split_length = 0,
+        .is_finished = false,
+        .state = DFA_START,
+        .start = 0,
+        .offset = 0,
+        .num_codepoints = 0,
+        .text = malloc(STREAM_TEXT_CAPACITY),
+        .text_length = 0,
+        .text_capacity = STREAM_TEXT_CAPACITY,
+    };
+}
+
+void cortecs_lexer_stream_cleanup(cortecs_lexer_stream_t *stream) {
+    free(stream->text);
+    stream->text = NULL;
+}
+
+void cortecs_lexer_stream_push(cortecs_lexer_stream_t *stream, const char *chunk, uint32_t length) {
+    stream->chunk = (const uint8_t *)chunk;
+    stream->chunk_length = chunk == NULL ? 0 : length;
+    stream->chunk_offset = 0;
+}
+
+void cortecs_lexer_stream_finish(cortecs_lexer_stream_t *stream) {
+    stream->is_finished = true;
+}
+
+// decodes the next codepoint without consuming it. returns false when more input is needed.
+// a sequence at the end of the input is only decoded once it can't be continued by the next
+// chunk so it decodes exactly like it does in the whole input
+static bool stream_peek(cortecs_lexer_stream_t *stream, UChar32 *codepoint, int32_t *width) {
+    if (stream->split_length == 0 && stream->chunk_offset < stream->chunk_length && stream->chunk[stream->chunk_offset] < 0x80) {
+        *codepoint = stream->chunk[stream->chunk_offset];
+        *width = 1;
+        return true;
+    }
+
+    uint8_t bytes[4];
+    int32_t length = 0;
+    for (uint32_t i = 0; i < stream->split_length; i++) {
+        bytes[length] = stream->split[i];
+        length++;
+    }
+    for (uint32_t i = stream->chunk_offset; i < stream->chunk_length && length < 4; i++) {
+        bytes[length] = stream->chunk[i];
+        length++;
+    }
+    if (length == 0) {
+        return false;
+    }
+
+    *width = 0;
+    U8_NEXT(bytes, *width, length, *codepoint);
+    if (*codepoint < 0 && *width == length && length < 4 && !stream->is_finished) {
+        // the sequence is truncated by the end of the chunk. the chunk's bytes move to split
+        // so the chunk doesn't have to outlive this call
+        memcpy(stream->split, bytes, length);
+        stream->split_length = length;
+        stream->chunk_offset = stream->chunk_length;
+        return false;
+    }
+
+    if (*codepoint < 0) {
+        // matches U8_NEXT_OR_FFFD in the other lexers
+        *codepoint = 0xFFFD;
+    }
+    return true;
+}
+
+static void stream_consume(cortecs_lexer_stream_t *stream, UChar32 codepoint, int32_t width) {
+    uint32_t from_split = (uint32_t)width < stream->split_length ? (uint32_t)width : stream->split_length;
+    memmove(stream->split, stream->split + from_split, stream->split_length - from_split);
+    stream->split_length -= from_split;
+    stream->chunk_offset += width - from_split;
+    stream->offset += width;
+    stream->num_codepoints++;
+
+    if (stream->text_length + U8_MAX_LENGTH > stream->text_capacity) {
+        stream->text_capacity *= 2;
+        stream->text = realloc(stream->text, stream->text_capacity);
+    }
+    U8_APPEND_UNSAFE(stream->text, stream->text_length, codepoint);
+}
+
+static cortecs_lexer_token_t stream_token(cortecs_lexer_stream_t *stream) {
+    cortecs_lexer_tag_t tag = dfa_tags[stream->state];
+    cortecs_lexer_token_t token = {
+        .tag = tag,
+        .span = {.lines = 0, .columns = stream->num_codepoints},
+        .offset = stream->start,
+        .length = stream->offset - stream->start,
+        .text = {.content = NULL},
+        .symbol = {.entry = NULL},
+    };
+    if (tag == CORTECS_LEXER_TAG_NEW_LINE) {
+        token.span = (cortecs_span_t){.lines = 1, .columns = 0};
+    }
+    if (tag == CORTECS_LEXER_TAG_NAME) {
+        token.tag = keyword_tag(stream->text, stream->text_length);
+    }
+
+    if (stream->config.intern_names && (token.tag == CORTECS_LEXER_TAG_NAME || token.tag == CORTECS_LEXER_TAG_TYPE)) {
+        token.symbol = CN(Cortecs, Symbol, intern)(stream->text, stream->text_length);
+    } else if (!stream->config.lazy_text) {
+        token.text = CN(Cortecs, String, from_bytes)(stream->text, stream->text_length);
+    }
+
+    stream->state = DFA_START;
+    stream->start = stream->offset;
+    stream->num_codepoints = 0;
+    stream->text_length = 0;
+    return token;
+}
+
+bool cortecs_lexer_stream_next(cortecs_lexer_stream_t *stream, cortecs_lexer_token_t *token) {
+    while (true) {
+        UChar32 codepoint;
+        int32_t width;
+        if (!stream_peek(stream, &codepoint, &width)) {
+            // the partial token ends with the input
+            if (!stream->is_finished || stream->state == DFA_START) {
+                return false;
             }
+            *token = stream_token(stream);
+            return true;
+        }
 
-            return lex_invalid(&state);
+        uint8_t class = is_ascii(codepoint) ? dfa_ascii_classes[codepoint] : dfa_unicode_classes[class_of(codepoint)];
+        uint32_t next_state = dfa_transitions[stream->state][class];
+        if (next_state == DFA_STOP) {
+            // the codepoint starts the next token
+            *token = stream_token(stream);
+            return true;
         }
+
+        stream->state = next_state;
+        stream_consume(stream, codepoint, width);
     }
 }
\ No newline at end of file
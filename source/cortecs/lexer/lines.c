@@ -0,0 +1,104 @@
+#include <cortecs/gc.h>
+#include <cortecs/kernel.h>
+#include <cortecs/lines.h>
+#include <cortecs/tokens.h>
+#include <stdint.h>
+#include <string.h>
+#include <unicode/utf8.h>
+
+static cortecs_lexer_lines_t alloc_lines(uint32_t size) {
+    cortecs_lexer_lines_t lines = {
+        .size = size,
+        .starts = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+    };
+    lines.starts->elements[0] = 0;
+    return lines;
+}
+
+cortecs_lexer_lines_t cortecs_lexer_lines_of(const char *bytes, uint32_t length) {
+    if (bytes == NULL) {
+        return alloc_lines(1);
+    }
+
+    cortecs_lexer_lines_t lines = alloc_lines(CN(Cortecs, Kernel, count_lines)(bytes, length).newlines + 1);
+    uint32_t offset = 0;
+    for (uint32_t i = 1; i < lines.size; i++) {
+        const char *newline = memchr(bytes + offset, '\n', length - offset);
+        offset = (uint32_t)(newline - bytes) + 1;
+        lines.starts->elements[i] = offset;
+    }
+    return lines;
+}
+
+cortecs_lexer_lines_t cortecs_lexer_tokens_lines(cortecs_lexer_tokens_t tokens) {
+    uint32_t newlines = 0;
+    for (uint32_t i = 0; i < tokens.size; i++) {
+        newlines += tokens.tags->elements[i] == CORTECS_LEXER_TAG_NEW_LINE;
+    }
+
+    cortecs_lexer_lines_t lines = alloc_lines(newlines + 1);
+    uint32_t line = 1;
+    for (uint32_t i = 0; i < tokens.size; i++) {
+        if (tokens.tags->elements[i] == CORTECS_LEXER_TAG_NEW_LINE) {
+            lines.starts->elements[line] = tokens.offsets->elements[i] + 1;
+            line++;
+        }
+    }
+    return lines;
+}
+
+uint32_t cortecs_lexer_lines_line_of(cortecs_lexer_lines_t lines, uint32_t offset) {
+    // the first line that starts after offset
+    uint32_t low = 1;
+    uint32_t high = lines.size;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (lines.starts->elements[middle] <= offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low - 1;
+}
+
+// where the line's newline is or the end of the source on the last line
+static uint32_t line_end(cortecs_lexer_lines_t lines, uint32_t length, uint32_t line) {
+    if (line + 1 < lines.size) {
+        return lines.starts->elements[line + 1] - 1;
+    }
+    return length;
+}
+
+cortecs_span_t cortecs_lexer_lines_position(cortecs_lexer_lines_t lines, const char *bytes, uint32_t length, uint32_t offset) {
+    uint32_t line = cortecs_lexer_lines_line_of(lines, offset);
+    uint32_t end = offset < length ? offset : length;
+    uint32_t index = lines.starts->elements[line];
+
+    // ill-formed sequences are one column each like the U+FFFD the lexer replaces them with
+    uint32_t columns = 0;
+    while (index < end) {
+        UChar32 codepoint;
+        U8_NEXT_OR_FFFD(bytes, index, length, codepoint);
+        columns++;
+    }
+
+    return (cortecs_span_t){
+        .lines = line,
+        .columns = columns,
+    };
+}
+
+uint32_t cortecs_lexer_lines_offset(cortecs_lexer_lines_t lines, const char *bytes, uint32_t length, cortecs_span_t position) {
+    if (position.lines >= lines.size) {
+        return length;
+    }
+
+    uint32_t end = line_end(lines, length, position.lines);
+    uint32_t index = lines.starts->elements[position.lines];
+    for (uint32_t i = 0; i < position.columns && index < end; i++) {
+        UChar32 codepoint;
+        U8_NEXT_OR_FFFD(bytes, index, end, codepoint);
+    }
+    return index;
+}
\ No newline at end of file
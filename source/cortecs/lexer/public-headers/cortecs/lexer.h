@@ -2,9 +2,91 @@
 #define CORTECS_LEXER_LEXER_H
 
 #include <cortecs/tokens.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <unicode/utext.h>
 
+typedef struct {
+    // NAME and TYPE tokens are interned into the symbol table.
+    // their text isn't allocated and the symbol must be used instead.
+    // requires the symbol table to be initialized
+    bool intern_names;
+    // tokens don't carry their text. it's materialized from the source on request
+    // with cortecs_lexer_token_text or cortecs_lexer_token_slice
+    bool lazy_text;
+} cortecs_lexer_config_t;
+
 cortecs_lexer_token_t cortecs_lexer_next(UText *text);
+cortecs_lexer_token_t cortecs_lexer_next_with_config(UText *text, cortecs_lexer_config_t config);
+
+// lexes utf-8 bytes directly starting at offset and advances offset past the token.
+// produces the same tokens as lexing a UText opened over the same bytes
+cortecs_lexer_token_t cortecs_lexer_next_utf8(const char *bytes, uint32_t length, uint32_t *offset);
+cortecs_lexer_token_t cortecs_lexer_next_utf8_with_config(const char *bytes, uint32_t length, uint32_t *offset, cortecs_lexer_config_t config);
+
+// lexes all of the utf-8 bytes into columns. the tokens don't carry their text or symbols.
+// the end of input isn't included
+cortecs_lexer_tokens_t cortecs_lexer_tokenize(const char *bytes, uint32_t length);
+// produces the same tokens as cortecs_lexer_tokenize by lexing chunks that end at newlines on their own threads.
+// num_threads of 0 uses a thread per cpu and doesn't split small inputs.
+// falls back to lexing serially when a token crosses the end of a chunk
+cortecs_lexer_tokens_t cortecs_lexer_tokenize_parallel(const char *bytes, uint32_t length, uint32_t num_threads);
+
+// removed bytes at offset were replaced with inserted bytes
+typedef struct {
+    uint32_t offset;
+    uint32_t removed;
+    uint32_t inserted;
+} cortecs_lexer_edit_t;
+
+// the old tokens [start, start + removed) are replaced by the inserted tokens.
+// the tokens after them are unchanged except their offsets move by the change in length
+typedef struct {
+    uint32_t start;
+    uint32_t removed;
+    cortecs_lexer_tokens_t inserted;
+} cortecs_lexer_relex_t;
+
+// relexes the tokens that an edit can change. bytes is the source after the edit.
+// only the tokens around the edit are lexed so it doesn't depend on the size of the file
+cortecs_lexer_relex_t cortecs_lexer_relex(cortecs_lexer_tokens_t tokens, const char *bytes, uint32_t length, cortecs_lexer_edit_t edit);
+// the tokens of the source after the edit. copies every token so it's linear in the size of the file
+cortecs_lexer_tokens_t cortecs_lexer_tokens_apply(cortecs_lexer_tokens_t tokens, cortecs_lexer_relex_t relex, cortecs_lexer_edit_t edit);
+
+// lexes input that arrives in chunks of any size such as reads from a pipe or buffers from a client.
+// only the partial token at the end of a chunk is held so memory doesn't grow with the input.
+// produces the same tokens as cortecs_lexer_next_utf8 over the whole input however it's split.
+// the fields are private
+typedef struct {
+    cortecs_lexer_config_t config;
+    // the chunk being lexed. it's only read until next asks for more input
+    const uint8_t *chunk;
+    uint32_t chunk_length;
+    uint32_t chunk_offset;
+    // the bytes of a codepoint split at the end of the last chunk
+    uint8_t split[4];
+    uint32_t split_length;
+    bool is_finished;
+
+    // the partial token
+    uint32_t state;
+    uint32_t start;
+    uint32_t offset;
+    uint32_t num_codepoints;
+    // the token's codepoints with ill-formed sequences replaced by U+FFFD
+    char *text;
+    uint32_t text_length;
+    uint32_t text_capacity;
+} cortecs_lexer_stream_t;
+
+void cortecs_lexer_stream_init(cortecs_lexer_stream_t *stream, cortecs_lexer_config_t config);
+void cortecs_lexer_stream_cleanup(cortecs_lexer_stream_t *stream);
+// the next chunk of the input. call once next returns false
+void cortecs_lexer_stream_push(cortecs_lexer_stream_t *stream, const char *chunk, uint32_t length);
+// there's no more input. next returns the partial token
+void cortecs_lexer_stream_finish(cortecs_lexer_stream_t *stream);
+// true with the next complete token. false when the chunk is used up and more input is needed,
+// or after the last token once the stream is finished. offsets count bytes from the start of the stream
+bool cortecs_lexer_stream_next(cortecs_lexer_stream_t *stream, cortecs_lexer_token_t *token);
 
 #endif
\ No newline at end of file
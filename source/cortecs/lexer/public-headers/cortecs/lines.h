@@ -0,0 +1,29 @@
+#ifndef CORTECS_LEXER_LINES_H
+#define CORTECS_LEXER_LINES_H
+
+#include <cortecs/span.h>
+#include <cortecs/tokens.h>
+#include <stdint.h>
+
+// the byte offset where each line of a source starts so that converting between
+// offsets and positions is a binary search instead of adding up spans from the start
+typedef struct {
+    // a source without newlines has one line
+    uint32_t size;
+    // the first line starts at 0. every other line starts after a newline
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) starts;
+} cortecs_lexer_lines_t;
+
+// scans the source for newlines
+cortecs_lexer_lines_t cortecs_lexer_lines_of(const char *bytes, uint32_t length);
+// the lines of the source the tokens were lexed from. newlines are always tokens of their own so the source isn't scanned again
+cortecs_lexer_lines_t cortecs_lexer_tokens_lines(cortecs_lexer_tokens_t tokens);
+
+// the index of the line containing offset. a newline is on the line it ends
+uint32_t cortecs_lexer_lines_line_of(cortecs_lexer_lines_t lines, uint32_t offset);
+// the span from the start of the source to offset. columns count codepoints like the lexer's spans
+cortecs_span_t cortecs_lexer_lines_position(cortecs_lexer_lines_t lines, const char *bytes, uint32_t length, uint32_t offset);
+// the offset of the position. columns past the end of a line stop at its newline and lines past the last line stop at the end of the source
+uint32_t cortecs_lexer_lines_offset(cortecs_lexer_lines_t lines, const char *bytes, uint32_t length, cortecs_span_t position);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef CORTECS_LEXER_SOURCE_H
+#define CORTECS_LEXER_SOURCE_H
+
+#include <cortecs/finalizer.h>
+#include <cortecs/mangle.h>
+#include <cortecs/string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unicode/utext.h>
+
+// A source file mapped read-only into memory. the pages are loaded by the
+// kernel as they're lexed and the file is unmapped when the gc collects it.
+// tokens, slices and UTexts point into bytes so the source must be kept alive while they're used
+typedef struct {
+    const char *bytes;
+    uint32_t length;
+    // 0 when the file is empty and nothing was mapped
+    size_t mapped_length;
+} cortecs_lexer_source_t;
+
+#define TYPE_PARAM_T cortecs_lexer_source_t
+#include <cortecs/array.template.h>
+#include <cortecs/ptr.template.h>
+#undef TYPE_PARAM_T
+
+extern cortecs_finalizer_declare(cortecs_lexer_source_t);
+
+void cortecs_lexer_source_init();
+// returns NULL when the file can't be opened or mapped or is too large for 32 bit offsets
+CN(Cortecs, Ptr, CT(cortecs_lexer_source_t)) cortecs_lexer_source_open(CN(Cortecs, String) path);
+// opens a UText over the mapped bytes without copying them. follows the conventions of utext_openUTF8
+UText *cortecs_lexer_source_utext(CN(Cortecs, Ptr, CT(cortecs_lexer_source_t)) source, UText *text, UErrorCode *status);
+
+#endif
\ No newline at end of file
@@ -11,8 +11,12 @@ typedef struct {
 } cortecs_span_t;
 extern ECS_COMPONENT_DECLARE(cortecs_span_t);
 
+// registers the component. call after the world is initialized
+void cortecs_span_init(void);
+
 int cortecs_span_compare(cortecs_span_t left, cortecs_span_t right);
 cortecs_span_t cortecs_span_of(CN(Cortecs, String) text);
+cortecs_span_t cortecs_span_of_slice(CN(Cortecs, String, Slice) text);
 cortecs_span_t cortecs_span_add(cortecs_span_t left, cortecs_span_t right);
 
 #endif
\ No newline at end of file
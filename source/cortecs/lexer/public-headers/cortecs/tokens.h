@@ -3,6 +3,7 @@
 
 #include <cortecs/span.h>
 #include <cortecs/string.h>
+#include <cortecs/symbol.h>
 #include <unicode/uchar.h>
 
 typedef enum {
@@ -46,9 +47,36 @@ typedef enum {
 typedef struct {
     cortecs_lexer_tag_t tag;
     cortecs_span_t span;
+    // where the token is in the source. bytes for utf-8 and native indexes for a UText
+    uint32_t offset;
+    uint32_t length;
     CN(Cortecs, String) text;
+    // only set for NAME and TYPE tokens when the lexer interns names
+    CN(Cortecs, Symbol) symbol;
 } cortecs_lexer_token_t;
 
+// a whole file of tokens stored by column. each column is a single gc allocation
+// of size elements. the tags are the cortecs_lexer_tag_t of each token narrowed to a byte.
+// offsets and lengths are bytes in the source. lines and columns are the token's span
+typedef struct {
+    uint32_t size;
+    CN(Cortecs, Array, CT(CN(Cortecs, U8))) tags;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) offsets;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) lengths;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) lines;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) columns;
+} cortecs_lexer_tokens_t;
+
 const char *cortecs_lexer_tag_to_string(cortecs_lexer_tag_t tag);
+// the token's text or a copy of its bytes in the utf-8 source when it was lexed with lazy_text.
+// ill-formed sequences are copied as is rather than replaced with U+FFFD
+CN(Cortecs, String) cortecs_lexer_token_text(cortecs_lexer_token_t token, const char *source);
+// the token's bytes in the source without copying them
+CN(Cortecs, String, Slice) cortecs_lexer_token_slice(cortecs_lexer_token_t token, CN(Cortecs, String) source);
+
+// the token at index without its text
+cortecs_lexer_token_t cortecs_lexer_tokens_get(cortecs_lexer_tokens_t tokens, uint32_t index);
+// the index of the first token at or after index that isn't SPACE or NEW_LINE or size when there isn't one
+uint32_t cortecs_lexer_tokens_skip_whitespace(cortecs_lexer_tokens_t tokens, uint32_t index);
 
 #endif
\ No newline at end of file
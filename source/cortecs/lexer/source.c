@@ -0,0 +1,59 @@
+#include <cortecs/gc.h>
+#include <cortecs/source.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+cortecs_finalizer_declare(cortecs_lexer_source_t);
+void cortecs_finalizer(cortecs_lexer_source_t)(void *allocation) {
+    cortecs_lexer_source_t source = *(CN(Cortecs, Ptr, CT(cortecs_lexer_source_t)))allocation;
+    if (source.mapped_length > 0) {
+        munmap((void *)source.bytes, source.mapped_length);
+    }
+}
+
+void cortecs_lexer_source_init() {
+    cortecs_finalizer_register(cortecs_lexer_source_t);
+}
+
+CN(Cortecs, Ptr, CT(cortecs_lexer_source_t)) cortecs_lexer_source_open(CN(Cortecs, String) path) {
+    int file = open(CN(Cortecs, String, cstr)(&path), O_RDONLY);
+    if (file < 0) {
+        return NULL;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode) || (uint64_t)status.st_size > UINT32_MAX) {
+        close(file);
+        return NULL;
+    }
+
+    // mmap can't map an empty file
+    const char *bytes = "";
+    size_t mapped_length = status.st_size;
+    if (mapped_length > 0) {
+        void *mapping = mmap(NULL, mapped_length, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) {
+            close(file);
+            return NULL;
+        }
+
+        // the lexer reads front to back so the kernel can read ahead and drop pages behind it
+        madvise(mapping, mapped_length, MADV_SEQUENTIAL);
+        bytes = mapping;
+    }
+
+    // the mapping keeps the file alive
+    close(file);
+
+    CN(Cortecs, Ptr, CT(cortecs_lexer_source_t)) source = cortecs_gc_alloc(cortecs_lexer_source_t);
+    source->bytes = bytes;
+    source->length = (uint32_t)mapped_length;
+    source->mapped_length = mapped_length;
+    return source;
+}
+
+UText *cortecs_lexer_source_utext(CN(Cortecs, Ptr, CT(cortecs_lexer_source_t)) source, UText *text, UErrorCode *status) {
+    return utext_openUTF8(text, source->bytes, source->length, status);
+}
\ No newline at end of file
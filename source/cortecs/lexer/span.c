@@ -1,4 +1,13 @@
+#include <cortecs/kernel.h>
 #include <cortecs/span.h>
+#include <cortecs/world.h>
+#include <string.h>
+
+ECS_COMPONENT_DECLARE(cortecs_span_t);
+
+void cortecs_span_init(void) {
+    ECS_COMPONENT_DEFINE(world, cortecs_span_t);
+}
 
 int cortecs_span_compare(cortecs_span_t left, cortecs_span_t right) {
     if (left.lines < right.lines) {
@@ -34,34 +43,35 @@ cortecs_span_t cortecs_span_add(cortecs_span_t left, cortecs_span_t right) {
     };
 }
 
+// columns count codepoints to match the lexer
+static cortecs_span_t span_of_bytes(const char *bytes, uint32_t length) {
+    CN(Cortecs, Kernel, Lines) lines = CN(Cortecs, Kernel, count_lines)(bytes, length);
+    return (cortecs_span_t){
+        .lines = lines.newlines,
+        .columns = lines.columns,
+    };
+}
+
 cortecs_span_t cortecs_span_of(CN(Cortecs, String) text) {
-    if (text.content == NULL) {
+    if (CN(Cortecs, String, is_null)(text)) {
         return (cortecs_span_t){
             .lines = 0,
             .columns = 0,
         };
     }
 
-    cortecs_span_t out = {
-        .lines = 0,
-        .columns = 0,
-    };
-
-    uint32_t capacity = CN(Cortecs, String, capacity)(text);
-    for (uint32_t i = 0; i < capacity; i++) {
-        uint8_t current_char = text.content->elements[i];
-        if (current_char == 0) {
-            break;
-        }
-
-        if (current_char == '\n') {
-            out.columns = 0;
-            out.lines++;
-            continue;
-        }
+    // the text ends at the first null like any other c string. capacity includes the null terminator
+    const char *bytes = CN(Cortecs, String, cstr)(&text);
+    return span_of_bytes(bytes, strnlen(bytes, CN(Cortecs, String, capacity)(text) - 1));
+}
 
-        out.columns++;
+cortecs_span_t cortecs_span_of_slice(CN(Cortecs, String, Slice) text) {
+    if (text.content == NULL) {
+        return (cortecs_span_t){
+            .lines = 0,
+            .columns = 0,
+        };
     }
 
-    return out;
+    return span_of_bytes(CN(Cortecs, String, Slice, bytes)(text), text.length);
 }
\ No newline at end of file
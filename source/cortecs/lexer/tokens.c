@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <cortecs/kernel.h>
 #include <cortecs/tokens.h>
 #include <stdbool.h>
 
@@ -60,4 +61,42 @@ const char *cortecs_lexer_tag_to_string(cortecs_lexer_tag_t tag) {
             return "invalid";
     }
     return "unknown";
+}
+
+CN(Cortecs, String) cortecs_lexer_token_text(cortecs_lexer_token_t token, const char *source) {
+    if (!CN(Cortecs, String, is_null)(token.text)) {
+        return token.text;
+    }
+
+    // the end of the input has no text
+    if (token.length == 0) {
+        return (CN(Cortecs, String)){.content = NULL};
+    }
+
+    return CN(Cortecs, String, from_bytes)(source + token.offset, token.length);
+}
+
+CN(Cortecs, String, Slice) cortecs_lexer_token_slice(cortecs_lexer_token_t token, CN(Cortecs, String) source) {
+    return CN(Cortecs, String, slice)(source, token.offset, token.length);
+}
+
+cortecs_lexer_token_t cortecs_lexer_tokens_get(cortecs_lexer_tokens_t tokens, uint32_t index) {
+    assert(index < tokens.size);
+    return (cortecs_lexer_token_t){
+        .tag = tokens.tags->elements[index],
+        .span = {
+            .lines = tokens.lines->elements[index],
+            .columns = tokens.columns->elements[index],
+        },
+        .offset = tokens.offsets->elements[index],
+        .length = tokens.lengths->elements[index],
+        .text = {.content = NULL},
+        .symbol = {.entry = NULL},
+    };
+}
+
+uint32_t cortecs_lexer_tokens_skip_whitespace(cortecs_lexer_tokens_t tokens, uint32_t index) {
+    assert(index <= tokens.size);
+    const uint8_t *tags = tokens.tags->elements + index;
+    return index + CN(Cortecs, Kernel, skip_either)(tags, tokens.size - index, CORTECS_LEXER_TAG_SPACE, CORTECS_LEXER_TAG_NEW_LINE);
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unicode/uchar.h>
+
+#include "source/cortecs/lexer/classes.h"
+
+// Generates unicode_classes.h: the lexer's character classes for every codepoint
+// from the ICU properties that the lexer used to query per codepoint.
+// Run by the unicode_classes genrule in BUILD.
+//
+// The table has two stages. The codepoint's high bits index a block and the low
+// bits index the class in the block. Identical blocks are stored once. Most of
+// the codespace is unassigned so the tables are around 30KiB.
+
+#define NUM_CODEPOINTS 0x110000
+#define MIN_SHIFT 4
+#define MAX_SHIFT 10
+
+static uint8_t classes[NUM_CODEPOINTS];
+
+static uint8_t classify(UChar32 codepoint) {
+    uint8_t class = 0;
+    if (u_isalpha(codepoint)) {
+        class |= CLASS_ALPHA;
+    }
+    if (u_isdigit(codepoint)) {
+        class |= CLASS_DIGIT;
+    }
+    if (u_isupper(codepoint)) {
+        class |= CLASS_UPPER;
+    }
+    if (u_isalnum(codepoint)) {
+        class |= CLASS_NAME;
+    }
+    return class;
+}
+
+typedef struct {
+    uint32_t shift;
+    uint32_t num_blocks;
+    // the block of each group of 1 << shift codepoints
+    uint32_t *index;
+    // the first codepoint of each unique block
+    uint32_t *block_starts;
+} stages_t;
+
+static stages_t build_stages(uint32_t shift) {
+    uint32_t block_size = 1 << shift;
+    uint32_t num_groups = NUM_CODEPOINTS >> shift;
+    stages_t stages = {
+        .shift = shift,
+        .num_blocks = 0,
+        .index = malloc(num_groups * sizeof(uint32_t)),
+        .block_starts = malloc(num_groups * sizeof(uint32_t)),
+    };
+
+    for (uint32_t group = 0; group < num_groups; group++) {
+        uint32_t start = group << shift;
+        uint32_t block = 0;
+        while (block < stages.num_blocks && memcmp(classes + stages.block_starts[block], classes + start, block_size) != 0) {
+            block++;
+        }
+        if (block == stages.num_blocks) {
+            stages.block_starts[block] = start;
+            stages.num_blocks++;
+        }
+        stages.index[group] = block;
+    }
+    return stages;
+}
+
+static uint32_t index_width(stages_t stages) {
+    return stages.num_blocks <= UINT8_MAX + 1 ? 1 : 2;
+}
+
+static uint32_t stages_size(stages_t stages) {
+    return (NUM_CODEPOINTS >> stages.shift) * index_width(stages) + (stages.num_blocks << stages.shift);
+}
+
+int main() {
+    for (UChar32 codepoint = 0; codepoint < NUM_CODEPOINTS; codepoint++) {
+        classes[codepoint] = classify(codepoint);
+    }
+
+    stages_t best = build_stages(MIN_SHIFT);
+    for (uint32_t shift = MIN_SHIFT + 1; shift <= MAX_SHIFT; shift++) {
+        stages_t stages = build_stages(shift);
+        if (stages_size(stages) < stages_size(best)) {
+            free(best.index);
+            free(best.block_starts);
+            best = stages;
+            continue;
+        }
+        free(stages.index);
+        free(stages.block_starts);
+    }
+
+    uint32_t block_size = 1 << best.shift;
+    uint32_t num_groups = NUM_CODEPOINTS >> best.shift;
+    printf("// generated by source/cortecs/lexer/unicode_classes_gen.c from ICU %s. do not edit\n", U_UNICODE_VERSION);
+    printf("#ifndef CORTECS_LEXER_UNICODE_CLASSES_H\n");
+    printf("#define CORTECS_LEXER_UNICODE_CLASSES_H\n");
+    printf("\n");
+    printf("#include <stdint.h>\n");
+    printf("\n");
+    printf("#define UNICODE_CLASSES_SHIFT %u\n", best.shift);
+    printf("#define UNICODE_CLASSES_MASK %u\n", block_size - 1);
+    printf("#define UNICODE_CLASSES_SIZE %u\n", stages_size(best));
+    printf("\n");
+    printf("static const %s unicode_class_index[%u] = {", index_width(best) == 1 ? "uint8_t" : "uint16_t", num_groups);
+    for (uint32_t group = 0; group < num_groups; group++) {
+        printf("%s%u,", group % 32 == 0 ? "\n    " : " ", best.index[group]);
+    }
+    printf("\n};\n");
+    printf("\n");
+    printf("static const uint8_t unicode_class_blocks[%u] = {", best.num_blocks << best.shift);
+    for (uint32_t block = 0; block < best.num_blocks; block++) {
+        for (uint32_t i = 0; i < block_size; i++) {
+            printf("%s%u,", i % 32 == 0 ? "\n    " : " ", classes[best.block_starts[block] + i]);
+        }
+    }
+    printf("\n};\n");
+    printf("\n");
+    printf("#endif\n");
+
+    free(best.index);
+    free(best.block_starts);
+    return 0;
+}
\ No newline at end of file
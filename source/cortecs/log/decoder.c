@@ -0,0 +1,255 @@
+#include <cortecs/log.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// lengths and ids up to these are trusted. bigger ones are checked against the file so a
+// corrupt segment can't make the decoder allocate more than the file could hold
+#define MAX_UNCHECKED_LENGTH 4096
+#define MAX_UNCHECKED_ID 4096
+// the limits when the file isn't a regular file and its size is unknown
+#define MAX_STREAMED_LENGTH (1 << 30)
+#define MAX_STREAMED_ID (1 << 24)
+
+static bool read_varint(FILE *file, uint64_t *out) {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        int byte = fgetc(file);
+        if (byte == EOF) {
+            return false;
+        }
+
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *out = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// UINT64_MAX when the file isn't a regular file
+static uint64_t file_size(FILE *file) {
+    struct stat status;
+    if (fstat(fileno(file), &status) != 0 || !S_ISREG(status.st_mode)) {
+        return UINT64_MAX;
+    }
+    return (uint64_t)status.st_size;
+}
+
+static char *read_bytes(FILE *file, uint64_t length) {
+    if (length > MAX_UNCHECKED_LENGTH) {
+        uint64_t size = file_size(file);
+        long position = ftell(file);
+        uint64_t remaining = MAX_STREAMED_LENGTH;
+        if (size != UINT64_MAX && position >= 0) {
+            remaining = (uint64_t)position < size ? size - (uint64_t)position : 0;
+        }
+        if (length > remaining) {
+            return NULL;
+        }
+    }
+
+    char *bytes = malloc(length + 1);
+    if (bytes == NULL) {
+        return NULL;
+    }
+    if (fread(bytes, 1, length, file) != length) {
+        free(bytes);
+        return NULL;
+    }
+    bytes[length] = 0;
+    return bytes;
+}
+
+static bool define_string(CN(Cortecs, Log, Decoder) *decoder) {
+    uint64_t id;
+    uint64_t length;
+    if (!read_varint(decoder->file, &id) || !read_varint(decoder->file, &length)) {
+        return false;
+    }
+
+    // ids are handed out in order from 1 and each definition takes at least 3 bytes so an id
+    // can't be bigger than the file
+    if (id > MAX_UNCHECKED_ID) {
+        uint64_t size = file_size(decoder->file);
+        if (id > (size == UINT64_MAX ? MAX_STREAMED_ID : size)) {
+            return false;
+        }
+    }
+
+    if (id >= decoder->strings_capacity) {
+        uint64_t capacity = decoder->strings_capacity == 0 ? 64 : decoder->strings_capacity;
+        while (capacity <= id) {
+            capacity *= 2;
+        }
+        if (capacity > UINT32_MAX) {
+            return false;
+        }
+        char **strings = realloc(decoder->strings, capacity * sizeof(char *));
+        if (strings == NULL) {
+            return false;
+        }
+        memset(strings + decoder->strings_capacity, 0, (capacity - decoder->strings_capacity) * sizeof(char *));
+        decoder->strings = strings;
+        decoder->strings_capacity = (uint32_t)capacity;
+    }
+
+    char *string = read_bytes(decoder->file, length);
+    if (string == NULL) {
+        return false;
+    }
+
+    // appending to an existing segment restarts the ids
+    free(decoder->strings[id]);
+    decoder->strings[id] = string;
+    return true;
+}
+
+static const char *lookup_string(CN(Cortecs, Log, Decoder) *decoder) {
+    uint64_t id;
+    if (!read_varint(decoder->file, &id) || id >= decoder->strings_capacity) {
+        return NULL;
+    }
+    return decoder->strings[id];
+}
+
+static bool decode_field(CN(Cortecs, Log, Decoder) *decoder, cJSON *message) {
+    const char *key = lookup_string(decoder);
+    int tag = fgetc(decoder->file);
+    if (key == NULL || tag == EOF) {
+        return false;
+    }
+
+    switch (tag) {
+        case CORTECS_LOG_VALUE_STRING: {
+            const char *value = lookup_string(decoder);
+            if (value == NULL) {
+                return false;
+            }
+            cJSON_AddStringToObject(message, key, value);
+            return true;
+        }
+        case CORTECS_LOG_VALUE_UINT: {
+            uint64_t value;
+            if (!read_varint(decoder->file, &value)) {
+                return false;
+            }
+            cJSON_AddNumberToObject(message, key, (double)value);
+            return true;
+        }
+        case CORTECS_LOG_VALUE_SINT: {
+            uint64_t value;
+            if (!read_varint(decoder->file, &value)) {
+                return false;
+            }
+            int64_t decoded = (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+            cJSON_AddNumberToObject(message, key, (double)decoded);
+            return true;
+        }
+        case CORTECS_LOG_VALUE_DOUBLE: {
+            uint8_t bytes[sizeof(uint64_t)];
+            if (fread(bytes, 1, sizeof(bytes), decoder->file) != sizeof(bytes)) {
+                return false;
+            }
+            uint64_t bits = 0;
+            for (uint32_t i = 0; i < sizeof(bytes); i++) {
+                bits |= (uint64_t)bytes[i] << (i * 8);
+            }
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            cJSON_AddNumberToObject(message, key, value);
+            return true;
+        }
+        case CORTECS_LOG_VALUE_FALSE: {
+            cJSON_AddBoolToObject(message, key, false);
+            return true;
+        }
+        case CORTECS_LOG_VALUE_TRUE: {
+            cJSON_AddBoolToObject(message, key, true);
+            return true;
+        }
+        case CORTECS_LOG_VALUE_NULL: {
+            cJSON_AddNullToObject(message, key);
+            return true;
+        }
+        case CORTECS_LOG_VALUE_JSON: {
+            uint64_t length;
+            if (!read_varint(decoder->file, &length)) {
+                return false;
+            }
+            char *json = read_bytes(decoder->file, length);
+            if (json == NULL) {
+                return false;
+            }
+            cJSON *value = cJSON_Parse(json);
+            free(json);
+            if (value == NULL) {
+                return false;
+            }
+            cJSON_AddItemToObject(message, key, value);
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+void CN(Cortecs, Log, Decoder, open)(CN(Cortecs, Log, Decoder) *decoder, FILE *file) {
+    decoder->file = file;
+    decoder->strings = NULL;
+    decoder->strings_capacity = 0;
+
+    char magic[CORTECS_LOG_INTERNED_MAGIC_SIZE];
+    size_t read = fread(magic, 1, sizeof(magic), file);
+    if (read != sizeof(magic) || memcmp(magic, CORTECS_LOG_INTERNED_MAGIC, sizeof(magic)) != 0) {
+        // let next report the malformed segment
+        rewind(file);
+    }
+}
+
+cJSON *CN(Cortecs, Log, Decoder, next)(CN(Cortecs, Log, Decoder) *decoder) {
+    while (true) {
+        int tag = fgetc(decoder->file);
+        if (tag == EOF) {
+            return NULL;
+        }
+
+        if (tag == CORTECS_LOG_RECORD_STRING) {
+            if (!define_string(decoder)) {
+                return NULL;
+            }
+            continue;
+        }
+
+        if (tag != CORTECS_LOG_RECORD_MESSAGE) {
+            return NULL;
+        }
+
+        uint64_t num_fields;
+        if (!read_varint(decoder->file, &num_fields)) {
+            return NULL;
+        }
+
+        cJSON *message = cJSON_CreateObject();
+        for (uint64_t i = 0; i < num_fields; i++) {
+            if (!decode_field(decoder, message)) {
+                cJSON_Delete(message);
+                return NULL;
+            }
+        }
+        return message;
+    }
+}
+
+void CN(Cortecs, Log, Decoder, close)(CN(Cortecs, Log, Decoder) *decoder) {
+    for (uint32_t i = 0; i < decoder->strings_capacity; i++) {
+        free(decoder->strings[i]);
+    }
+    free(decoder->strings);
+    decoder->strings = NULL;
+    decoder->strings_capacity = 0;
+}
\ No newline at end of file
@@ -1,34 +1,518 @@
 #include <cortecs/gc.h>
 #include <cortecs/log.h>
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 cortecs_finalizer_declare(CN(Cortecs, Log));
 void cortecs_finalizer(CN(Cortecs, Log))(void *allocation) {
     CN(Cortecs, Log) log_stream = *(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))))allocation;
-    fclose(log_stream.log_file);
+    if (log_stream.has_rotation_worker) {
+        pthread_join(log_stream.rotation_worker, NULL);
+    }
+    if (log_stream.log_file != NULL) {
+        fclose(log_stream.log_file);
+    }
+    free(log_stream.path);
+
+    for (uint32_t i = 0; i < log_stream.interned_capacity; i++) {
+        free(log_stream.interned[i].string);
+    }
+    free(log_stream.interned);
+    free(log_stream.record);
 }
 
 void CN(Cortecs, Log, init)() {
     cortecs_finalizer_register(CN(Cortecs, Log));
 }
 
-CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) CN(Cortecs, Log, open)(CN(Cortecs, String) path) {
-    CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream = cortecs_gc_alloc(CN(Cortecs, Log));
-    log_stream->log_file = fopen(path.content->elements, "a+");
-    if (log_stream->log_file == NULL) {
+// ====================================================================================================================
+// Interned Encoding
+// ====================================================================================================================
+#define MAX_VARINT_SIZE 10
+// doubles can exactly represent every integer below 2^53
+#define MAX_EXACT_INTEGER 9007199254740992.0
+
+static uint64_t hash_string(const char *string) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *current = string; *current != 0; current++) {
+        hash ^= (uint8_t)*current;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint32_t encode_varint(uint8_t *buffer, uint64_t value) {
+    uint32_t size = 0;
+    while (value >= 0x80) {
+        buffer[size] = (uint8_t)(value | 0x80);
+        value >>= 7;
+        size++;
+    }
+    buffer[size] = (uint8_t)value;
+    return size + 1;
+}
+
+static void reserve_record(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, uint32_t size) {
+    uint32_t required = log_stream->record_size + size;
+    if (required <= log_stream->record_capacity) {
+        return;
+    }
+
+    uint32_t capacity = log_stream->record_capacity == 0 ? 256 : log_stream->record_capacity;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    log_stream->record = realloc(log_stream->record, capacity);
+    log_stream->record_capacity = capacity;
+}
+
+static void push_byte(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, uint8_t byte) {
+    reserve_record(log_stream, 1);
+    log_stream->record[log_stream->record_size] = byte;
+    log_stream->record_size++;
+}
+
+static void push_varint(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, uint64_t value) {
+    reserve_record(log_stream, MAX_VARINT_SIZE);
+    log_stream->record_size += encode_varint(log_stream->record + log_stream->record_size, value);
+}
+
+static void push_bytes(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const void *bytes, uint32_t size) {
+    reserve_record(log_stream, size);
+    memcpy(log_stream->record + log_stream->record_size, bytes, size);
+    log_stream->record_size += size;
+}
+
+static void write_bytes(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const void *bytes, size_t size) {
+    size_t written = fwrite(bytes, 1, size, log_stream->log_file);
+    log_stream->segment_bytes += written;
+}
+
+static void reset_interned(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream) {
+    for (uint32_t i = 0; i < log_stream->interned_capacity; i++) {
+        free(log_stream->interned[i].string);
+    }
+    if (log_stream->interned != NULL) {
+        memset(log_stream->interned, 0, log_stream->interned_capacity * sizeof(CN(Cortecs, Log, Interned)));
+    }
+    log_stream->interned_count = 0;
+}
+
+static void grow_interned(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream) {
+    uint32_t old_capacity = log_stream->interned_capacity;
+    CN(Cortecs, Log, Interned) *old_interned = log_stream->interned;
+
+    uint32_t capacity = old_capacity == 0 ? 64 : old_capacity * 2;
+    log_stream->interned = calloc(capacity, sizeof(CN(Cortecs, Log, Interned)));
+    log_stream->interned_capacity = capacity;
+
+    uint32_t mask = capacity - 1;
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        CN(Cortecs, Log, Interned) entry = old_interned[i];
+        if (entry.string == NULL) {
+            continue;
+        }
+
+        uint32_t index = entry.hash & mask;
+        while (log_stream->interned[index].string != NULL) {
+            index = (index + 1) & mask;
+        }
+        log_stream->interned[index] = entry;
+    }
+    free(old_interned);
+}
+
+static uint32_t intern(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const char *string) {
+    // keep the load factor under 3/4
+    if ((log_stream->interned_count + 1) * 4 > log_stream->interned_capacity * 3) {
+        grow_interned(log_stream);
+    }
+
+    uint64_t hash = hash_string(string);
+    uint32_t mask = log_stream->interned_capacity - 1;
+    uint32_t index = hash & mask;
+    while (true) {
+        CN(Cortecs, Log, Interned) *entry = &log_stream->interned[index];
+        if (entry->string == NULL) {
+            break;
+        }
+
+        if (entry->hash == hash && strcmp(entry->string, string) == 0) {
+            return entry->id;
+        }
+        index = (index + 1) & mask;
+    }
+
+    log_stream->interned_count++;
+    uint32_t id = log_stream->interned_count;
+    log_stream->interned[index] = (CN(Cortecs, Log, Interned)){
+        .hash = hash,
+        .string = strdup(string),
+        .id = id,
+    };
+
+    // the definition is written straight to the file so that it comes
+    // before the message record currently being encoded
+    uint32_t length = strlen(string);
+    uint8_t header[1 + (2 * MAX_VARINT_SIZE)];
+    uint32_t header_size = 0;
+    header[header_size] = CORTECS_LOG_RECORD_STRING;
+    header_size++;
+    header_size += encode_varint(header + header_size, id);
+    header_size += encode_varint(header + header_size, length);
+    write_bytes(log_stream, header, header_size);
+    write_bytes(log_stream, string, length);
+
+    return id;
+}
+
+static void encode_value(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const cJSON *value) {
+    if (cJSON_IsString(value)) {
+        uint32_t id = intern(log_stream, value->valuestring);
+        push_byte(log_stream, CORTECS_LOG_VALUE_STRING);
+        push_varint(log_stream, id);
+        return;
+    }
+
+    if (cJSON_IsNumber(value)) {
+        double number = value->valuedouble;
+        bool is_integer = number > -MAX_EXACT_INTEGER && number < MAX_EXACT_INTEGER && (double)(int64_t)number == number;
+        if (is_integer && number >= 0) {
+            push_byte(log_stream, CORTECS_LOG_VALUE_UINT);
+            push_varint(log_stream, (uint64_t)number);
+        } else if (is_integer) {
+            int64_t integer = (int64_t)number;
+            push_byte(log_stream, CORTECS_LOG_VALUE_SINT);
+            push_varint(log_stream, ((uint64_t)integer << 1) ^ (uint64_t)(integer >> 63));
+        } else {
+            uint64_t bits;
+            memcpy(&bits, &number, sizeof(bits));
+            uint8_t bytes[sizeof(bits)];
+            for (uint32_t i = 0; i < sizeof(bits); i++) {
+                bytes[i] = (uint8_t)(bits >> (i * 8));
+            }
+            push_byte(log_stream, CORTECS_LOG_VALUE_DOUBLE);
+            push_bytes(log_stream, bytes, sizeof(bytes));
+        }
+        return;
+    }
+
+    if (cJSON_IsBool(value)) {
+        push_byte(log_stream, cJSON_IsTrue(value) ? CORTECS_LOG_VALUE_TRUE : CORTECS_LOG_VALUE_FALSE);
+        return;
+    }
+
+    if (cJSON_IsNull(value)) {
+        push_byte(log_stream, CORTECS_LOG_VALUE_NULL);
+        return;
+    }
+
+    char *json = cJSON_PrintUnformatted(value);
+    if (json == NULL) {
         // todo error
-        return NULL;
+        push_byte(log_stream, CORTECS_LOG_VALUE_NULL);
+        return;
     }
+    uint32_t length = strlen(json);
+    push_byte(log_stream, CORTECS_LOG_VALUE_JSON);
+    push_varint(log_stream, length);
+    push_bytes(log_stream, json, length);
+    cJSON_free(json);
+}
 
-    return log_stream;
+static void write_interned(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const cJSON *message) {
+    uint32_t num_fields = 0;
+    const cJSON *field;
+    cJSON_ArrayForEach(field, message) {
+        num_fields++;
+    }
+
+    log_stream->record_size = 0;
+    push_byte(log_stream, CORTECS_LOG_RECORD_MESSAGE);
+    push_varint(log_stream, num_fields);
+    cJSON_ArrayForEach(field, message) {
+        push_varint(log_stream, intern(log_stream, field->string));
+        encode_value(log_stream, field);
+    }
+    write_bytes(log_stream, log_stream->record, log_stream->record_size);
 }
 
-void CN(Cortecs, Log, write)(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const cJSON *message) {
+static void write_json(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const cJSON *message) {
     char *message_string = cJSON_PrintUnformatted(message);
     if (message_string == NULL) {
         // todo error
         return;
     }
 
-    fprintf(log_stream->log_file, "%s\n", message_string);
+    int written = fprintf(log_stream->log_file, "%s\n", message_string);
+    if (written > 0) {
+        log_stream->segment_bytes += written;
+    }
     cJSON_free(message_string);
+}
+
+static void write_message(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const cJSON *message) {
+    if (log_stream->config.encoding == CORTECS_LOG_ENCODING_INTERNED) {
+        write_interned(log_stream, message);
+    } else {
+        write_json(log_stream, message);
+    }
+}
+
+static void start_segment(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream) {
+    if (log_stream->config.encoding != CORTECS_LOG_ENCODING_INTERNED) {
+        return;
+    }
+
+    // each segment has its own dictionary so that segments can be decoded independently
+    reset_interned(log_stream);
+    if (log_stream->segment_bytes == 0) {
+        write_bytes(log_stream, CORTECS_LOG_INTERNED_MAGIC, CORTECS_LOG_INTERNED_MAGIC_SIZE);
+    }
+}
+
+// ====================================================================================================================
+// Rotation
+// ====================================================================================================================
+static bool is_rotating(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream) {
+    return log_stream->config.max_segment_bytes != 0 || log_stream->config.max_segment_seconds != 0;
+}
+
+static char *segment_path(const char *path, uint64_t segment) {
+    int size = snprintf(NULL, 0, "%s.%" PRIu64, path, segment);
+    char *out = malloc(size + 1);
+    snprintf(out, size + 1, "%s.%" PRIu64, path, segment);
+    return out;
+}
+
+// the number of a rotated segment of path or 0 when name isn't one
+static uint64_t parse_segment(const char *name, const char *base) {
+    size_t base_length = strlen(base);
+    if (strncmp(name, base, base_length) != 0 || name[base_length] != '.' || name[base_length + 1] == 0) {
+        return 0;
+    }
+
+    uint64_t segment = 0;
+    for (const char *current = name + base_length + 1; *current != 0; current++) {
+        if (*current < '0' || *current > '9') {
+            return 0;
+        }
+        segment = segment * 10 + (uint64_t)(*current - '0');
+    }
+    return segment;
+}
+
+static void find_segments(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream) {
+    // segments left behind by a previous run are kept, numbering continues after them
+    // and they count against max_segments
+    log_stream->segment = 1;
+    log_stream->oldest_segment = 0;
+
+    const char *separator = strrchr(log_stream->path, '/');
+    char *directory = separator == NULL ? strdup(".") : strndup(log_stream->path, separator - log_stream->path + 1);
+    const char *base = separator == NULL ? log_stream->path : separator + 1;
+    DIR *entries = opendir(directory);
+    free(directory);
+    if (entries == NULL) {
+        // todo error
+        log_stream->oldest_segment = log_stream->segment;
+        return;
+    }
+
+    for (struct dirent *entry = readdir(entries); entry != NULL; entry = readdir(entries)) {
+        uint64_t segment = parse_segment(entry->d_name, base);
+        if (segment == 0) {
+            continue;
+        }
+        if (segment >= log_stream->segment) {
+            log_stream->segment = segment + 1;
+        }
+        if (log_stream->oldest_segment == 0 || segment < log_stream->oldest_segment) {
+            log_stream->oldest_segment = segment;
+        }
+    }
+    closedir(entries);
+
+    if (log_stream->oldest_segment == 0) {
+        log_stream->oldest_segment = log_stream->segment;
+    }
+}
+
+static void write_segment_header(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream) {
+    cJSON *header = cJSON_CreateObject();
+    cJSON_AddStringToObject(header, "method", "cortecs_log_segment");
+    cJSON_AddNumberToObject(header, "segment", (double)log_stream->segment);
+    cJSON_AddNumberToObject(header, "sequence", (double)log_stream->sequence);
+    cJSON_AddNumberToObject(header, "last_event_id", (double)log_stream->last_event_id);
+    write_message(log_stream, header);
+    cJSON_Delete(header);
+}
+
+typedef struct {
+    FILE *closed_segment;
+    // the segments [first_expired, last_expired] of path are deleted. there are gaps
+    // where segments were deleted by hand or by an earlier run
+    char *path;
+    uint64_t first_expired;
+    uint64_t last_expired;
+} rotation_work;
+
+static void *perform_rotation_work(void *argument) {
+    rotation_work *work = argument;
+    fclose(work->closed_segment);
+    for (uint64_t segment = work->first_expired; segment <= work->last_expired; segment++) {
+        char *expired = segment_path(work->path, segment);
+        remove(expired);
+        free(expired);
+    }
+    free(work->path);
+    free(work);
+    return NULL;
+}
+
+// blocks the caller for the rename, the open and the header. the header shares the interned
+// strings and the record buffer with the caller's writes so it can't be written on the worker.
+// the flush and close of the previous segment and the deletes are the slow parts and are on the worker
+static void rotate(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream) {
+    // the open FILE keeps writing to the renamed segment so the
+    // buffered messages still end up in the correct segment
+    char *closed_path = segment_path(log_stream->path, log_stream->segment);
+    if (rename(log_stream->path, closed_path) != 0) {
+        // todo error
+        free(closed_path);
+        return;
+    }
+    free(closed_path);
+
+    FILE *next_file = fopen(log_stream->path, "a+");
+    if (next_file == NULL) {
+        // todo error
+        return;
+    }
+
+    rotation_work *work = malloc(sizeof(rotation_work));
+    work->closed_segment = log_stream->log_file;
+    work->path = strdup(log_stream->path);
+    work->first_expired = 1;
+    work->last_expired = 0;
+    uint32_t max_segments = log_stream->config.max_segments;
+    if (max_segments != 0 && log_stream->segment - log_stream->oldest_segment >= max_segments) {
+        // everything older than the newest max_segments including the segments of earlier runs
+        work->first_expired = log_stream->oldest_segment;
+        work->last_expired = log_stream->segment - max_segments;
+        log_stream->oldest_segment = work->last_expired + 1;
+    }
+
+    log_stream->log_file = next_file;
+    log_stream->segment++;
+    log_stream->segment_bytes = 0;
+    log_stream->segment_opened = time(NULL);
+    start_segment(log_stream);
+    write_segment_header(log_stream);
+
+    // rotations are far apart so the previous worker has almost always finished
+    if (log_stream->has_rotation_worker) {
+        pthread_join(log_stream->rotation_worker, NULL);
+    }
+    log_stream->has_rotation_worker = pthread_create(&log_stream->rotation_worker, NULL, perform_rotation_work, work) == 0;
+    if (!log_stream->has_rotation_worker) {
+        perform_rotation_work(work);
+    }
+}
+
+static bool should_rotate(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream) {
+    CN(Cortecs, Log, Config) config = log_stream->config;
+    if (config.max_segment_bytes != 0 && log_stream->segment_bytes >= config.max_segment_bytes) {
+        return true;
+    }
+
+    if (config.max_segment_seconds != 0) {
+        time_t now = time(NULL);
+        if ((uint64_t)difftime(now, log_stream->segment_opened) >= config.max_segment_seconds) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void track_event_id(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const cJSON *message) {
+    cJSON *event_id = cJSON_GetObjectItem(message, "event_id");
+    if (cJSON_IsNumber(event_id)) {
+        log_stream->last_event_id = (uint64_t)event_id->valuedouble;
+    }
+}
+
+// ====================================================================================================================
+// Public API
+// ====================================================================================================================
+CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) CN(Cortecs, Log, open)(CN(Cortecs, String) path) {
+    return CN(Cortecs, Log, open_with_config)(
+        path,
+        (CN(Cortecs, Log, Config)){
+            .max_segment_bytes = 0,
+            .max_segment_seconds = 0,
+            .max_segments = 0,
+            .encoding = CORTECS_LOG_ENCODING_JSON,
+        }
+    );
+}
+
+CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) CN(Cortecs, Log, open_with_config)(CN(Cortecs, String) path, CN(Cortecs, Log, Config) config) {
+    // the file is opened first so the finalizer never sees a log that failed to open
+    FILE *log_file = fopen(CN(Cortecs, String, cstr)(&path), "a+");
+    if (log_file == NULL) {
+        // todo error
+        return NULL;
+    }
+
+    CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream = cortecs_gc_alloc(CN(Cortecs, Log));
+    log_stream->log_file = log_file;
+    log_stream->path = strdup(CN(Cortecs, String, cstr)(&path));
+    log_stream->config = config;
+    log_stream->sequence = 0;
+    log_stream->last_event_id = 0;
+    log_stream->has_rotation_worker = false;
+    log_stream->segment_opened = time(NULL);
+    log_stream->interned = NULL;
+    log_stream->interned_capacity = 0;
+    log_stream->interned_count = 0;
+    log_stream->record = NULL;
+    log_stream->record_size = 0;
+    log_stream->record_capacity = 0;
+
+    // a+ appends to an existing log. count what's already there against the size limit
+    fseek(log_stream->log_file, 0, SEEK_END);
+    long existing_bytes = ftell(log_stream->log_file);
+    log_stream->segment_bytes = existing_bytes > 0 ? (uint64_t)existing_bytes : 0;
+    start_segment(log_stream);
+
+    if (is_rotating(log_stream)) {
+        find_segments(log_stream);
+        write_segment_header(log_stream);
+    } else {
+        log_stream->segment = 0;
+        log_stream->oldest_segment = 0;
+    }
+
+    return log_stream;
+}
+
+void CN(Cortecs, Log, write)(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const cJSON *message) {
+    write_message(log_stream, message);
+
+    if (!is_rotating(log_stream)) {
+        return;
+    }
+
+    log_stream->sequence++;
+    track_event_id(log_stream, message);
+
+    if (should_rotate(log_stream)) {
+        rotate(log_stream);
+    }
 }
\ No newline at end of file
@@ -4,10 +4,104 @@
 #include <cJSON.h>
 #include <cortecs/mangle.h>
 #include <cortecs/string.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <time.h>
+
+// Messages are either written as one line of json per message or with the
+// interned encoding. The interned encoding is a binary format where every
+// string is written once per segment and referenced by id afterwards, and
+// integers are written as varints instead of decimal strings.
+//
+// Interned segments start with CORTECS_LOG_INTERNED_MAGIC followed by records.
+// Every record starts with a record tag byte. Integers are unsigned LEB128 varints.
+//   CORTECS_LOG_RECORD_STRING:  varint id, varint length, length bytes
+//   CORTECS_LOG_RECORD_MESSAGE: varint number of fields, then for each field
+//                               varint key string id, value tag byte, value
+// Values are encoded based on the value tag
+//   CORTECS_LOG_VALUE_STRING: varint string id
+//   CORTECS_LOG_VALUE_UINT:   varint
+//   CORTECS_LOG_VALUE_SINT:   zigzag encoded varint
+//   CORTECS_LOG_VALUE_DOUBLE: 8 byte little endian IEEE 754 double
+//   CORTECS_LOG_VALUE_FALSE, CORTECS_LOG_VALUE_TRUE, CORTECS_LOG_VALUE_NULL: no payload
+//   CORTECS_LOG_VALUE_JSON:   varint length, length bytes of unformatted json
+//                             used for nested arrays and objects
+typedef enum {
+    CORTECS_LOG_ENCODING_JSON,
+    CORTECS_LOG_ENCODING_INTERNED,
+} CN(Cortecs, Log, Encoding);
+
+#define CORTECS_LOG_INTERNED_MAGIC "CLG1"
+#define CORTECS_LOG_INTERNED_MAGIC_SIZE (sizeof(CORTECS_LOG_INTERNED_MAGIC) - 1)
+
+typedef enum {
+    CORTECS_LOG_RECORD_STRING = 1,
+    CORTECS_LOG_RECORD_MESSAGE = 2,
+} CN(Cortecs, Log, Record);
+
+typedef enum {
+    CORTECS_LOG_VALUE_STRING,
+    CORTECS_LOG_VALUE_UINT,
+    CORTECS_LOG_VALUE_SINT,
+    CORTECS_LOG_VALUE_DOUBLE,
+    CORTECS_LOG_VALUE_FALSE,
+    CORTECS_LOG_VALUE_TRUE,
+    CORTECS_LOG_VALUE_NULL,
+    CORTECS_LOG_VALUE_JSON,
+} CN(Cortecs, Log, Value);
+
+// Rotation splits a log into segments. The active segment is always written to
+// the path the log was opened with. When it is rotated it's renamed to
+// <path>.<segment> and a new active segment is opened at <path>.
+// A value of 0 disables the corresponding limit. The write that rotates the log
+// blocks for the rename, the open and the new segment's header.
+typedef struct CN(Cortecs, Log, Config) {
+    uint64_t max_segment_bytes;
+    uint64_t max_segment_seconds;
+    // number of rotated segments kept on disk
+    uint32_t max_segments;
+    CN(Cortecs, Log, Encoding) encoding;
+} CN(Cortecs, Log, Config);
+
+typedef struct {
+    uint64_t hash;
+    char *string;
+    uint32_t id;
+} CN(Cortecs, Log, Interned);
 
 typedef struct CN(Cortecs, Log) {
     FILE *log_file;
+    char *path;
+    CN(Cortecs, Log, Config) config;
+
+    uint64_t segment;
+    // the oldest rotated segment that may still be on disk. segments from earlier runs are included
+    uint64_t oldest_segment;
+    uint64_t segment_bytes;
+    time_t segment_opened;
+
+    // number of messages written across all segments and the last gc event id
+    // seen. these are written to the header of each segment so that the segments
+    // can be stitched back together
+    uint64_t sequence;
+    uint64_t last_event_id;
+
+    // closing the previous segment, which flushes it, and deleting old segments
+    // happen on a worker thread. the rest of rotation is on the thread doing the logging
+    pthread_t rotation_worker;
+    bool has_rotation_worker;
+
+    // open addressing table of the strings interned in the active segment
+    CN(Cortecs, Log, Interned) *interned;
+    uint32_t interned_capacity;
+    uint32_t interned_count;
+
+    // scratch buffer used to encode a message record before writing it
+    uint8_t *record;
+    uint32_t record_size;
+    uint32_t record_capacity;
 } CN(Cortecs, Log);
 
 #define TYPE_PARAM_T CN(Cortecs, Log)
@@ -19,6 +113,19 @@ extern cortecs_finalizer_declare(CN(Cortecs, Log));
 
 void CN(Cortecs, Log, init)();
 CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) CN(Cortecs, Log, open)(CN(Cortecs, String) path);
+CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) CN(Cortecs, Log, open_with_config)(CN(Cortecs, String) path, CN(Cortecs, Log, Config) config);
 void CN(Cortecs, Log, write)(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, const cJSON *message);
 
+// Reads back a log segment written with CORTECS_LOG_ENCODING_INTERNED
+typedef struct CN(Cortecs, Log, Decoder) {
+    FILE *file;
+    char **strings;
+    uint32_t strings_capacity;
+} CN(Cortecs, Log, Decoder);
+
+void CN(Cortecs, Log, Decoder, open)(CN(Cortecs, Log, Decoder) *decoder, FILE *file);
+// returns NULL at the end of the file or when the segment is malformed
+cJSON *CN(Cortecs, Log, Decoder, next)(CN(Cortecs, Log, Decoder) *decoder);
+void CN(Cortecs, Log, Decoder, close)(CN(Cortecs, Log, Decoder) *decoder);
+
 #endif
\ No newline at end of file
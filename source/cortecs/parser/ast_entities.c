@@ -0,0 +1,190 @@
+#include <cortecs/ast_entities.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <stdlib.h>
+
+ECS_COMPONENT_DECLARE(cortecs_ast_node_t);
+ECS_COMPONENT_DECLARE(cortecs_ast_position_t);
+
+static ecs_query_t *query;
+
+// the span from one position to a later one. undoes cortecs_span_add
+static cortecs_span_t span_between(cortecs_span_t from, cortecs_span_t to) {
+    if (to.lines != from.lines) {
+        return (cortecs_span_t){
+            .lines = to.lines - from.lines,
+            .columns = to.columns,
+        };
+    }
+
+    return (cortecs_span_t){
+        .lines = 0,
+        .columns = to.columns - from.columns,
+    };
+}
+
+void cortecs_ast_entities_init(void) {
+    ECS_COMPONENT_DEFINE(world, cortecs_ast_node_t);
+    ECS_COMPONENT_DEFINE(world, cortecs_ast_position_t);
+
+    ecs_query_desc_t desc = {
+        .terms = {
+            {.id = ecs_id(cortecs_span_t), .inout = EcsIn},
+            {.id = ecs_id(cortecs_ast_node_t), .inout = EcsIn},
+            {.id = ecs_id(cortecs_ast_position_t), .inout = EcsOut},
+        },
+        .cache_kind = EcsQueryCacheAuto,
+    };
+    query = ecs_query_init(world, &desc);
+}
+
+// a node whose entity hasn't been created yet
+typedef struct {
+    uint32_t node;
+    ecs_entity_t parent;
+    uint32_t depth;
+    cortecs_span_t span;
+} unspawned_t;
+
+ecs_entity_t cortecs_ast_entities_spawn(cortecs_ast_t ast, cortecs_lexer_tokens_t tokens, uint32_t node, ecs_entity_t parent, cortecs_span_t span, ecs_entity_t *entities) {
+    // where each token starts relative to the first token. the one past the last token is where the tokens end
+    cortecs_span_t *starts = malloc((tokens.size + 1) * sizeof(cortecs_span_t));
+    starts[0] = (cortecs_span_t){
+        .lines = 0,
+        .columns = 0,
+    };
+    for (uint32_t i = 0; i < tokens.size; i++) {
+        cortecs_span_t token_span = {
+            .lines = tokens.lines->elements[i],
+            .columns = tokens.columns->elements[i],
+        };
+        starts[i + 1] = cortecs_span_add(starts[i], token_span);
+    }
+
+    // entities are created parents first so a child can be a ChildOf its parent. a left associative
+    // chain is as deep as it's long so the tree is walked with a stack instead of recursion.
+    // every node is pushed once
+    unspawned_t *stack = malloc(ast.size * sizeof(unspawned_t));
+    const cortecs_ast_node_t *parent_node = parent == 0 ? NULL : ecs_get(world, parent, cortecs_ast_node_t);
+    stack[0] = (unspawned_t){
+        .node = node,
+        .parent = parent,
+        .depth = parent_node == NULL ? 0 : parent_node->depth + 1,
+        .span = span,
+    };
+    uint32_t size = 1;
+    ecs_entity_t root = 0;
+    while (size > 0) {
+        unspawned_t next = stack[--size];
+        ecs_entity_t entity = next.parent == 0 ? ecs_new(world) : ecs_new_w_pair(world, EcsChildOf, next.parent);
+        ecs_set(world, entity, cortecs_ast_node_t, {.tag = ast.tags->elements[next.node], .depth = next.depth});
+        ecs_set(world, entity, cortecs_span_t, {.lines = next.span.lines, .columns = next.span.columns});
+        ecs_set(world, entity, cortecs_ast_position_t, {.start = {.lines = 0, .columns = 0}});
+        if (entities != NULL) {
+            entities[next.node] = entity;
+        }
+        if (root == 0) {
+            root = entity;
+        }
+
+        // pushed last to first so the children are created in order
+        cortecs_span_t start = starts[ast.token_starts->elements[next.node]];
+        for (uint32_t i = ast.num_children->elements[next.node]; i-- > 0;) {
+            uint32_t child = cortecs_ast_child(ast, next.node, i);
+            stack[size++] = (unspawned_t){
+                .node = child,
+                .parent = entity,
+                .depth = next.depth + 1,
+                .span = span_between(start, starts[ast.token_starts->elements[child]]),
+            };
+        }
+    }
+
+    free(stack);
+    free(starts);
+    return root;
+}
+
+// an entity whose position is set but whose children's positions aren't
+typedef struct {
+    ecs_entity_t entity;
+    cortecs_span_t start;
+} unresolved_t;
+
+void cortecs_ast_entities_resolve(void) {
+    uint32_t capacity = 1024;
+    uint32_t size = 0;
+    unresolved_t *stack = malloc(capacity * sizeof(unresolved_t));
+
+    // walks down from every root with a stack since a tree is as deep as a chain of operators is long
+    ecs_iter_t it = ecs_query_iter(world, query);
+    while (ecs_query_next(&it)) {
+        const cortecs_span_t *spans = ecs_field(&it, cortecs_span_t, 0);
+        const cortecs_ast_node_t *nodes = ecs_field(&it, cortecs_ast_node_t, 1);
+        cortecs_ast_position_t *positions = ecs_field(&it, cortecs_ast_position_t, 2);
+        for (int32_t i = 0; i < it.count; i++) {
+            if (nodes[i].depth != 0) {
+                continue;
+            }
+
+            positions[i].start = spans[i];
+            stack[size++] = (unresolved_t){
+                .entity = it.entities[i],
+                .start = spans[i],
+            };
+            while (size > 0) {
+                unresolved_t parent = stack[--size];
+                ecs_iter_t children = ecs_children(world, parent.entity);
+                while (ecs_children_next(&children)) {
+                    if (size + (uint32_t)children.count > capacity) {
+                        while (size + (uint32_t)children.count > capacity) {
+                            capacity *= 2;
+                        }
+                        stack = realloc(stack, capacity * sizeof(unresolved_t));
+                    }
+                    for (int32_t j = 0; j < children.count; j++) {
+                        cortecs_ast_position_t *position = ecs_get_mut(world, children.entities[j], cortecs_ast_position_t);
+                        position->start = cortecs_span_add(parent.start, *ecs_get(world, children.entities[j], cortecs_span_t));
+                        stack[size++] = (unresolved_t){
+                            .entity = children.entities[j],
+                            .start = position->start,
+                        };
+                    }
+                }
+            }
+        }
+    }
+    free(stack);
+}
+
+uint32_t cortecs_ast_entities_shift(ecs_entity_t node, cortecs_span_t old_end, cortecs_span_t new_end) {
+    uint32_t num_shifted = 0;
+    ecs_entity_t around = 0;
+    for (ecs_entity_t parent = node; parent != 0; around = parent, parent = ecs_get_parent(world, parent)) {
+        cortecs_span_t parent_start = ecs_get(world, parent, cortecs_ast_position_t)->start;
+        ecs_iter_t it = ecs_children(world, parent);
+        while (ecs_children_next(&it)) {
+            for (int32_t i = 0; i < it.count; i++) {
+                ecs_entity_t child = it.entities[i];
+                if (child == around) {
+                    continue;
+                }
+
+                cortecs_span_t *span = ecs_get_mut(world, child, cortecs_span_t);
+                cortecs_span_t start = cortecs_span_add(parent_start, *span);
+                if (cortecs_span_compare(start, old_end) < 0) {
+                    continue;
+                }
+
+                // the text after the edit keeps its columns unless it's on the line the edit ends on
+                cortecs_span_t shifted = span_between(parent_start, cortecs_span_add(new_end, span_between(old_end, start)));
+                if (cortecs_span_compare(shifted, *span) != 0) {
+                    *span = shifted;
+                    ecs_modified(world, child, cortecs_span_t);
+                    num_shifted++;
+                }
+            }
+        }
+    }
+    return num_shifted;
+}
\ No newline at end of file
@@ -1,67 +1,1094 @@
+#include <assert.h>
 #include <common.h>
+#include <cortecs/gc.h>
+#include <cortecs/kernel.h>
 #include <cortecs/parser.h>
 #include <cortecs/span.h>
 #include <flecs.h>
 #include <stdlib.h>
+#include <string.h>
 
-// for use when dfs traversals are implemented
-// typedef struct {
-//     cortecs_span_t absolute_offset;
-// } cortecs_parser_context_t;
-
-// static void *cortecs_parser_context_create(ecs_world_t *world, uint64_t group_id, void *group_by_arg) {
-//     UNUSED(world);
-//     CORTECS_UNUSED(group_id);
-//     CORTECS_UNUSED(group_by_arg);
-//     return calloc(1, sizeof(cortecs_parser_context_t));
-// }
-
-// static void cortecs_parser_context_destroy(ecs_world_t *world, uint64_t group_id, void *context, void *group_by_arg) {
-//     CORTECS_UNUSED(world);
-//     CORTECS_UNUSED(group_id);
-//     CORTECS_UNUSED(group_by_arg);
-//     free(context);
-// }
-
-// static int cortecs_parser_span_compare(ecs_entity_t left, const void *left_span, ecs_entity_t right, const void *right_span) {
-//     CORTECS_UNUSED(left);
-//     CORTECS_UNUSED(right);
-//     return cortecs_span_compare(*(cortecs_span_t *)left_span, *(cortecs_span_t *)right_span);
-// }
-
-// int main() {
-//     ecs_query_desc_t desc = {
-//         .filter.terms[0] = (ecs_term_t){
-//             .id = ecs_id(cortecs_span_t),
-//             .inout = EcsIn,
-//         },
-//         .filter.terms[1] = (ecs_term_t){
-//             .id = ecs_id(cortecs_span_t),
-//             .src.flags = EcsUp,
-//             .src.trav = EcsChildOf,
-//         },
-//         .group_by_id = EcsChildOf,
-//         .on_group_create = cortecs_parser_context_create,
-//         .on_group_delete = cortecs_parser_context_destroy,
-//         .order_by_component = ecs_id(cortecs_span_t),
-//         .order_by = cortecs_parser_span_compare,
-//     };
-//     ecs_query_t *query = ecs_query_init(cortecs_world, &desc);
-
-//     ecs_iter_t it = ecs_query_iter(cortecs_world, query);
-//     while (ecs_query_next(&it)) {
-//         cortecs_span_t const *span = ecs_field(&it, cortecs_span_t, 1);
-//         cortecs_parser_context_t *parent_context = ecs_query_get_group_ctx(query, it.group_id);
-//         for (int i = 0; i < it.count; i++) {
-//             ecs_entity_t entity = it.entities[i];
-//             cortecs_span_t absolute_offset = cortecs_span_add(parent_context->absolute_offset, span[i]);
-//             cortecs_parser_context_t *entity_context = ecs_query_get_group_ctx(query, entity);
-//             if (entity_context) {
-//                 entity_context->absolute_offset = absolute_offset;
-//             }
-//         }
-//     }
-
-//     ecs_query_fini(query);
-//     return 0;
-// }
\ No newline at end of file
+// nodes are collected in malloc'd columns then copied into exactly sized gc columns
+// like the lexer's tokens so the tree is a single allocation per column
+typedef struct {
+    uint32_t size;
+    uint32_t capacity;
+    uint8_t *tags;
+    uint32_t *tokens;
+    uint32_t *token_starts;
+    uint32_t *token_ends;
+    uint32_t *first_children;
+    uint32_t *num_children;
+} node_columns_t;
+
+typedef struct {
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t *elements;
+} indexes_t;
+
+typedef struct {
+    const char *bytes;
+    cortecs_lexer_tokens_t tokens;
+    // the next token to parse
+    uint32_t current;
+    node_columns_t nodes;
+    indexes_t children;
+    // the children of the nodes being parsed. a node takes its children off the top when it's finished
+    indexes_t stack;
+    uint32_t num_errors;
+    // the number of operands or type arguments being parsed inside each other
+    uint32_t depth;
+    // the number of >s of the token at current that closed type arguments. a >> closes two
+    uint32_t split_angles;
+    // tokens where the file's items stop being parsed if an item starts there. sorted
+    const uint32_t *stops;
+    uint32_t num_stops;
+    uint32_t next_stop;
+} parser_t;
+
+// the tag of every index past the last token
+#define TAG_END UINT8_MAX
+// most tokens become a node and about half of them are whitespace
+#define TOKENS_PER_NODE_ESTIMATE 2
+// operands or type arguments nested deeper than this are an error so parentheses, prefix operators or
+// generics can't overflow the stack
+#define MAX_DEPTH 256
+
+static void grow_nodes(node_columns_t *nodes, uint32_t capacity) {
+    nodes->capacity = capacity;
+    nodes->tags = realloc(nodes->tags, capacity * sizeof(uint8_t));
+    nodes->tokens = realloc(nodes->tokens, capacity * sizeof(uint32_t));
+    nodes->token_starts = realloc(nodes->token_starts, capacity * sizeof(uint32_t));
+    nodes->token_ends = realloc(nodes->token_ends, capacity * sizeof(uint32_t));
+    nodes->first_children = realloc(nodes->first_children, capacity * sizeof(uint32_t));
+    nodes->num_children = realloc(nodes->num_children, capacity * sizeof(uint32_t));
+}
+
+static void push_index(indexes_t *indexes, uint32_t index) {
+    if (indexes->size == indexes->capacity) {
+        indexes->capacity = indexes->capacity * 2 + 16;
+        indexes->elements = realloc(indexes->elements, indexes->capacity * sizeof(uint32_t));
+    }
+    indexes->elements[indexes->size] = index;
+    indexes->size++;
+}
+
+// finishes a node whose children are on the stack from base and pushes it in their place
+static uint32_t push_node(parser_t *parser, cortecs_ast_tag_t tag, uint32_t token, uint32_t base) {
+    node_columns_t *nodes = &parser->nodes;
+    if (nodes->size == nodes->capacity) {
+        grow_nodes(nodes, nodes->capacity * 2);
+    }
+
+    uint32_t node = nodes->size;
+    uint32_t num_children = parser->stack.size - base;
+    nodes->tags[node] = tag;
+    nodes->tokens[node] = token;
+    nodes->token_starts[node] = token;
+    nodes->token_ends[node] = parser->current;
+    nodes->first_children[node] = parser->children.size;
+    nodes->num_children[node] = num_children;
+    nodes->size++;
+
+    // children are in the order they appear so they only widen the node at its ends
+    if (num_children > 0) {
+        uint32_t first_start = nodes->token_starts[parser->stack.elements[base]];
+        uint32_t last_end = nodes->token_ends[parser->stack.elements[parser->stack.size - 1]];
+        nodes->token_starts[node] = first_start < token ? first_start : token;
+        nodes->token_ends[node] = last_end > parser->current ? last_end : parser->current;
+    }
+
+    for (uint32_t i = 0; i < num_children; i++) {
+        push_index(&parser->children, parser->stack.elements[base + i]);
+    }
+    parser->stack.size = base;
+    push_index(&parser->stack, node);
+    return node;
+}
+
+// errors don't consume their token. the statement or declaration skips to the end of the line
+static void push_error(parser_t *parser, uint32_t token) {
+    parser->num_errors++;
+    uint32_t node = push_node(parser, CORTECS_AST_ERROR, token, parser->stack.size);
+    parser->nodes.token_starts[node] = token;
+    parser->nodes.token_ends[node] = token < parser->tokens.size ? token + 1 : token;
+}
+
+// the keyword of a let or a function isn't its token but the node still starts at it.
+// the node is the last one pushed
+static void start_at_keyword(parser_t *parser, uint32_t keyword) {
+    parser->nodes.token_starts[parser->nodes.size - 1] = keyword;
+}
+
+static uint8_t tag_at(parser_t *parser, uint32_t index) {
+    return index < parser->tokens.size ? parser->tokens.tags->elements[index] : TAG_END;
+}
+
+// the first token at or after index that isn't a space. newlines end statements so they aren't skipped
+static uint32_t skip_space(parser_t *parser, uint32_t index) {
+    if (index >= parser->tokens.size) {
+        return parser->tokens.size;
+    }
+    const uint8_t *tags = parser->tokens.tags->elements + index;
+    return index + CN(Cortecs, Kernel, skip_either)(tags, parser->tokens.size - index, CORTECS_LEXER_TAG_SPACE, CORTECS_LEXER_TAG_SPACE);
+}
+
+static void skip_lines(parser_t *parser) {
+    if (parser->current < parser->tokens.size) {
+        parser->current = cortecs_lexer_tokens_skip_whitespace(parser->tokens, parser->current);
+    }
+}
+
+// moves to the end of the line, the } closing the body or the end of the tokens
+static void skip_line(parser_t *parser) {
+    while (true) {
+        uint8_t tag = tag_at(parser, parser->current);
+        if (tag == CORTECS_LEXER_TAG_NEW_LINE || tag == CORTECS_LEXER_TAG_CLOSE_CURLY || tag == TAG_END) {
+            return;
+        }
+        parser->current++;
+    }
+}
+
+// consumes the next token on the line if it has the tag. otherwise pushes an error for it
+static bool expect(parser_t *parser, cortecs_lexer_tag_t tag) {
+    uint32_t token = skip_space(parser, parser->current);
+    if (tag_at(parser, token) != tag) {
+        push_error(parser, token);
+        return false;
+    }
+    parser->current = token + 1;
+    return true;
+}
+
+static bool is_single_operator(parser_t *parser, uint32_t token, char operator) {
+    return tag_at(parser, token) == CORTECS_LEXER_TAG_OPERATOR && parser->tokens.lengths->elements[token] == 1 && parser->bytes[parser->tokens.offsets->elements[token]] == operator;
+}
+
+static uint32_t precedence_of(parser_t *parser, uint32_t token) {
+    switch (parser->bytes[parser->tokens.offsets->elements[token]]) {
+        case '|':
+        case '^':
+        case '&':
+        case '~':
+            return 1;
+        case '=':
+        case '!':
+            return 2;
+        case '<':
+        case '>':
+            return 3;
+        case '+':
+        case '-':
+            return 4;
+        default:
+            return 5;
+    }
+}
+
+static uint32_t parse_expression(parser_t *parser, uint32_t min_precedence);
+
+// an operator token of only >s. each > can close a list of type arguments
+static bool is_close_angles(parser_t *parser, uint32_t token) {
+    if (tag_at(parser, token) != CORTECS_LEXER_TAG_OPERATOR) {
+        return false;
+    }
+    const char *bytes = parser->bytes + parser->tokens.offsets->elements[token];
+    for (uint32_t i = 0; i < parser->tokens.lengths->elements[token]; i++) {
+        if (bytes[i] != '>') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the token at current when part of it closed type arguments, otherwise the next token on the line
+static uint32_t next_angle_token(parser_t *parser) {
+    return parser->split_angles > 0 ? parser->current : skip_space(parser, parser->current);
+}
+
+// takes one > closing type arguments. current only moves past a >> once both of its >s are taken
+static bool take_close_angle(parser_t *parser) {
+    uint32_t token = next_angle_token(parser);
+    if (!is_close_angles(parser, token)) {
+        return false;
+    }
+
+    if (parser->split_angles + 1 == parser->tokens.lengths->elements[token]) {
+        parser->current = token + 1;
+        parser->split_angles = 0;
+    } else {
+        parser->current = token;
+        parser->split_angles++;
+    }
+    return true;
+}
+
+// pushes an error for the token at current and stops splitting it
+static bool angle_error(parser_t *parser) {
+    uint32_t token = next_angle_token(parser);
+    parser->current = token;
+    parser->split_angles = 0;
+    push_error(parser, token);
+    return false;
+}
+
+static bool parse_nested_type(parser_t *parser);
+
+// type (',' type)* '>'. the < has been consumed. each type is a node with tag. type parameters are
+// only a type name and type arguments can have type arguments of their own
+static bool parse_type_list(parser_t *parser, cortecs_ast_tag_t tag) {
+    while (true) {
+        if (tag == CORTECS_AST_TYPE_PARAMETER) {
+            if (!expect(parser, CORTECS_LEXER_TAG_TYPE)) {
+                return false;
+            }
+            push_node(parser, tag, parser->current - 1, parser->stack.size);
+        } else if (!parse_nested_type(parser)) {
+            return false;
+        }
+
+        if (take_close_angle(parser)) {
+            return true;
+        }
+        uint32_t comma = skip_space(parser, parser->current);
+        if (parser->split_angles > 0 || tag_at(parser, comma) != CORTECS_LEXER_TAG_COMMA) {
+            return angle_error(parser);
+        }
+        parser->current = comma + 1;
+    }
+}
+
+// type ('<' type (',' type)* '>')?
+static bool parse_nested_type(parser_t *parser) {
+    uint32_t base = parser->stack.size;
+    if (!expect(parser, CORTECS_LEXER_TAG_TYPE)) {
+        return false;
+    }
+    uint32_t name = parser->current - 1;
+
+    uint32_t open_angle = skip_space(parser, parser->current);
+    bool is_valid = true;
+    if (is_single_operator(parser, open_angle, '<')) {
+        if (parser->depth == MAX_DEPTH) {
+            parser->current = open_angle;
+            push_error(parser, open_angle);
+            is_valid = false;
+        } else {
+            parser->current = open_angle + 1;
+            parser->depth++;
+            is_valid = parse_type_list(parser, CORTECS_AST_TYPE);
+            parser->depth--;
+        }
+    }
+    push_node(parser, CORTECS_AST_TYPE, name, base);
+    return is_valid;
+}
+
+// a type or type list outside of any other ends at the end of a token. Foo<Bar>> has one > too many
+static bool end_types(parser_t *parser, bool is_valid) {
+    if (is_valid && parser->split_angles > 0) {
+        return angle_error(parser);
+    }
+    return is_valid;
+}
+
+static bool parse_type(parser_t *parser) {
+    return end_types(parser, parse_nested_type(parser));
+}
+
+// name ('<' type (',' type)* '>')? '(' (expression (',' expression)*)? ')'. newlines are allowed between the
+// parentheses. the < has to follow the name and the > closing it has to be followed by a ( or it's a
+// comparison. the tokens up to the ( are scanned without parsing so a comparison doesn't need to backtrack
+static bool is_generic_call(parser_t *parser, uint32_t name) {
+    if (!is_single_operator(parser, name + 1, '<') || tag_at(parser, skip_space(parser, name + 2)) != CORTECS_LEXER_TAG_TYPE) {
+        return false;
+    }
+
+    uint32_t open_angles = 1;
+    for (uint32_t token = name + 2; token < parser->tokens.size; token++) {
+        uint8_t tag = tag_at(parser, token);
+        if (tag == CORTECS_LEXER_TAG_SPACE || tag == CORTECS_LEXER_TAG_TYPE || tag == CORTECS_LEXER_TAG_COMMA) {
+            continue;
+        }
+        if (is_single_operator(parser, token, '<')) {
+            open_angles++;
+            continue;
+        }
+        if (!is_close_angles(parser, token) || parser->tokens.lengths->elements[token] > open_angles) {
+            return false;
+        }
+
+        open_angles -= parser->tokens.lengths->elements[token];
+        if (open_angles == 0) {
+            return tag_at(parser, skip_space(parser, token + 1)) == CORTECS_LEXER_TAG_OPEN_PAREN;
+        }
+    }
+    return false;
+}
+
+static uint32_t parse_call(parser_t *parser, uint32_t name) {
+    uint32_t base = parser->stack.size;
+    if (is_generic_call(parser, name)) {
+        parser->current = name + 2;
+        if (!end_types(parser, parse_type_list(parser, CORTECS_AST_TYPE)) || !expect(parser, CORTECS_LEXER_TAG_OPEN_PAREN)) {
+            return push_node(parser, CORTECS_AST_FUNCTION_CALL, name, base);
+        }
+    } else {
+        parser->current = skip_space(parser, parser->current) + 1;
+    }
+    skip_lines(parser);
+    if (tag_at(parser, parser->current) == CORTECS_LEXER_TAG_CLOSE_PAREN) {
+        parser->current++;
+        return push_node(parser, CORTECS_AST_FUNCTION_CALL, name, base);
+    }
+
+    while (true) {
+        uint32_t num_errors = parser->num_errors;
+        parse_expression(parser, 1);
+        if (parser->num_errors != num_errors) {
+            break;
+        }
+
+        skip_lines(parser);
+        uint8_t tag = tag_at(parser, parser->current);
+        if (tag == CORTECS_LEXER_TAG_CLOSE_PAREN) {
+            parser->current++;
+            break;
+        }
+        if (tag != CORTECS_LEXER_TAG_COMMA) {
+            push_error(parser, parser->current);
+            break;
+        }
+        parser->current++;
+        skip_lines(parser);
+    }
+    return push_node(parser, CORTECS_AST_FUNCTION_CALL, name, base);
+}
+
+static uint32_t parse_primary(parser_t *parser);
+
+static uint32_t parse_operand(parser_t *parser, uint32_t token) {
+    uint32_t base = parser->stack.size;
+    switch (tag_at(parser, token)) {
+        case CORTECS_LEXER_TAG_OPERATOR:
+            parser->current = token + 1;
+            parse_primary(parser);
+            return push_node(parser, CORTECS_AST_UNARY, token, base);
+        case CORTECS_LEXER_TAG_NAME:
+            parser->current = token + 1;
+            if (tag_at(parser, skip_space(parser, parser->current)) == CORTECS_LEXER_TAG_OPEN_PAREN || is_generic_call(parser, token)) {
+                return parse_call(parser, token);
+            }
+            return push_node(parser, CORTECS_AST_ATOMIC, token, base);
+        case CORTECS_LEXER_TAG_TYPE:
+        case CORTECS_LEXER_TAG_INT:
+        case CORTECS_LEXER_TAG_FLOAT:
+            parser->current = token + 1;
+            return push_node(parser, CORTECS_AST_ATOMIC, token, base);
+        case CORTECS_LEXER_TAG_OPEN_PAREN: {
+            parser->current = token + 1;
+            skip_lines(parser);
+            uint32_t num_errors = parser->num_errors;
+            parse_expression(parser, 1);
+            if (parser->num_errors == num_errors) {
+                skip_lines(parser);
+                expect(parser, CORTECS_LEXER_TAG_CLOSE_PAREN);
+            }
+            return push_node(parser, CORTECS_AST_EXPRESSION, token, base);
+        }
+        default:
+            push_error(parser, token);
+            return parser->nodes.size - 1;
+    }
+}
+
+static uint32_t parse_primary(parser_t *parser) {
+    uint32_t token = skip_space(parser, parser->current);
+    if (parser->depth == MAX_DEPTH) {
+        // skip the rest of the line so the operators above don't carry on parsing it
+        push_error(parser, token);
+        parser->current = token;
+        skip_line(parser);
+        return parser->nodes.size - 1;
+    }
+
+    parser->depth++;
+    uint32_t node = parse_operand(parser, token);
+    parser->depth--;
+    return node;
+}
+
+// precedence climbing. the operands of an operator bind tighter than it so binary operators are left associative
+static uint32_t parse_expression(parser_t *parser, uint32_t min_precedence) {
+    uint32_t base = parser->stack.size;
+    uint32_t left = parse_primary(parser);
+    while (true) {
+        uint32_t operator = skip_space(parser, parser->current);
+        if (tag_at(parser, operator) != CORTECS_LEXER_TAG_OPERATOR) {
+            return left;
+        }
+
+        uint32_t precedence = precedence_of(parser, operator);
+        if (precedence < min_precedence) {
+            return left;
+        }
+
+        parser->current = operator + 1;
+        skip_lines(parser);
+        parse_expression(parser, precedence + 1);
+        left = push_node(parser, CORTECS_AST_BINARY_P1 + precedence - 1, operator, base);
+    }
+}
+
+// 'let' name '=' expression
+static void parse_let(parser_t *parser) {
+    uint32_t base = parser->stack.size;
+    uint32_t name = skip_space(parser, parser->current);
+    if (!expect(parser, CORTECS_LEXER_TAG_NAME)) {
+        push_node(parser, CORTECS_AST_LET, name, base);
+        return;
+    }
+
+    uint32_t equals = skip_space(parser, parser->current);
+    if (!is_single_operator(parser, equals, '=')) {
+        push_error(parser, equals);
+        push_node(parser, CORTECS_AST_LET, name, base);
+        return;
+    }
+    parser->current = equals + 1;
+    skip_lines(parser);
+    parse_expression(parser, 1);
+    push_node(parser, CORTECS_AST_LET, name, base);
+}
+
+// 'return' expression?
+static void parse_return(parser_t *parser, uint32_t keyword) {
+    uint32_t base = parser->stack.size;
+    uint8_t tag = tag_at(parser, skip_space(parser, parser->current));
+    if (tag != CORTECS_LEXER_TAG_NEW_LINE && tag != CORTECS_LEXER_TAG_CLOSE_CURLY && tag != TAG_END) {
+        parse_expression(parser, 1);
+    }
+    push_node(parser, CORTECS_AST_RETURN, keyword, base);
+}
+
+// '{' (statement '\n')* '}'. the { has been consumed
+static void parse_body(parser_t *parser, uint32_t open_curly) {
+    uint32_t base = parser->stack.size;
+    while (true) {
+        skip_lines(parser);
+        uint32_t token = parser->current;
+        uint8_t tag = tag_at(parser, token);
+        if (tag == CORTECS_LEXER_TAG_CLOSE_CURLY) {
+            parser->current++;
+            break;
+        }
+        if (tag == TAG_END) {
+            push_error(parser, token);
+            break;
+        }
+
+        uint32_t num_errors = parser->num_errors;
+        parser->current = token + 1;
+        if (tag == CORTECS_LEXER_TAG_LET) {
+            parse_let(parser);
+            start_at_keyword(parser, token);
+        } else if (tag == CORTECS_LEXER_TAG_RETURN) {
+            parse_return(parser, token);
+        } else {
+            parser->current = token;
+            parse_expression(parser, 1);
+        }
+
+        // a statement ends at the end of its line or the end of the body
+        uint32_t end = skip_space(parser, parser->current);
+        uint8_t end_tag = tag_at(parser, end);
+        if (parser->num_errors == num_errors && end_tag != CORTECS_LEXER_TAG_NEW_LINE && end_tag != CORTECS_LEXER_TAG_CLOSE_CURLY && end_tag != TAG_END) {
+            push_error(parser, end);
+        }
+        if (parser->num_errors != num_errors) {
+            skip_line(parser);
+        }
+    }
+    push_node(parser, CORTECS_AST_BODY, open_curly, base);
+}
+
+// 'function' name ('<' type (',' type)* '>')? '(' (name ':' type (',' name ':' type)*)? ')' (':' type)? body.
+// the keyword has been consumed. where constraints on the type parameters aren't parsed
+static void parse_function(parser_t *parser) {
+    uint32_t base = parser->stack.size;
+    uint32_t name = skip_space(parser, parser->current);
+    if (!expect(parser, CORTECS_LEXER_TAG_NAME)) {
+        push_node(parser, CORTECS_AST_FUNCTION, name, base);
+        return;
+    }
+
+    uint32_t open_angle = skip_space(parser, parser->current);
+    if (is_single_operator(parser, open_angle, '<')) {
+        parser->current = open_angle + 1;
+        if (!end_types(parser, parse_type_list(parser, CORTECS_AST_TYPE_PARAMETER))) {
+            push_node(parser, CORTECS_AST_FUNCTION, name, base);
+            return;
+        }
+    }
+    if (!expect(parser, CORTECS_LEXER_TAG_OPEN_PAREN)) {
+        push_node(parser, CORTECS_AST_FUNCTION, name, base);
+        return;
+    }
+
+    skip_lines(parser);
+    bool is_first = true;
+    while (tag_at(parser, parser->current) != CORTECS_LEXER_TAG_CLOSE_PAREN) {
+        if (!is_first && !expect(parser, CORTECS_LEXER_TAG_COMMA)) {
+            push_node(parser, CORTECS_AST_FUNCTION, name, base);
+            return;
+        }
+        is_first = false;
+        skip_lines(parser);
+
+        uint32_t parameter_base = parser->stack.size;
+        uint32_t parameter = skip_space(parser, parser->current);
+        if (!expect(parser, CORTECS_LEXER_TAG_NAME) || !expect(parser, CORTECS_LEXER_TAG_COLON) || !parse_type(parser)) {
+            push_node(parser, CORTECS_AST_PARAMETER, parameter, parameter_base);
+            push_node(parser, CORTECS_AST_FUNCTION, name, base);
+            return;
+        }
+        push_node(parser, CORTECS_AST_PARAMETER, parameter, parameter_base);
+        skip_lines(parser);
+    }
+    parser->current++;
+
+    uint32_t colon = skip_space(parser, parser->current);
+    if (tag_at(parser, colon) == CORTECS_LEXER_TAG_COLON) {
+        parser->current = colon + 1;
+        if (!parse_type(parser)) {
+            push_node(parser, CORTECS_AST_FUNCTION, name, base);
+            return;
+        }
+    }
+
+    uint32_t open_curly = skip_space(parser, parser->current);
+    if (!expect(parser, CORTECS_LEXER_TAG_OPEN_CURLY)) {
+        push_node(parser, CORTECS_AST_FUNCTION, name, base);
+        return;
+    }
+    parse_body(parser, open_curly);
+    push_node(parser, CORTECS_AST_FUNCTION, name, base);
+}
+
+// parses items until the tokens end or an item starts at a stop. returns whether it stopped
+static bool parse_items(parser_t *parser) {
+    while (true) {
+        skip_lines(parser);
+        uint32_t token = parser->current;
+        uint8_t tag = tag_at(parser, token);
+        if (tag == TAG_END) {
+            return false;
+        }
+        while (parser->next_stop < parser->num_stops && parser->stops[parser->next_stop] < token) {
+            parser->next_stop++;
+        }
+        if (parser->next_stop < parser->num_stops && parser->stops[parser->next_stop] == token) {
+            return true;
+        }
+
+        uint32_t num_errors = parser->num_errors;
+        if (tag == CORTECS_LEXER_TAG_FUNCTION) {
+            parser->current = token + 1;
+            parse_function(parser);
+            start_at_keyword(parser, token);
+        } else {
+            // the error takes its token so the file always makes progress
+            push_error(parser, token);
+            parser->current = token + 1;
+        }
+
+        uint32_t end = skip_space(parser, parser->current);
+        uint8_t end_tag = tag_at(parser, end);
+        if (parser->num_errors == num_errors && end_tag != CORTECS_LEXER_TAG_NEW_LINE && end_tag != TAG_END) {
+            push_error(parser, end);
+        }
+        if (parser->num_errors != num_errors) {
+            skip_line(parser);
+            // a stray } would stop skip_line forever
+            if (tag_at(parser, parser->current) == CORTECS_LEXER_TAG_CLOSE_CURLY) {
+                parser->current++;
+            }
+        }
+    }
+}
+
+static void parse_file(parser_t *parser) {
+    uint32_t base = parser->stack.size;
+    parse_items(parser);
+    push_node(parser, CORTECS_AST_FILE, 0, base);
+    // the file starts at the first token even when it's whitespace
+    parser->nodes.token_starts[parser->nodes.size - 1] = 0;
+}
+
+static void move_column(void *elements, void *column, uint32_t size, uint32_t size_of_element) {
+    if (size > 0) {
+        memcpy(elements, column, size * size_of_element);
+    }
+    free(column);
+}
+
+// copies the parsed nodes into exactly sized gc columns and frees the parser's buffers
+static cortecs_ast_t finish_ast(parser_t *parser) {
+    free(parser->stack.elements);
+
+    uint32_t size = parser->nodes.size;
+    cortecs_ast_t ast = {
+        .size = size,
+        .root = size - 1,
+        .num_errors = parser->num_errors,
+        .tags = cortecs_gc_alloc_array(CN(Cortecs, U8), size),
+        .tokens = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .token_starts = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .token_ends = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .first_children = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .num_children = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .children = cortecs_gc_alloc_array(CN(Cortecs, U32), parser->children.size),
+    };
+    move_column(ast.tags->elements, parser->nodes.tags, size, sizeof(uint8_t));
+    move_column(ast.tokens->elements, parser->nodes.tokens, size, sizeof(uint32_t));
+    move_column(ast.token_starts->elements, parser->nodes.token_starts, size, sizeof(uint32_t));
+    move_column(ast.token_ends->elements, parser->nodes.token_ends, size, sizeof(uint32_t));
+    move_column(ast.first_children->elements, parser->nodes.first_children, size, sizeof(uint32_t));
+    move_column(ast.num_children->elements, parser->nodes.num_children, size, sizeof(uint32_t));
+    move_column(ast.children->elements, parser->children.elements, parser->children.size, sizeof(uint32_t));
+    return ast;
+}
+
+static parser_t init_parser(const char *bytes, cortecs_lexer_tokens_t tokens) {
+    parser_t parser = {
+        .bytes = bytes,
+        .tokens = tokens,
+        .current = 0,
+        .nodes = {.size = 0, .capacity = 0},
+        .children = {.size = 0, .capacity = 0},
+        .stack = {.size = 0, .capacity = 0},
+        .num_errors = 0,
+        .depth = 0,
+        .split_angles = 0,
+        .stops = NULL,
+        .num_stops = 0,
+        .next_stop = 0,
+    };
+    grow_nodes(&parser.nodes, tokens.size / TOKENS_PER_NODE_ESTIMATE + 16);
+    return parser;
+}
+
+cortecs_ast_t cortecs_parser_parse(const char *bytes, cortecs_lexer_tokens_t tokens) {
+    parser_t parser = init_parser(bytes, tokens);
+    parse_file(&parser);
+    return finish_ast(&parser);
+}
+
+// where an old token is after the edit
+typedef struct {
+    // the first relexed token and the first old token after the relexed ones
+    uint32_t start;
+    uint32_t end;
+    uint32_t inserted;
+    // unsigned arithmetic wraps so these also move tokens back when the edit removed them
+    uint32_t token_shift;
+    uint32_t byte_shift;
+} token_map_t;
+
+static token_map_t token_map(cortecs_lexer_relex_t relex, cortecs_lexer_edit_t edit) {
+    return (token_map_t){
+        .start = relex.start,
+        .end = relex.start + relex.removed,
+        .inserted = relex.inserted.size,
+        .token_shift = relex.inserted.size - relex.removed,
+        .byte_shift = edit.inserted - edit.removed,
+    };
+}
+
+// UINT32_MAX for the old tokens that were relexed
+static uint32_t map_token(token_map_t map, uint32_t token) {
+    if (token < map.start) {
+        return token;
+    }
+    return token >= map.end ? token + map.token_shift : UINT32_MAX;
+}
+
+// ends are one past a token so a node can end where the relexed tokens start
+static uint32_t map_token_end(token_map_t map, uint32_t end) {
+    return end <= map.start ? end : map_token(map, end);
+}
+
+// the tokens after the edit from start up to end. the parser doesn't read spans so only
+// the tags, offsets and lengths are filled
+static cortecs_lexer_tokens_t window_tokens(cortecs_lexer_tokens_t tokens, cortecs_lexer_relex_t relex, token_map_t map, uint32_t start, uint32_t end) {
+    cortecs_lexer_tokens_t window = {
+        .size = end - start,
+        .tags = cortecs_gc_alloc_array(CN(Cortecs, U8), end - start),
+        .offsets = cortecs_gc_alloc_array(CN(Cortecs, U32), end - start),
+        .lengths = cortecs_gc_alloc_array(CN(Cortecs, U32), end - start),
+        .lines = NULL,
+        .columns = NULL,
+    };
+    for (uint32_t i = start; i < end; i++) {
+        cortecs_lexer_tokens_t from = tokens;
+        uint32_t index = i;
+        uint32_t shift = 0;
+        if (i >= map.start && i < map.start + map.inserted) {
+            from = relex.inserted;
+            index = i - map.start;
+        } else if (i >= map.start) {
+            index = i - map.token_shift;
+            shift = map.byte_shift;
+        }
+        window.tags->elements[i - start] = from.tags->elements[index];
+        window.offsets->elements[i - start] = from.offsets->elements[index] + shift;
+        window.lengths->elements[i - start] = from.lengths->elements[index];
+    }
+    return window;
+}
+
+static uint64_t hash_mix(uint64_t hash, uint64_t value) {
+    return (hash ^ value) * 0x100000001b3ull;
+}
+
+// a node's structural hash covers its tag, token, range and its children's hashes in order
+static uint64_t hash_node(uint8_t tag, uint32_t token, uint32_t start, uint32_t end, const uint64_t *child_hashes, const uint32_t *children, uint32_t num_children, uint32_t base) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = hash_mix(hash, tag);
+    hash = hash_mix(hash, token);
+    hash = hash_mix(hash, start);
+    hash = hash_mix(hash, end);
+    for (uint32_t i = 0; i < num_children; i++) {
+        hash = hash_mix(hash, child_hashes[children[i] - base]);
+    }
+    return hash;
+}
+
+// the old nodes that can be reused keyed by their structural hash with their tokens mapped past the edit
+typedef struct {
+    uint32_t mask;
+    uint64_t *hashes;
+    uint32_t *nodes;
+} reusable_t;
+
+static reusable_t find_reusable(cortecs_ast_t ast, token_map_t map, uint32_t first, uint32_t removed) {
+    uint32_t capacity = 16;
+    while (capacity < 2 * removed) {
+        capacity *= 2;
+    }
+    reusable_t reusable = {
+        .mask = capacity - 1,
+        .hashes = malloc(capacity * sizeof(uint64_t)),
+        .nodes = malloc(capacity * sizeof(uint32_t)),
+    };
+    memset(reusable.nodes, 0xFF, capacity * sizeof(uint32_t));
+
+    uint64_t *hashes = malloc((removed + 1) * sizeof(uint64_t));
+    bool *is_reusable = malloc((removed + 1) * sizeof(bool));
+    for (uint32_t i = 0; i < removed; i++) {
+        uint32_t node = first + i;
+        uint32_t num_children = ast.num_children->elements[node];
+        const uint32_t *children = ast.children->elements + ast.first_children->elements[node];
+        uint32_t token = map_token(map, ast.tokens->elements[node]);
+        uint32_t start = map_token(map, ast.token_starts->elements[node]);
+        uint32_t end = map_token_end(map, ast.token_ends->elements[node]);
+        is_reusable[i] = token != UINT32_MAX && start != UINT32_MAX && end != UINT32_MAX;
+        for (uint32_t j = 0; j < num_children; j++) {
+            is_reusable[i] = is_reusable[i] && is_reusable[children[j] - first];
+        }
+        if (!is_reusable[i]) {
+            continue;
+        }
+
+        hashes[i] = hash_node(ast.tags->elements[node], token, start, end, hashes, children, num_children, first);
+        uint32_t slot = (uint32_t)hashes[i] & reusable.mask;
+        while (reusable.nodes[slot] != UINT32_MAX) {
+            slot = (slot + 1) & reusable.mask;
+        }
+        reusable.hashes[slot] = hashes[i];
+        reusable.nodes[slot] = node;
+    }
+    free(hashes);
+    free(is_reusable);
+    return reusable;
+}
+
+// the old node that's identical to the inserted node. its children have already been matched
+static uint32_t find_identical(cortecs_ast_t ast, token_map_t map, reusable_t reusable, cortecs_ast_t inserted, uint32_t node, uint64_t hash, const uint32_t *reused) {
+    uint32_t num_children = inserted.num_children->elements[node];
+    const uint32_t *children = inserted.children->elements + inserted.first_children->elements[node];
+    for (uint32_t slot = (uint32_t)hash & reusable.mask; reusable.nodes[slot] != UINT32_MAX; slot = (slot + 1) & reusable.mask) {
+        uint32_t old = reusable.nodes[slot];
+        bool is_same_tokens = map_token(map, ast.tokens->elements[old]) == inserted.tokens->elements[node] && map_token(map, ast.token_starts->elements[old]) == inserted.token_starts->elements[node] && map_token_end(map, ast.token_ends->elements[old]) == inserted.token_ends->elements[node];
+        if (reusable.hashes[slot] != hash || ast.tags->elements[old] != inserted.tags->elements[node] || !is_same_tokens || ast.num_children->elements[old] != num_children) {
+            continue;
+        }
+
+        const uint32_t *old_children = ast.children->elements + ast.first_children->elements[old];
+        bool is_identical = true;
+        for (uint32_t i = 0; i < num_children && is_identical; i++) {
+            is_identical = reused[children[i] - inserted.root] == old_children[i];
+        }
+        if (is_identical) {
+            return old;
+        }
+    }
+    return UINT32_MAX;
+}
+
+// the old functions after the edit. an item that starts where one of them starts parses the same as before
+typedef struct {
+    uint32_t size;
+    uint32_t capacity;
+    // in the tokens after the edit
+    uint32_t *tokens;
+    uint32_t *items;
+} stops_t;
+
+cortecs_parser_reparse_t cortecs_parser_reparse(cortecs_ast_t ast, cortecs_lexer_tokens_t tokens, const char *bytes, cortecs_lexer_relex_t relex, cortecs_lexer_edit_t edit) {
+    token_map_t map = token_map(relex, edit);
+    uint32_t num_items = ast.num_children->elements[ast.root];
+    const uint32_t *items = ast.children->elements + ast.first_children->elements[ast.root];
+    uint32_t size = tokens.size + map.token_shift;
+
+    // parsing restarts at the last function that starts before the edit. functions are only parsed at the
+    // start of an item so the items before it parse the same
+    uint32_t restart_item = 0;
+    uint32_t high = num_items;
+    while (restart_item < high) {
+        uint32_t middle = restart_item + (high - restart_item) / 2;
+        if (ast.token_starts->elements[items[middle]] < map.start) {
+            restart_item = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    while (restart_item > 0 && ast.tags->elements[items[restart_item - 1]] != CORTECS_AST_FUNCTION) {
+        restart_item--;
+    }
+    uint32_t first_item = restart_item > 0 ? restart_item - 1 : 0;
+    uint32_t restart = restart_item > 0 ? ast.token_starts->elements[items[first_item]] : 0;
+    uint32_t first = first_item > 0 ? items[first_item - 1] + 1 : 0;
+
+    uint32_t stop_item = first_item;
+    while (stop_item < num_items && ast.token_starts->elements[items[stop_item]] < map.end) {
+        stop_item++;
+    }
+
+    // the window of tokens ends at a stop. it grows when the edit changes where items start
+    stops_t stops = {.size = 0, .capacity = 0, .tokens = NULL, .items = NULL};
+    parser_t parser;
+    bool is_stopped;
+    for (uint32_t num_stops = 1;; num_stops *= 4) {
+        stops.size = 0;
+        for (uint32_t item = stop_item; item < num_items && stops.size < num_stops; item++) {
+            if (ast.tags->elements[items[item]] != CORTECS_AST_FUNCTION) {
+                continue;
+            }
+            if (stops.size == stops.capacity) {
+                stops.capacity = stops.capacity * 2 + 16;
+                stops.tokens = realloc(stops.tokens, stops.capacity * sizeof(uint32_t));
+                stops.items = realloc(stops.items, stops.capacity * sizeof(uint32_t));
+            }
+            stops.tokens[stops.size] = ast.token_starts->elements[items[item]] + map.token_shift - restart;
+            stops.items[stops.size] = item;
+            stops.size++;
+        }
+        uint32_t end = stops.size == num_stops ? restart + stops.tokens[stops.size - 1] + 1 : size;
+
+        parser = init_parser(bytes, window_tokens(tokens, relex, map, restart, end));
+        parser.stops = stops.tokens;
+        parser.num_stops = stops.size;
+        is_stopped = parse_items(&parser);
+        if (is_stopped || end == size) {
+            break;
+        }
+        free(parser.stack.elements);
+        free(parser.children.elements);
+        free(parser.nodes.tags);
+        free(parser.nodes.tokens);
+        free(parser.nodes.token_starts);
+        free(parser.nodes.token_ends);
+        free(parser.nodes.first_children);
+        free(parser.nodes.num_children);
+    }
+    uint32_t last_item = is_stopped ? stops.items[parser.next_stop] : num_items;
+    free(stops.tokens);
+    free(stops.items);
+
+    cortecs_parser_reparse_t reparse = {
+        .first = first,
+        .removed = (last_item > 0 ? items[last_item - 1] + 1 : 0) - first,
+        .first_item = first_item,
+        .removed_items = last_item - first_item,
+        .inserted_items = cortecs_gc_alloc_array(CN(Cortecs, U32), parser.stack.size),
+    };
+    for (uint32_t i = 0; i < parser.stack.size; i++) {
+        reparse.inserted_items->elements[i] = parser.stack.elements[i] + first;
+    }
+
+    // number the nodes and tokens like the tree and tokens after the edit
+    cortecs_ast_t inserted = finish_ast(&parser);
+    for (uint32_t i = 0; i < inserted.size; i++) {
+        inserted.tokens->elements[i] += restart;
+        inserted.token_starts->elements[i] += restart;
+        inserted.token_ends->elements[i] += restart;
+    }
+    for (uint32_t i = 0; i < inserted.children->size; i++) {
+        inserted.children->elements[i] += first;
+    }
+    inserted.root = first;
+
+    reparse.reused = cortecs_gc_alloc_array(CN(Cortecs, U32), inserted.size);
+    reusable_t reusable = find_reusable(ast, map, first, reparse.removed);
+    uint64_t *hashes = malloc((inserted.size + 1) * sizeof(uint64_t));
+    uint32_t num_changed = 0;
+    for (uint32_t node = 0; node < inserted.size; node++) {
+        uint32_t num_children = inserted.num_children->elements[node];
+        const uint32_t *children = inserted.children->elements + inserted.first_children->elements[node];
+        hashes[node] = hash_node(inserted.tags->elements[node], inserted.tokens->elements[node], inserted.token_starts->elements[node], inserted.token_ends->elements[node], hashes, children, num_children, first);
+        reparse.reused->elements[node] = find_identical(ast, map, reusable, inserted, node, hashes[node], reparse.reused->elements);
+        num_changed += reparse.reused->elements[node] == UINT32_MAX;
+    }
+    free(hashes);
+    free(reusable.hashes);
+    free(reusable.nodes);
+
+    reparse.changed = cortecs_gc_alloc_array(CN(Cortecs, U32), num_changed);
+    num_changed = 0;
+    for (uint32_t node = 0; node < inserted.size; node++) {
+        if (reparse.reused->elements[node] == UINT32_MAX) {
+            reparse.changed->elements[num_changed] = node + first;
+            num_changed++;
+        }
+    }
+    inserted.root = UINT32_MAX;
+    reparse.inserted = inserted;
+    return reparse;
+}
+
+cortecs_ast_t cortecs_parser_apply(cortecs_ast_t ast, cortecs_lexer_relex_t relex, cortecs_parser_reparse_t reparse) {
+    cortecs_ast_t inserted = reparse.inserted;
+    uint32_t suffix_start = reparse.first + reparse.removed;
+    uint32_t suffix_size = ast.root - suffix_start;
+    uint32_t children_start = ast.first_children->elements[reparse.first];
+    uint32_t children_end = ast.first_children->elements[suffix_start];
+    uint32_t suffix_children = ast.first_children->elements[ast.root] - children_end;
+    uint32_t num_items = ast.num_children->elements[ast.root] - reparse.removed_items + reparse.inserted_items->size;
+    uint32_t size = ast.size - reparse.removed + inserted.size;
+    uint32_t num_children = children_start + inserted.children->size + suffix_children + num_items;
+
+    uint32_t num_errors = ast.num_errors + inserted.num_errors;
+    for (uint32_t node = reparse.first; node < suffix_start; node++) {
+        num_errors -= ast.tags->elements[node] == CORTECS_AST_ERROR;
+    }
+
+    cortecs_ast_t result = {
+        .size = size,
+        .root = size - 1,
+        .num_errors = num_errors,
+        .tags = cortecs_gc_alloc_array(CN(Cortecs, U8), size),
+        .tokens = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .token_starts = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .token_ends = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .first_children = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .num_children = cortecs_gc_alloc_array(CN(Cortecs, U32), size),
+        .children = cortecs_gc_alloc_array(CN(Cortecs, U32), num_children),
+    };
+
+    // the nodes before the edit, the inserted nodes, then the nodes after the edit moved past them
+    uint32_t offsets[3] = {0, reparse.first, reparse.first + inserted.size};
+    cortecs_ast_t from[3] = {ast, inserted, ast};
+    uint32_t from_starts[3] = {0, 0, suffix_start};
+    uint32_t sizes[3] = {reparse.first, inserted.size, suffix_size};
+    uint32_t token_shifts[3] = {0, 0, relex.inserted.size - relex.removed};
+    uint32_t node_shifts[3] = {0, 0, inserted.size - reparse.removed};
+    uint32_t children_offsets[3] = {0, children_start, children_start + inserted.children->size};
+    uint32_t children_from[3] = {0, 0, children_end};
+    uint32_t children_sizes[3] = {children_start, inserted.children->size, suffix_children};
+    for (uint32_t part = 0; part < 3; part++) {
+        uint32_t to = offsets[part];
+        uint32_t start = from_starts[part];
+        memcpy(result.tags->elements + to, from[part].tags->elements + start, sizes[part] * sizeof(uint8_t));
+        memcpy(result.num_children->elements + to, from[part].num_children->elements + start, sizes[part] * sizeof(uint32_t));
+        for (uint32_t i = 0; i < sizes[part]; i++) {
+            result.tokens->elements[to + i] = from[part].tokens->elements[start + i] + token_shifts[part];
+            result.token_starts->elements[to + i] = from[part].token_starts->elements[start + i] + token_shifts[part];
+            result.token_ends->elements[to + i] = from[part].token_ends->elements[start + i] + token_shifts[part];
+            result.first_children->elements[to + i] = from[part].first_children->elements[start + i] - children_from[part] + children_offsets[part];
+        }
+        for (uint32_t i = 0; i < children_sizes[part]; i++) {
+            result.children->elements[children_offsets[part] + i] = from[part].children->elements[children_from[part] + i] + node_shifts[part];
+        }
+    }
+
+    // the root's items are the items before the edit, the inserted items and the items after the edit
+    const uint32_t *items = ast.children->elements + ast.first_children->elements[ast.root];
+    uint32_t items_start = num_children - num_items;
+    uint32_t suffix_item = reparse.first_item + reparse.removed_items;
+    memcpy(result.children->elements + items_start, items, reparse.first_item * sizeof(uint32_t));
+    memcpy(result.children->elements + items_start + reparse.first_item, reparse.inserted_items->elements, reparse.inserted_items->size * sizeof(uint32_t));
+    for (uint32_t i = suffix_item; i < ast.num_children->elements[ast.root]; i++) {
+        result.children->elements[items_start + i - suffix_item + reparse.first_item + reparse.inserted_items->size] = items[i] + node_shifts[2];
+    }
+
+    result.tags->elements[result.root] = CORTECS_AST_FILE;
+    result.tokens->elements[result.root] = 0;
+    result.token_starts->elements[result.root] = 0;
+    result.token_ends->elements[result.root] = ast.token_ends->elements[ast.root] + token_shifts[2];
+    result.first_children->elements[result.root] = items_start;
+    result.num_children->elements[result.root] = num_items;
+    return result;
+}
+
+uint32_t cortecs_ast_child(cortecs_ast_t ast, uint32_t node, uint32_t index) {
+    assert(node < ast.size);
+    assert(index < ast.num_children->elements[node]);
+    return ast.children->elements[ast.first_children->elements[node] + index];
+}
+
+const char *cortecs_ast_tag_to_string(cortecs_ast_tag_t tag) {
+    switch (tag) {
+        case CORTECS_AST_FUNCTION:
+            return "function";
+        case CORTECS_AST_BODY:
+            return "body";
+        case CORTECS_AST_LET:
+            return "let";
+        case CORTECS_AST_RETURN:
+            return "return";
+        case CORTECS_AST_EXPRESSION:
+            return "expression";
+        case CORTECS_AST_UNARY:
+            return "unary";
+        case CORTECS_AST_ATOMIC:
+            return "atomic";
+        case CORTECS_AST_FUNCTION_CALL:
+            return "function_call";
+        case CORTECS_AST_BINARY:
+            return "binary";
+        case CORTECS_AST_BINARY_P1:
+            return "binary_p1";
+        case CORTECS_AST_BINARY_P2:
+            return "binary_p2";
+        case CORTECS_AST_BINARY_P3:
+            return "binary_p3";
+        case CORTECS_AST_BINARY_P4:
+            return "binary_p4";
+        case CORTECS_AST_BINARY_P5:
+            return "binary_p5";
+        case CORTECS_AST_FILE:
+            return "file";
+        case CORTECS_AST_PARAMETER:
+            return "parameter";
+        case CORTECS_AST_TYPE:
+            return "type";
+        case CORTECS_AST_TYPE_PARAMETER:
+            return "type_parameter";
+        case CORTECS_AST_ERROR:
+            return "error";
+    }
+    return "unknown";
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef CORTECS_PARSER_AST_ENTITIES_H
+#define CORTECS_PARSER_AST_ENTITIES_H
+
+#include <cortecs/parser.h>
+#include <cortecs/span.h>
+#include <flecs.h>
+#include <stdint.h>
+
+// A tree spawned as flecs entities so it can be edited in place. Every node is an entity
+// that's a ChildOf its parent and its cortecs_span_t is from where its parent starts to
+// where it starts. A node starts at its first token in cortecs_ast_t's token_starts, so
+// functions and lets start at their keyword. Since spans are relative, an edit only moves
+// the later children of the nodes around it and the nodes under those keep their spans. Absolute positions are computed for every node by walking
+// down from the roots.
+
+typedef struct {
+    cortecs_ast_tag_t tag;
+    // the number of ancestors. roots are 0
+    uint32_t depth;
+} cortecs_ast_node_t;
+extern ECS_COMPONENT_DECLARE(cortecs_ast_node_t);
+
+// where the node starts in the file as of the last resolve
+typedef struct {
+    cortecs_span_t start;
+} cortecs_ast_position_t;
+extern ECS_COMPONENT_DECLARE(cortecs_ast_position_t);
+
+// registers the components and the query. call after the world is initialized and cortecs_span_init
+void cortecs_ast_entities_init(void);
+
+// creates an entity for node and for every node under it. the entity is a child of parent
+// or of nothing when parent is 0 and span is from where parent starts to where node starts.
+// when parent isn't a node, like an entity for the file, node is a root and span is where it starts.
+// entities gets the entity of each node when it isn't NULL
+ecs_entity_t cortecs_ast_entities_spawn(cortecs_ast_t ast, cortecs_lexer_tokens_t tokens, uint32_t node, ecs_entity_t parent, cortecs_span_t span, ecs_entity_t *entities);
+
+// sets every node's cortecs_ast_position_t from the spans
+void cortecs_ast_entities_resolve(void);
+
+// moves the nodes after an edit in node, the deepest node around it. the text before old_end
+// now ends at new_end. positions are from the last resolve. only the children of node and
+// of its ancestors that start after the edit are updated. returns how many spans changed.
+// shift before spawning the nodes the edit inserted so they aren't moved
+uint32_t cortecs_ast_entities_shift(ecs_entity_t node, cortecs_span_t old_end, cortecs_span_t new_end);
+
+#endif
\ No newline at end of file
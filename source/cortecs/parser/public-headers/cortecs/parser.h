@@ -1,8 +1,10 @@
 #ifndef CORTECS_PARSER_PARSER_H
 #define CORTECS_PARSER_PARSER_H
 
+#include <cortecs/lexer.h>
 #include <cortecs/tokens.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef enum {
     CORTECS_AST_FUNCTION,
@@ -21,6 +23,97 @@ typedef enum {
     CORTECS_AST_BINARY_P3,
     CORTECS_AST_BINARY_P4,
     CORTECS_AST_BINARY_P5,
+
+    CORTECS_AST_FILE,
+    CORTECS_AST_PARAMETER,
+    CORTECS_AST_TYPE,
+    CORTECS_AST_TYPE_PARAMETER,
+    // a token the grammar doesn't allow. the parser skips to the end of the line
+    CORTECS_AST_ERROR,
 } cortecs_ast_tag_t;
 
+// Every node's token and children:
+// FILE           the first token           FUNCTION or ERROR nodes
+// FUNCTION       the name                  TYPE_PARAMETER nodes, PARAMETER nodes, the return TYPE if it has one and the BODY
+// TYPE_PARAMETER the type name
+// PARAMETER      the name                  the TYPE
+// TYPE           the type name             the TYPE of each type argument
+// BODY           the {                     LET, RETURN, expression or ERROR nodes
+// LET            the name                  the value
+// RETURN         return                    the value if it has one
+// EXPRESSION     the (                     the expression in the parentheses
+// UNARY          the operator              the operand
+// ATOMIC         the name or literal
+// FUNCTION_CALL  the name                  the TYPE of each type argument then the arguments
+// BINARY_Pn      the operator              the left and right operands
+// ERROR          the unexpected token or the number of tokens when the input ended early
+//
+// Binary operators are left associative. Their precedence comes from their first
+// character, from loosest to tightest:
+// P1  | ^ & ~
+// P2  = !
+// P3  < >
+// P4  + -
+// P5  * / % and every other operator
+// Prefix operators bind tighter than any binary operator. A newline ends an
+// expression unless it follows an operator. Operands or type arguments nested more than 256 deep are an ERROR.
+//
+// A < right after a called name is the start of type arguments when a type follows it and
+// the > closing it is followed by a (. Otherwise it's a comparison. Type arguments can have
+// type arguments of their own and a >> closes two lists. Type parameters are type names and
+// where constraints on them aren't parsed.
+
+// the nodes of a file stored by column like cortecs_lexer_tokens_t. nodes are addressed
+// by their index and each column is a single gc allocation. a node's children are
+// num_children entries of children starting at first_child. children come before
+// their parent so the root is the last node. a node's descendants are the nodes just before it
+typedef struct {
+    uint32_t size;
+    uint32_t root;
+    uint32_t num_errors;
+    CN(Cortecs, Array, CT(CN(Cortecs, U8))) tags;
+    // the index of each node's token in the token stream
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) tokens;
+    // each node covers the tokens [token_start, token_end) from its first keyword or operand to its
+    // last token. the file covers every token and an error covers its token
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) token_starts;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) token_ends;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) first_children;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) num_children;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) children;
+} cortecs_ast_t;
+
+// parses the tokens of bytes. the bytes are only read to tell operators apart
+cortecs_ast_t cortecs_parser_parse(const char *bytes, cortecs_lexer_tokens_t tokens);
+const char *cortecs_ast_tag_to_string(cortecs_ast_tag_t tag);
+// the index of the node's index-th child
+uint32_t cortecs_ast_child(cortecs_ast_t ast, uint32_t node, uint32_t index);
+
+// the old nodes [first, first + removed) are replaced by the inserted nodes and the old items of the
+// file, the root's children, [first_item, first_item + removed_items) are replaced by inserted_items.
+// the nodes after them are unchanged except their indexes move by the change in the number of nodes
+// and their tokens move by the change in the number of tokens. the root is always rebuilt
+typedef struct {
+    uint32_t first;
+    uint32_t removed;
+    uint32_t first_item;
+    uint32_t removed_items;
+    // numbered from first like they are in the tree after the edit. their tokens index the tokens after
+    // the edit. they aren't a single tree so root isn't set
+    cortecs_ast_t inserted;
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) inserted_items;
+    // the old node each inserted node is identical to or UINT32_MAX. identical nodes have the same tag,
+    // tokens and children so anything computed for the old node still holds
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) reused;
+    // the inserted nodes that aren't identical to an old node
+    CN(Cortecs, Array, CT(CN(Cortecs, U32))) changed;
+} cortecs_parser_reparse_t;
+
+// reparses the items of the file that an edit can change. tokens are the tokens before the edit and bytes
+// is the source after it. parsing starts at the last function before the edit and stops at the first
+// function after it that starts an item like it did before, so editing a function only reparses that function
+cortecs_parser_reparse_t cortecs_parser_reparse(cortecs_ast_t ast, cortecs_lexer_tokens_t tokens, const char *bytes, cortecs_lexer_relex_t relex, cortecs_lexer_edit_t edit);
+// the tree after the edit. copies every node so it's linear in the size of the file
+cortecs_ast_t cortecs_parser_apply(cortecs_ast_t ast, cortecs_lexer_relex_t relex, cortecs_parser_reparse_t reparse);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include <cortecs/gc.h>
+#include <cortecs/string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+static char *data(CN(Cortecs, String, Builder) *builder) {
+    if (builder->buffer == NULL) {
+        return builder->inline_buffer;
+    }
+    return builder->buffer->elements;
+}
+
+static uint32_t capacity(CN(Cortecs, String, Builder) *builder) {
+    if (builder->buffer == NULL) {
+        return CORTECS_STRING_INLINE_SIZE;
+    }
+    return builder->buffer->size;
+}
+
+// ensures there's room for additional bytes plus the null terminator
+static void reserve(CN(Cortecs, String, Builder) *builder, uint32_t additional) {
+    uint32_t required = builder->length + additional + 1;
+    uint32_t new_capacity = capacity(builder);
+    if (required <= new_capacity) {
+        return;
+    }
+
+    while (new_capacity < required) {
+        new_capacity *= 2;
+    }
+
+    // the old buffer is left for the gc to collect
+    CN(Cortecs, Array, CT(CN(Cortecs, Char))) buffer = cortecs_gc_alloc_array(CN(Cortecs, Char), new_capacity);
+    memcpy(buffer->elements, data(builder), builder->length);
+    builder->buffer = buffer;
+}
+
+CN(Cortecs, String, Builder) CN(Cortecs, String, Builder, new)(uint32_t capacity) {
+    CN(Cortecs, String, Builder) builder = {
+        .buffer = NULL,
+        .length = 0,
+    };
+
+    // + null terminator
+    if (capacity + 1 > CORTECS_STRING_INLINE_SIZE) {
+        builder.buffer = cortecs_gc_alloc_array(CN(Cortecs, Char), capacity + 1);
+    }
+    return builder;
+}
+
+void CN(Cortecs, String, Builder, append_bytes)(CN(Cortecs, String, Builder) *builder, const char *bytes, uint32_t length) {
+    reserve(builder, length);
+    memcpy(data(builder) + builder->length, bytes, length);
+    builder->length += length;
+}
+
+void CN(Cortecs, String, Builder, append_codepoint)(CN(Cortecs, String, Builder) *builder, uint32_t codepoint) {
+    char encoded[4];
+    uint32_t length;
+    if (codepoint < 0x80) {
+        encoded[0] = (char)codepoint;
+        length = 1;
+    } else if (codepoint < 0x800) {
+        encoded[0] = (char)(0xC0 | (codepoint >> 6));
+        encoded[1] = (char)(0x80 | (codepoint & 0x3F));
+        length = 2;
+    } else if (codepoint < 0x10000) {
+        encoded[0] = (char)(0xE0 | (codepoint >> 12));
+        encoded[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        encoded[2] = (char)(0x80 | (codepoint & 0x3F));
+        length = 3;
+    } else {
+        encoded[0] = (char)(0xF0 | (codepoint >> 18));
+        encoded[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        encoded[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        encoded[3] = (char)(0x80 | (codepoint & 0x3F));
+        length = 4;
+    }
+
+    // reserve only the encoded length so content that fits inline stays inline
+    CN(Cortecs, String, Builder, append_bytes)(builder, encoded, length);
+}
+
+void CN(Cortecs, String, Builder, append_format)(CN(Cortecs, String, Builder) *builder, const char *format, ...) {
+    va_list args_available;
+    va_list args_out;
+    va_start(args_available, format);
+    va_copy(args_out, args_available);
+
+    // format into the remaining capacity. this also measures the output
+    // there seems to be a bug in clang tidy that's false positive on this line
+    uint32_t available = capacity(builder) - builder->length;
+    int32_t size = vsnprintf(data(builder) + builder->length, available, format, args_available);  // NOLINT(clang-analyzer-valist.Uninitialized)
+    if (size < 0) {
+        // TODO encoding error. Have better error reporting
+        goto cleanup;
+    }
+
+    if ((uint32_t)size >= available) {
+        // the output was truncated. grow and format again
+        reserve(builder, size);
+        vsnprintf(data(builder) + builder->length, size + 1, format, args_out);
+    }
+    builder->length += size;
+
+cleanup:
+    va_end(args_available);
+    va_end(args_out);
+}
+
+void CN(Cortecs, String, Builder, append_string)(CN(Cortecs, String, Builder) *builder, CN(Cortecs, String) str) {
+    // don't copy the null terminator
+    CN(Cortecs, String, Builder, append_bytes)(builder, CN(Cortecs, String, cstr)(&str), CN(Cortecs, String, capacity)(str) - 1);
+}
+
+void CN(Cortecs, String, Builder, append_slice)(CN(Cortecs, String, Builder) *builder, CN(Cortecs, String, Slice) slice) {
+    CN(Cortecs, String, Builder, append_bytes)(builder, CN(Cortecs, String, Slice, bytes)(slice), slice.length);
+}
+
+CN(Cortecs, String) CN(Cortecs, String, Builder, finish)(CN(Cortecs, String, Builder) *builder) {
+    // reserve always leaves room for the null terminator
+    data(builder)[builder->length] = 0;
+
+    CN(Cortecs, String) ret;
+    if (builder->buffer == NULL) {
+        ret = (CN(Cortecs, String)){.inline_size = builder->length + 1};
+        memcpy(ret.inline_content, builder->inline_buffer, builder->length + 1);
+    } else {
+        // shrinking the size of the array hands the buffer over as the content of the string.
+        // the gc only uses the size to finalize elements which is a no-op for chars
+        builder->buffer->size = builder->length + 1;
+        ret = (CN(Cortecs, String)){.content = builder->buffer};
+    }
+
+    builder->buffer = NULL;
+    builder->length = 0;
+    return ret;
+}
\ No newline at end of file
@@ -0,0 +1,771 @@
+#include <cortecs/kernel.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CORTECS_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    CN(Cortecs, Kernel, Isa) isa;
+    bool (*equals)(const char *left, const char *right, uint32_t length);
+    bool (*validate_utf8)(const char *bytes, uint32_t length);
+    uint32_t (*count_codepoints)(const char *bytes, uint32_t length);
+    CN(Cortecs, Kernel, Lines) (*count_lines)(const char *bytes, uint32_t length);
+    uint32_t (*skip_either)(const uint8_t *bytes, uint32_t length, uint8_t first, uint8_t second);
+} kernel_table;
+
+// ====================================================================================================================
+// Scalar
+// ====================================================================================================================
+static uint64_t read64(const uint8_t *bytes) {
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static uint64_t read32(const uint8_t *bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+#define ASCII_MASK UINT64_C(0x8080808080808080)
+
+// returns the length of the utf-8 sequence at the start of bytes or 0 when it's invalid
+static uint32_t validate_sequence(const uint8_t *bytes, uint32_t remaining) {
+    uint8_t lead = bytes[0];
+    if (lead < 0x80) {
+        return 1;
+    }
+
+    // continuation bytes and overlong 2 byte sequences
+    if (lead < 0xC2) {
+        return 0;
+    }
+
+    if (lead < 0xE0) {
+        if (remaining < 2 || (bytes[1] & 0xC0) != 0x80) {
+            return 0;
+        }
+        return 2;
+    }
+
+    if (lead < 0xF0) {
+        if (remaining < 3 || (bytes[1] & 0xC0) != 0x80 || (bytes[2] & 0xC0) != 0x80) {
+            return 0;
+        }
+
+        // overlong
+        if (lead == 0xE0 && bytes[1] < 0xA0) {
+            return 0;
+        }
+
+        // surrogates
+        if (lead == 0xED && bytes[1] > 0x9F) {
+            return 0;
+        }
+        return 3;
+    }
+
+    if (lead < 0xF5) {
+        if (remaining < 4 || (bytes[1] & 0xC0) != 0x80 || (bytes[2] & 0xC0) != 0x80 || (bytes[3] & 0xC0) != 0x80) {
+            return 0;
+        }
+
+        // overlong
+        if (lead == 0xF0 && bytes[1] < 0x90) {
+            return 0;
+        }
+
+        // above U+10FFFF
+        if (lead == 0xF4 && bytes[1] > 0x8F) {
+            return 0;
+        }
+        return 4;
+    }
+
+    return 0;
+}
+
+// validates sequences from start until at least end. returns the offset it stopped at or length + 1 when invalid
+static uint32_t validate_until(const uint8_t *bytes, uint32_t start, uint32_t end, uint32_t length) {
+    uint32_t i = start;
+    while (i < end) {
+        uint32_t sequence_length = validate_sequence(bytes + i, length - i);
+        if (sequence_length == 0) {
+            return length + 1;
+        }
+        i += sequence_length;
+    }
+    return i;
+}
+
+// libc memcmp is already vectorized so the scalar kernel defers to it
+static bool equals_scalar(const char *left, const char *right, uint32_t length) {
+    return memcmp(left, right, length) == 0;
+}
+
+// compares inputs shorter than a vector with overlapping reads
+static bool equals_short(const uint8_t *left, const uint8_t *right, uint32_t length) {
+    if (length >= 8) {
+        return read64(left) == read64(right) && read64(left + length - 8) == read64(right + length - 8);
+    }
+    if (length >= 4) {
+        return read32(left) == read32(right) && read32(left + length - 4) == read32(right + length - 4);
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        if (left[i] != right[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool validate_utf8_scalar(const char *bytes, uint32_t length) {
+    const uint8_t *input = (const uint8_t *)bytes;
+    uint32_t i = 0;
+    while (i < length) {
+        if (i + 8 <= length && (read64(input + i) & ASCII_MASK) == 0) {
+            i += 8;
+            continue;
+        }
+
+        uint32_t sequence_length = validate_sequence(input + i, length - i);
+        if (sequence_length == 0) {
+            return false;
+        }
+        i += sequence_length;
+    }
+    return true;
+}
+
+static uint32_t count_codepoints_scalar(const char *bytes, uint32_t length) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        count += ((uint8_t)bytes[i] & 0xC0) != 0x80;
+    }
+    return count;
+}
+
+static CN(Cortecs, Kernel, Lines) count_lines_scalar(const char *bytes, uint32_t length) {
+    CN(Cortecs, Kernel, Lines) lines = {.newlines = 0, .columns = 0};
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t current_byte = bytes[i];
+        if (current_byte == '\n') {
+            lines.newlines++;
+            lines.columns = 0;
+            continue;
+        }
+        lines.columns += (current_byte & 0xC0) != 0x80;
+    }
+    return lines;
+}
+
+static uint32_t skip_either_scalar(const uint8_t *bytes, uint32_t length, uint8_t first, uint8_t second) {
+    uint32_t i = 0;
+    while (i < length && (bytes[i] == first || bytes[i] == second)) {
+        i++;
+    }
+    return i;
+}
+
+static const kernel_table scalar_table = {
+    .isa = CORTECS_KERNEL_ISA_SCALAR,
+    .equals = equals_scalar,
+    .validate_utf8 = validate_utf8_scalar,
+    .count_codepoints = count_codepoints_scalar,
+    .count_lines = count_lines_scalar,
+    .skip_either = skip_either_scalar,
+};
+
+#ifdef CORTECS_KERNEL_X86
+// ====================================================================================================================
+// SSE2
+// ====================================================================================================================
+// continuation bytes are 0x80-0xBF which are -128 to -65 as signed bytes
+#define LAST_CONTINUATION_BYTE -65
+
+__attribute__((target("sse2"))) static bool blocks_equal_sse2(const char *left, const char *right) {
+    __m128i left_block = _mm_loadu_si128((const __m128i *)left);
+    __m128i right_block = _mm_loadu_si128((const __m128i *)right);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(left_block, right_block)) == 0xFFFF;
+}
+
+__attribute__((target("sse2"))) static bool equals_sse2(const char *left, const char *right, uint32_t length) {
+    if (length < 16) {
+        return equals_short((const uint8_t *)left, (const uint8_t *)right, length);
+    }
+
+    uint32_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(left + i)), _mm_loadu_si128((const __m128i *)(right + i)));
+        for (uint32_t j = 16; j < 64; j += 16) {
+            __m128i left_block = _mm_loadu_si128((const __m128i *)(left + i + j));
+            __m128i right_block = _mm_loadu_si128((const __m128i *)(right + i + j));
+            equal = _mm_and_si128(equal, _mm_cmpeq_epi8(left_block, right_block));
+        }
+        if (_mm_movemask_epi8(equal) != 0xFFFF) {
+            return false;
+        }
+    }
+    for (; i + 16 <= length; i += 16) {
+        if (!blocks_equal_sse2(left + i, right + i)) {
+            return false;
+        }
+    }
+
+    // the last block overlaps the previous one
+    return i == length || blocks_equal_sse2(left + length - 16, right + length - 16);
+}
+
+__attribute__((target("sse2"))) static bool validate_utf8_sse2(const char *bytes, uint32_t length) {
+    const uint8_t *input = (const uint8_t *)bytes;
+    uint32_t i = 0;
+    while (i + 16 <= length) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(input + i));
+        if (_mm_movemask_epi8(block) == 0) {
+            i += 16;
+            continue;
+        }
+
+        // sequences can cross the end of the block so validate until the next sequence starts after it
+        i = validate_until(input, i, i + 16, length);
+        if (i > length) {
+            return false;
+        }
+    }
+    return validate_until(input, i, length, length) <= length;
+}
+
+__attribute__((target("sse2"))) static uint32_t count_codepoints_sse2(const char *bytes, uint32_t length) {
+    __m128i last_continuation_byte = _mm_set1_epi8(LAST_CONTINUATION_BYTE);
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(block, last_continuation_byte)));
+    }
+    return count + count_codepoints_scalar(bytes + i, length - i);
+}
+
+// the vector kernels count newlines over the whole input then search backwards for the last one.
+// only the last line is read twice
+static uint32_t count_newlines_scalar(const char *bytes, uint32_t length) {
+    uint32_t newlines = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        newlines += bytes[i] == '\n';
+    }
+    return newlines;
+}
+
+// the offset after the last newline in the first length bytes or 0 when there isn't one
+static uint32_t last_line_start_scalar(const char *bytes, uint32_t length) {
+    while (length > 0 && bytes[length - 1] != '\n') {
+        length--;
+    }
+    return length;
+}
+
+// byte counters overflow after 255 blocks
+#define MAX_BLOCKS_PER_COUNT 255
+
+__attribute__((target("sse2"))) static CN(Cortecs, Kernel, Lines) count_lines_sse2(const char *bytes, uint32_t length) {
+    __m128i newline = _mm_set1_epi8('\n');
+    uint32_t newlines = 0;
+    uint32_t i = 0;
+    while (i + 16 <= length) {
+        uint32_t blocks = (length - i) / 16;
+        uint32_t end = i + 16 * (blocks < MAX_BLOCKS_PER_COUNT ? blocks : MAX_BLOCKS_PER_COUNT);
+        __m128i counts = _mm_setzero_si128();
+        for (; i < end; i += 16) {
+            __m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+            counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(block, newline));
+        }
+        __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+        newlines += _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+    }
+    newlines += count_newlines_scalar(bytes + i, length - i);
+
+    uint32_t line_start = 0;
+    if (newlines > 0) {
+        uint32_t end = length;
+        for (; end >= 16; end -= 16) {
+            __m128i block = _mm_loadu_si128((const __m128i *)(bytes + end - 16));
+            uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+            if (mask != 0) {
+                line_start = end - 16 + (32 - __builtin_clz(mask));
+                break;
+            }
+        }
+        if (end < 16) {
+            line_start = last_line_start_scalar(bytes, end);
+        }
+    }
+
+    return (CN(Cortecs, Kernel, Lines)){
+        .newlines = newlines,
+        .columns = count_codepoints_sse2(bytes + line_start, length - line_start),
+    };
+}
+
+__attribute__((target("sse2"))) static uint32_t skip_either_sse2(const uint8_t *bytes, uint32_t length, uint8_t first, uint8_t second) {
+    __m128i firsts = _mm_set1_epi8(first);
+    __m128i seconds = _mm_set1_epi8(second);
+    uint32_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+        __m128i skipped = _mm_or_si128(_mm_cmpeq_epi8(block, firsts), _mm_cmpeq_epi8(block, seconds));
+        uint32_t mask = _mm_movemask_epi8(skipped) ^ 0xFFFF;
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + skip_either_scalar(bytes + i, length - i, first, second);
+}
+
+static const kernel_table sse2_table = {
+    .isa = CORTECS_KERNEL_ISA_SSE2,
+    .equals = equals_sse2,
+    .validate_utf8 = validate_utf8_sse2,
+    .count_codepoints = count_codepoints_sse2,
+    .count_lines = count_lines_sse2,
+    .skip_either = skip_either_sse2,
+};
+
+// ====================================================================================================================
+// AVX2
+// ====================================================================================================================
+__attribute__((target("avx2"))) static bool blocks_equal_avx2(const char *left, const char *right) {
+    __m256i left_block = _mm256_loadu_si256((const __m256i *)left);
+    __m256i right_block = _mm256_loadu_si256((const __m256i *)right);
+    __m256i difference = _mm256_xor_si256(left_block, right_block);
+    return _mm256_testz_si256(difference, difference);
+}
+
+__attribute__((target("avx2"))) static bool equals_avx2(const char *left, const char *right, uint32_t length) {
+    if (length < 32) {
+        return equals_sse2(left, right, length);
+    }
+
+    uint32_t i = 0;
+    for (; i + 128 <= length; i += 128) {
+        __m256i difference = _mm256_setzero_si256();
+        for (uint32_t j = 0; j < 128; j += 32) {
+            __m256i left_block = _mm256_loadu_si256((const __m256i *)(left + i + j));
+            __m256i right_block = _mm256_loadu_si256((const __m256i *)(right + i + j));
+            difference = _mm256_or_si256(difference, _mm256_xor_si256(left_block, right_block));
+        }
+        if (!_mm256_testz_si256(difference, difference)) {
+            return false;
+        }
+    }
+    for (; i + 32 <= length; i += 32) {
+        if (!blocks_equal_avx2(left + i, right + i)) {
+            return false;
+        }
+    }
+
+    // the last block overlaps the previous one
+    return i == length || blocks_equal_avx2(left + length - 32, right + length - 32);
+}
+
+// Validates 32 bytes at a time with the lookup tables from
+// "Validating UTF-8 In Less Than One Instruction Per Byte" (Keiser, Lemire).
+// each pair of adjacent bytes is classified by the high nibble of the first byte, the low nibble
+// of the first byte and the high nibble of the second byte. a bit that survives all three lookups is an error.
+#define UTF8_TOO_SHORT (1 << 0)
+#define UTF8_TOO_LONG (1 << 1)
+#define UTF8_OVERLONG_3 (1 << 2)
+#define UTF8_TOO_LARGE (1 << 3)
+#define UTF8_SURROGATE (1 << 4)
+#define UTF8_OVERLONG_2 (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4 (1 << 6)
+#define UTF8_TWO_CONTINUATIONS (1 << 7)
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTINUATIONS)
+
+#define UTF8_TABLE(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+
+// the previous block's last n bytes followed by this block's first 32 - n bytes
+#define UTF8_PREVIOUS(input, previous_input, n) \
+    _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous_input, input, 0x21), 16 - n)
+
+__attribute__((target("avx2"))) static __m256i high_nibbles_avx2(__m256i input) {
+    return _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F));
+}
+
+__attribute__((target("avx2"))) static __m256i utf8_errors_avx2(__m256i input, __m256i previous_input) {
+    __m256i previous1 = UTF8_PREVIOUS(input, previous_input, 1);
+
+    __m256i byte_1_high_table = UTF8_TABLE(
+        // 0xxx ascii
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        // 10xx continuation
+        UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS,
+        // 1100 two byte lead
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        // 1101 two byte lead
+        UTF8_TOO_SHORT,
+        // 1110 three byte lead
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        // 1111 four byte lead
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+    );
+    __m256i byte_1_low_table = UTF8_TABLE(
+        // xxxx0000
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+        // xxxx0001
+        UTF8_CARRY | UTF8_OVERLONG_2,
+        // xxxx001x
+        UTF8_CARRY, UTF8_CARRY,
+        // xxxx0100
+        UTF8_CARRY | UTF8_TOO_LARGE,
+        // xxxx0101 - xxxx1100
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        // xxxx1101
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+        // xxxx111x
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+    );
+    __m256i byte_2_high_table = UTF8_TABLE(
+        // 0xxx ascii
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        // 1000 continuation
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        // 1001 continuation
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+        // 101x continuation
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        // 11xx lead
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+    );
+
+    __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table, high_nibbles_avx2(previous1));
+    __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(previous1, _mm256_set1_epi8(0x0F)));
+    __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table, high_nibbles_avx2(input));
+    __m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    // the third and fourth bytes of a sequence have to be continuations. two adjacent continuations are only
+    // valid in those positions so the flags cancel out the TWO_CONTINUATIONS bit
+    __m256i previous2 = UTF8_PREVIOUS(input, previous_input, 2);
+    __m256i previous3 = UTF8_PREVIOUS(input, previous_input, 3);
+    __m256i is_third_byte = _mm256_subs_epu8(previous2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i is_fourth_byte = _mm256_subs_epu8(previous3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+// non zero when the block ends in the middle of a sequence
+__attribute__((target("avx2"))) static __m256i utf8_incomplete_avx2(__m256i input) {
+    __m256i max_complete = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1)
+    );
+    return _mm256_subs_epu8(input, max_complete);
+}
+
+__attribute__((target("avx2"))) static bool validate_utf8_avx2(const char *bytes, uint32_t length) {
+    __m256i errors = _mm256_setzero_si256();
+    __m256i previous_input = _mm256_setzero_si256();
+    __m256i previous_incomplete = _mm256_setzero_si256();
+
+    uint32_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i *)(bytes + i));
+        if (_mm256_movemask_epi8(input) == 0) {
+            // ascii only has to check that the previous block didn't end in the middle of a sequence
+            errors = _mm256_or_si256(errors, previous_incomplete);
+        } else {
+            errors = _mm256_or_si256(errors, utf8_errors_avx2(input, previous_input));
+            previous_incomplete = utf8_incomplete_avx2(input);
+        }
+        previous_input = input;
+    }
+
+    // the tail is padded with nulls which are ascii and end any incomplete sequence with a TOO_SHORT error
+    uint8_t tail[32] = {0};
+    memcpy(tail, bytes + i, length - i);
+    __m256i input = _mm256_loadu_si256((const __m256i *)tail);
+    errors = _mm256_or_si256(errors, utf8_errors_avx2(input, previous_input));
+    return _mm256_testz_si256(errors, errors);
+}
+
+__attribute__((target("avx2,popcnt"))) static uint32_t count_codepoints_avx2(const char *bytes, uint32_t length) {
+    __m256i last_continuation_byte = _mm256_set1_epi8(LAST_CONTINUATION_BYTE);
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(bytes + i));
+        count += __builtin_popcount((uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(block, last_continuation_byte)));
+    }
+    return count + count_codepoints_sse2(bytes + i, length - i);
+}
+
+__attribute__((target("avx2,popcnt"))) static CN(Cortecs, Kernel, Lines) count_lines_avx2(const char *bytes, uint32_t length) {
+    __m256i newline = _mm256_set1_epi8('\n');
+    uint32_t newlines = 0;
+    uint32_t i = 0;
+    while (i + 32 <= length) {
+        uint32_t blocks = (length - i) / 32;
+        uint32_t end = i + 32 * (blocks < MAX_BLOCKS_PER_COUNT ? blocks : MAX_BLOCKS_PER_COUNT);
+        __m256i counts = _mm256_setzero_si256();
+        for (; i < end; i += 32) {
+            __m256i block = _mm256_loadu_si256((const __m256i *)(bytes + i));
+            counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(block, newline));
+        }
+        __m256i sums = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+        __m128i halves = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+        newlines += _mm_cvtsi128_si32(halves) + _mm_extract_epi16(halves, 4);
+    }
+    newlines += count_newlines_scalar(bytes + i, length - i);
+
+    uint32_t line_start = 0;
+    if (newlines > 0) {
+        uint32_t end = length;
+        for (; end >= 32; end -= 32) {
+            __m256i block = _mm256_loadu_si256((const __m256i *)(bytes + end - 32));
+            uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline));
+            if (mask != 0) {
+                line_start = end - 32 + (32 - __builtin_clz(mask));
+                break;
+            }
+        }
+        if (end < 32) {
+            line_start = last_line_start_scalar(bytes, end);
+        }
+    }
+
+    return (CN(Cortecs, Kernel, Lines)){
+        .newlines = newlines,
+        .columns = count_codepoints_avx2(bytes + line_start, length - line_start),
+    };
+}
+
+__attribute__((target("avx2"))) static uint32_t skip_either_avx2(const uint8_t *bytes, uint32_t length, uint8_t first, uint8_t second) {
+    __m256i firsts = _mm256_set1_epi8(first);
+    __m256i seconds = _mm256_set1_epi8(second);
+    uint32_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(bytes + i));
+        __m256i skipped = _mm256_or_si256(_mm256_cmpeq_epi8(block, firsts), _mm256_cmpeq_epi8(block, seconds));
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(skipped);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + skip_either_sse2(bytes + i, length - i, first, second);
+}
+
+static const kernel_table avx2_table = {
+    .isa = CORTECS_KERNEL_ISA_AVX2,
+    .equals = equals_avx2,
+    .validate_utf8 = validate_utf8_avx2,
+    .count_codepoints = count_codepoints_avx2,
+    .count_lines = count_lines_avx2,
+    .skip_either = skip_either_avx2,
+};
+#endif
+
+// ====================================================================================================================
+// Dispatch
+// ====================================================================================================================
+// published with release and read with acquire so a thread that sees a table sees its contents
+static const kernel_table *_Atomic table;
+
+static bool is_supported(CN(Cortecs, Kernel, Isa) isa) {
+    switch (isa) {
+        case CORTECS_KERNEL_ISA_SCALAR:
+            return true;
+#ifdef CORTECS_KERNEL_X86
+        case CORTECS_KERNEL_ISA_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case CORTECS_KERNEL_ISA_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+        default:
+            return false;
+    }
+}
+
+CN(Cortecs, Kernel, Isa) CN(Cortecs, Kernel, detect_isa)() {
+    if (is_supported(CORTECS_KERNEL_ISA_AVX2)) {
+        return CORTECS_KERNEL_ISA_AVX2;
+    }
+    if (is_supported(CORTECS_KERNEL_ISA_SSE2)) {
+        return CORTECS_KERNEL_ISA_SSE2;
+    }
+    return CORTECS_KERNEL_ISA_SCALAR;
+}
+
+bool CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, Isa) isa) {
+    if (!is_supported(isa)) {
+        return false;
+    }
+
+    const kernel_table *chosen;
+    switch (isa) {
+#ifdef CORTECS_KERNEL_X86
+        case CORTECS_KERNEL_ISA_AVX2:
+            chosen = &avx2_table;
+            break;
+        case CORTECS_KERNEL_ISA_SSE2:
+            chosen = &sse2_table;
+            break;
+#endif
+        default:
+            chosen = &scalar_table;
+            break;
+    }
+    atomic_store_explicit(&table, chosen, memory_order_release);
+    return true;
+}
+
+// the table is chosen the first time a kernel is called.
+// threads that race here all store the detected table
+static const kernel_table *get_table() {
+    const kernel_table *current = atomic_load_explicit(&table, memory_order_acquire);
+    if (current == NULL) {
+        CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, detect_isa)());
+        current = atomic_load_explicit(&table, memory_order_acquire);
+    }
+    return current;
+}
+
+CN(Cortecs, Kernel, Isa) CN(Cortecs, Kernel, isa)() {
+    return get_table()->isa;
+}
+
+const char *CN(Cortecs, Kernel, isa_name)(CN(Cortecs, Kernel, Isa) isa) {
+    switch (isa) {
+        case CORTECS_KERNEL_ISA_SCALAR:
+            return "scalar";
+        case CORTECS_KERNEL_ISA_SSE2:
+            return "sse2";
+        case CORTECS_KERNEL_ISA_AVX2:
+            return "avx2";
+        default:
+            return "unknown";
+    }
+}
+
+bool CN(Cortecs, Kernel, equals)(const char *left, const char *right, uint32_t length) {
+    return get_table()->equals(left, right, length);
+}
+
+bool CN(Cortecs, Kernel, validate_utf8)(const char *bytes, uint32_t length) {
+    return get_table()->validate_utf8(bytes, length);
+}
+
+uint32_t CN(Cortecs, Kernel, count_codepoints)(const char *bytes, uint32_t length) {
+    return get_table()->count_codepoints(bytes, length);
+}
+
+CN(Cortecs, Kernel, Lines) CN(Cortecs, Kernel, count_lines)(const char *bytes, uint32_t length) {
+    return get_table()->count_lines(bytes, length);
+}
+
+uint32_t CN(Cortecs, Kernel, skip_either)(const uint8_t *bytes, uint32_t length, uint8_t first, uint8_t second) {
+    return get_table()->skip_either(bytes, length, first, second);
+}
+
+// ====================================================================================================================
+// Hash
+// ====================================================================================================================
+#define HASH_P0 UINT64_C(0xa0761d6478bd642f)
+#define HASH_P1 UINT64_C(0xe7037ed1a0b428db)
+#define HASH_P2 UINT64_C(0x8ebc6af09c88c6e3)
+#define HASH_P3 UINT64_C(0x589965cc75374cc3)
+
+// 64x64 -> 128 bit multiply. returns the low bits in left and the high bits in right
+static void multiply(uint64_t *left, uint64_t *right) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t)*left * *right;
+    *left = (uint64_t)product;
+    *right = (uint64_t)(product >> 64);
+#else
+    uint64_t left_high = *left >> 32;
+    uint64_t left_low = (uint32_t)*left;
+    uint64_t right_high = *right >> 32;
+    uint64_t right_low = (uint32_t)*right;
+    uint64_t high_high = left_high * right_high;
+    uint64_t high_low = left_high * right_low;
+    uint64_t low_high = left_low * right_high;
+    uint64_t low_low = left_low * right_low;
+    uint64_t middle = (low_low >> 32) + (uint32_t)high_low + (uint32_t)low_high;
+    *left = (middle << 32) | (uint32_t)low_low;
+    *right = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+#endif
+}
+
+static uint64_t mix(uint64_t left, uint64_t right) {
+    multiply(&left, &right);
+    return left ^ right;
+}
+
+uint64_t CN(Cortecs, Kernel, hash)(const char *bytes, uint32_t length, uint64_t seed) {
+    const uint8_t *input = (const uint8_t *)bytes;
+    seed ^= mix(seed ^ HASH_P0, HASH_P1);
+
+    uint64_t left;
+    uint64_t right;
+    if (length <= 16) {
+        if (length >= 4) {
+            // overlapping reads cover every byte
+            uint32_t middle = (length >> 3) << 2;
+            left = (read32(input) << 32) | read32(input + middle);
+            right = (read32(input + length - 4) << 32) | read32(input + length - 4 - middle);
+        } else if (length > 0) {
+            left = ((uint64_t)input[0] << 16) | ((uint64_t)input[length >> 1] << 8) | input[length - 1];
+            right = 0;
+        } else {
+            left = 0;
+            right = 0;
+        }
+    } else {
+        uint32_t remaining = length;
+        if (remaining > 48) {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do {
+                seed = mix(read64(input) ^ HASH_P1, read64(input + 8) ^ seed);
+                seed1 = mix(read64(input + 16) ^ HASH_P2, read64(input + 24) ^ seed1);
+                seed2 = mix(read64(input + 32) ^ HASH_P3, read64(input + 40) ^ seed2);
+                input += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (remaining > 16) {
+            seed = mix(read64(input) ^ HASH_P1, read64(input + 8) ^ seed);
+            input += 16;
+            remaining -= 16;
+        }
+
+        // the last 16 bytes overlap the previous block when remaining < 16
+        left = read64(input + remaining - 16);
+        right = read64(input + remaining - 8);
+    }
+
+    left ^= HASH_P1;
+    right ^= seed;
+    multiply(&left, &right);
+    return mix(left ^ HASH_P0 ^ length, right ^ HASH_P1);
+}
\ No newline at end of file
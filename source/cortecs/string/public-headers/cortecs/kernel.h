@@ -0,0 +1,47 @@
+#ifndef CORTECS_STRING_KERNEL_H
+#define CORTECS_STRING_KERNEL_H
+
+#include <cortecs/mangle.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Byte level string kernels used under strings, symbols and spans.
+// equals, validate_utf8, count_codepoints, count_lines and skip_either have SSE2 and AVX2
+// implementations on x86 that are chosen at runtime by the cpu features.
+// Every implementation produces the same results as the scalar one.
+
+typedef enum {
+    CORTECS_KERNEL_ISA_SCALAR,
+    CORTECS_KERNEL_ISA_SSE2,
+    CORTECS_KERNEL_ISA_AVX2,
+} CN(Cortecs, Kernel, Isa);
+
+// the best instruction set supported by the cpu
+CN(Cortecs, Kernel, Isa) CN(Cortecs, Kernel, detect_isa)();
+CN(Cortecs, Kernel, Isa) CN(Cortecs, Kernel, isa)();
+// used by tests and benchmarks to compare implementations.
+// returns false when the cpu doesn't support the instruction set
+bool CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, Isa) isa);
+const char *CN(Cortecs, Kernel, isa_name)(CN(Cortecs, Kernel, Isa) isa);
+
+// compares exactly length bytes. doesn't stop at null terminators
+bool CN(Cortecs, Kernel, equals)(const char *left, const char *right, uint32_t length);
+// wyhash style 64 bit hash. the same on every instruction set
+uint64_t CN(Cortecs, Kernel, hash)(const char *bytes, uint32_t length, uint64_t seed);
+// rejects overlong encodings, surrogates, codepoints above U+10FFFF and truncated sequences
+bool CN(Cortecs, Kernel, validate_utf8)(const char *bytes, uint32_t length);
+// counts the bytes that aren't continuation bytes. bytes is assumed to be valid utf-8
+uint32_t CN(Cortecs, Kernel, count_codepoints)(const char *bytes, uint32_t length);
+
+typedef struct {
+    uint32_t newlines;
+    // codepoints after the last newline
+    uint32_t columns;
+} CN(Cortecs, Kernel, Lines);
+
+// counts newlines and the codepoints after the last newline in one pass. bytes is assumed to be valid utf-8
+CN(Cortecs, Kernel, Lines) CN(Cortecs, Kernel, count_lines)(const char *bytes, uint32_t length);
+// the index of the first byte that is neither first nor second or length when every byte is
+uint32_t CN(Cortecs, Kernel, skip_either)(const uint8_t *bytes, uint32_t length, uint8_t first, uint8_t second);
+
+#endif
\ No newline at end of file
@@ -9,12 +9,93 @@
 // Strings are encoded using utf-8 to support unicode and
 // maintain compatibility with C/OS api that expect ascii encoding.
 
+// Short strings are stored inline in the string value instead of being gc
+// allocated. The inline content shares storage with the content pointer so
+// strings must be read through the accessors below instead of content.
+#define CORTECS_STRING_INLINE_SIZE 15
+
 typedef struct CN(Cortecs, String) {
-    CN(Cortecs, Array, CT(CN(Cortecs, Char))) content;
+    union {
+        struct {
+            CN(Cortecs, Array, CT(CN(Cortecs, Char))) content;
+            uint8_t padding[CORTECS_STRING_INLINE_SIZE - sizeof(void *)];
+            // 0 when the content is gc allocated.
+            // otherwise the size of the inline content including the null terminator
+            uint8_t inline_size;
+        };
+        // null terminated
+        char inline_content[CORTECS_STRING_INLINE_SIZE];
+    };
 } CN(Cortecs, String);
 
+// formats into a thread local scratch buffer and only formats a second time
+// when the output doesn't fit in the scratch buffer
 CN(Cortecs, String) CN(Cortecs, String, new)(const char *format, ...);
+
+// copies exactly length bytes and null terminates. bytes doesn't need to be null terminated
+CN(Cortecs, String) CN(Cortecs, String, from_bytes)(const char *bytes, uint32_t length);
+CN(Cortecs, String) CN(Cortecs, String, from_cstr)(const char *cstr);
+// size of the content including the null terminator
 uint32_t CN(Cortecs, String, capacity)(CN(Cortecs, String) str);
 bool CN(Cortecs, String, equals)(CN(Cortecs, String) left, CN(Cortecs, String) right);
+bool CN(Cortecs, String, is_null)(CN(Cortecs, String) str);
+bool CN(Cortecs, String, is_inline)(CN(Cortecs, String) str);
+// takes a pointer because inline content lives in the string value
+const char *CN(Cortecs, String, cstr)(const CN(Cortecs, String) *str);
+
+// registers the finalizers of the string types
+void CN(Cortecs, String, init)();
+
+// A range of bytes in the content of a string that shares the content
+// instead of copying it. A slice holds a reference to the content like any
+// other gc pointer: storing a slice in a gc allocation must inc the content
+// and the slice finalizer decs the content when the allocation is collected.
+// Slices aren't null terminated.
+typedef struct CN(Cortecs, String, Slice) {
+    CN(Cortecs, Array, CT(CN(Cortecs, Char))) content;
+    uint32_t offset;
+    uint32_t length;
+} CN(Cortecs, String, Slice);
+
+#define TYPE_PARAM_T CN(Cortecs, String, Slice)
+#include <cortecs/array.template.h>
+#include <cortecs/ptr.template.h>
+#undef TYPE_PARAM_T
+
+extern cortecs_finalizer_declare(CN(Cortecs, String, Slice));
+
+// functions that take slices accept owned strings through as_slice.
+// inline strings have no gc content to share so they're copied into a new allocation
+CN(Cortecs, String, Slice) CN(Cortecs, String, as_slice)(CN(Cortecs, String) str);
+CN(Cortecs, String, Slice) CN(Cortecs, String, slice)(CN(Cortecs, String) str, uint32_t offset, uint32_t length);
+CN(Cortecs, String, Slice) CN(Cortecs, String, Slice, slice)(CN(Cortecs, String, Slice) slice, uint32_t offset, uint32_t length);
+const char *CN(Cortecs, String, Slice, bytes)(CN(Cortecs, String, Slice) slice);
+bool CN(Cortecs, String, Slice, equals)(CN(Cortecs, String, Slice) left, CN(Cortecs, String, Slice) right);
+// copies the slice into a new null terminated string
+CN(Cortecs, String) CN(Cortecs, String, Slice, to_string)(CN(Cortecs, String, Slice) slice);
+
+// Builds a string incrementally in a gc allocated buffer.
+// The buffer grows geometrically and is handed over as the content
+// of the final string by finish, so the built string is never copied.
+// Replaced buffers are collected along with other temporary allocations.
+// Content that fits in an inline string is built without allocating.
+typedef struct CN(Cortecs, String, Builder) {
+    // NULL until the content outgrows the inline buffer.
+    // size is the capacity of the builder, not the length of the string
+    CN(Cortecs, Array, CT(CN(Cortecs, Char))) buffer;
+    uint32_t length;
+    char inline_buffer[CORTECS_STRING_INLINE_SIZE];
+} CN(Cortecs, String, Builder);
+
+// capacity is a hint for the number of bytes that will be appended
+CN(Cortecs, String, Builder) CN(Cortecs, String, Builder, new)(uint32_t capacity);
+void CN(Cortecs, String, Builder, append_bytes)(CN(Cortecs, String, Builder) *builder, const char *bytes, uint32_t length);
+// encodes the codepoint as utf-8
+void CN(Cortecs, String, Builder, append_codepoint)(CN(Cortecs, String, Builder) *builder, uint32_t codepoint);
+void CN(Cortecs, String, Builder, append_format)(CN(Cortecs, String, Builder) *builder, const char *format, ...);
+void CN(Cortecs, String, Builder, append_string)(CN(Cortecs, String, Builder) *builder, CN(Cortecs, String) str);
+void CN(Cortecs, String, Builder, append_slice)(CN(Cortecs, String, Builder) *builder, CN(Cortecs, String, Slice) slice);
+// the builder must not be used after finishing
+CN(Cortecs, String) CN(Cortecs, String, Builder, finish)(CN(Cortecs, String, Builder) *builder);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef CORTECS_STRING_SYMBOL_H
+#define CORTECS_STRING_SYMBOL_H
+
+#include <cortecs/mangle.h>
+#include <cortecs/string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Symbols are interned utf-8 strings. Interning the same text always returns
+// the same entry, so symbols are compared by pointer and the hash is computed
+// once when the text is first interned.
+//
+// The symbol table is a global hash table split into independently locked
+// shards so that it can be used from multiple threads. Entries aren't gc
+// allocated and live until the symbol table is cleaned up.
+
+typedef struct CN(Cortecs, Symbol, Entry) {
+    uint64_t hash;
+    uint32_t length;
+    // null terminated
+    char bytes[];
+} CN(Cortecs, Symbol, Entry);
+
+typedef struct CN(Cortecs, Symbol) {
+    const CN(Cortecs, Symbol, Entry) *entry;
+} CN(Cortecs, Symbol);
+
+void CN(Cortecs, Symbol, init)();
+void CN(Cortecs, Symbol, cleanup)();
+
+CN(Cortecs, Symbol) CN(Cortecs, Symbol, intern)(const char *bytes, uint32_t length);
+CN(Cortecs, Symbol) CN(Cortecs, Symbol, intern_string)(CN(Cortecs, String) str);
+CN(Cortecs, Symbol) CN(Cortecs, Symbol, intern_slice)(CN(Cortecs, String, Slice) slice);
+uint64_t CN(Cortecs, Symbol, hash_bytes)(const char *bytes, uint32_t length);
+
+bool CN(Cortecs, Symbol, equals)(CN(Cortecs, Symbol) left, CN(Cortecs, Symbol) right);
+uint64_t CN(Cortecs, Symbol, hash)(CN(Cortecs, Symbol) symbol);
+const char *CN(Cortecs, Symbol, cstr)(CN(Cortecs, Symbol) symbol);
+uint32_t CN(Cortecs, Symbol, length)(CN(Cortecs, Symbol) symbol);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <assert.h>
+#include <cortecs/gc.h>
+#include <cortecs/kernel.h>
+#include <cortecs/string.h>
+#include <string.h>
+
+cortecs_finalizer_define(CN(Cortecs, String, Slice));
+void cortecs_finalizer(CN(Cortecs, String, Slice))(void *allocation) {
+    CN(Cortecs, String, Slice) *slice = allocation;
+    cortecs_gc_dec(slice->content);
+}
+
+void CN(Cortecs, String, init)() {
+    cortecs_finalizer_register(CN(Cortecs, String, Slice));
+}
+
+CN(Cortecs, String, Slice) CN(Cortecs, String, as_slice)(CN(Cortecs, String) str) {
+    if (CN(Cortecs, String, is_inline)(str)) {
+        // the inline content lives in this copy of the string value. move it to the gc
+        uint32_t size = CN(Cortecs, String, capacity)(str);
+        CN(Cortecs, Array, CT(CN(Cortecs, Char))) content = cortecs_gc_alloc_array(CN(Cortecs, Char), size);
+        memcpy(content->elements, str.inline_content, size);
+        return (CN(Cortecs, String, Slice)){
+            .content = content,
+            .offset = 0,
+            .length = size - 1,
+        };
+    }
+
+    if (str.content == NULL) {
+        return (CN(Cortecs, String, Slice)){
+            .content = NULL,
+            .offset = 0,
+            .length = 0,
+        };
+    }
+
+    // the null terminator isn't part of the slice
+    return (CN(Cortecs, String, Slice)){
+        .content = str.content,
+        .offset = 0,
+        .length = str.content->size - 1,
+    };
+}
+
+CN(Cortecs, String, Slice) CN(Cortecs, String, slice)(CN(Cortecs, String) str, uint32_t offset, uint32_t length) {
+    return CN(Cortecs, String, Slice, slice)(CN(Cortecs, String, as_slice)(str), offset, length);
+}
+
+CN(Cortecs, String, Slice) CN(Cortecs, String, Slice, slice)(CN(Cortecs, String, Slice) slice, uint32_t offset, uint32_t length) {
+    assert(offset <= slice.length);
+    assert(length <= slice.length - offset);
+    return (CN(Cortecs, String, Slice)){
+        .content = slice.content,
+        .offset = slice.offset + offset,
+        .length = length,
+    };
+}
+
+const char *CN(Cortecs, String, Slice, bytes)(CN(Cortecs, String, Slice) slice) {
+    if (slice.content == NULL) {
+        return NULL;
+    }
+    return slice.content->elements + slice.offset;
+}
+
+bool CN(Cortecs, String, Slice, equals)(CN(Cortecs, String, Slice) left, CN(Cortecs, String, Slice) right) {
+    if (left.length != right.length) {
+        return false;
+    }
+
+    if (left.content == right.content && left.offset == right.offset) {
+        return true;
+    }
+
+    if (left.length == 0) {
+        return true;
+    }
+
+    return CN(Cortecs, Kernel, equals)(CN(Cortecs, String, Slice, bytes)(left), CN(Cortecs, String, Slice, bytes)(right), left.length);
+}
+
+CN(Cortecs, String) CN(Cortecs, String, Slice, to_string)(CN(Cortecs, String, Slice) slice) {
+    return CN(Cortecs, String, from_bytes)(CN(Cortecs, String, Slice, bytes)(slice), slice.length);
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <cortecs/gc.h>
+#include <cortecs/kernel.h>
 #include <cortecs/string.h>
 #include <stdarg.h>
 #include <stddef.h>
@@ -8,46 +9,95 @@
 
 cortecs_finalizer_define(CN(Cortecs, String));
 
-bool CN(Cortecs, String, equals)(CN(Cortecs, String) left, CN(Cortecs, String) right) {
-    if (left.content == right.content) {
-        return true;
+bool CN(Cortecs, String, is_null)(CN(Cortecs, String) str) {
+    return str.inline_size == 0 && str.content == NULL;
+}
+
+bool CN(Cortecs, String, is_inline)(CN(Cortecs, String) str) {
+    return str.inline_size != 0;
+}
+
+const char *CN(Cortecs, String, cstr)(const CN(Cortecs, String) *str) {
+    if (str->inline_size != 0) {
+        return str->inline_content;
     }
 
-    if (left.content == NULL) {
-        return false;
+    if (str->content == NULL) {
+        return NULL;
     }
 
-    if (right.content == NULL) {
-        return false;
+    return str->content->elements;
+}
+
+bool CN(Cortecs, String, equals)(CN(Cortecs, String) left, CN(Cortecs, String) right) {
+    bool left_is_null = CN(Cortecs, String, is_null)(left);
+    bool right_is_null = CN(Cortecs, String, is_null)(right);
+    if (left_is_null || right_is_null) {
+        return left_is_null && right_is_null;
+    }
+
+    if (left.inline_size == 0 && left.content == right.content) {
+        return true;
     }
 
-    if (left.content->size != right.content->size) {
+    uint32_t size = CN(Cortecs, String, capacity)(left);
+    if (size != CN(Cortecs, String, capacity)(right)) {
         return false;
     }
 
-    return strncmp(left.content->elements, right.content->elements, left.content->size) == 0;
+    return CN(Cortecs, Kernel, equals)(CN(Cortecs, String, cstr)(&left), CN(Cortecs, String, cstr)(&right), size);
 }
 
 uint32_t CN(Cortecs, String, capacity)(CN(Cortecs, String) str) {
+    if (str.inline_size != 0) {
+        return str.inline_size;
+    }
     return str.content->size;
 }
 
+CN(Cortecs, String) CN(Cortecs, String, from_bytes)(const char *bytes, uint32_t length) {
+    if (length < CORTECS_STRING_INLINE_SIZE) {
+        CN(Cortecs, String) ret = {.inline_size = length + 1};
+        memcpy(ret.inline_content, bytes, length);
+        ret.inline_content[length] = 0;
+        return ret;
+    }
+
+    CN(Cortecs, String) ret = {.content = cortecs_gc_alloc_array(CN(Cortecs, Char), length + 1)};
+    memcpy(ret.content->elements, bytes, length);
+    ret.content->elements[length] = 0;
+    return ret;
+}
+
+CN(Cortecs, String) CN(Cortecs, String, from_cstr)(const char *cstr) {
+    return CN(Cortecs, String, from_bytes)(cstr, strlen(cstr));
+}
+
+// large enough for the lexer tokens and log messages that make up most strings
+#define SCRATCH_SIZE 256
+static _Thread_local char scratch[SCRATCH_SIZE];
+
 CN(Cortecs, String) CN(Cortecs, String, new)(const char *format, ...) {
-    va_list args_size;
+    va_list args_scratch;
     va_list args_out;
-    va_start(args_size, format);
-    va_copy(args_out, args_size);
-    CN(Cortecs, String) ret = {.content = NULL};
+    va_start(args_scratch, format);
+    va_copy(args_out, args_scratch);
+    CN(Cortecs, String) ret = {.content = NULL, .inline_size = 0};
 
-    // measure the output string
+    // format into the scratch buffer. this also measures the output string
     // there seems to be a bug in clang tidy that's false positive on this line
-    int32_t size = vsnprintf(NULL, 0, format, args_size);  // NOLINT(clang-analyzer-valist.Uninitialized)
+    int32_t size = vsnprintf(scratch, SCRATCH_SIZE, format, args_scratch);  // NOLINT(clang-analyzer-valist.Uninitialized)
     if (size < 0) {
         // TODO encoding error. Have better error reporting
         goto cleanup;
     }
 
-    // write the output string
+    if (size < SCRATCH_SIZE) {
+        ret = CN(Cortecs, String, from_bytes)(scratch, size);
+        goto cleanup;
+    }
+
+    // the output string was truncated. format directly into the output string
     // TODO figure out how to configure clang-format to format this line correctly
     // Adding the following option messed up formatting the arguments on separate lines
     // WhitespaceSensitiveMacros:
@@ -56,7 +106,7 @@ CN(Cortecs, String) CN(Cortecs, String, new)(const char *format, ...) {
     vsnprintf(ret.content->elements, size + 1, format, args_out);
 
 cleanup:
-    va_end(args_size);
+    va_end(args_scratch);
     va_end(args_out);
     return ret;
 }
\ No newline at end of file
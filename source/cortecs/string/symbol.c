@@ -0,0 +1,128 @@
+#include <assert.h>
+#include <cortecs/kernel.h>
+#include <cortecs/symbol.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the top bits of the hash select the shard and the bottom bits select the slot
+#define NUM_SHARDS_BITS 6
+#define NUM_SHARDS (1 << NUM_SHARDS_BITS)
+#define MIN_SHARD_CAPACITY 64
+
+typedef struct {
+    pthread_mutex_t lock;
+    // open addressing with linear probing. capacity is a power of 2
+    CN(Cortecs, Symbol, Entry) **slots;
+    uint32_t capacity;
+    uint32_t count;
+} symbol_shard;
+
+static symbol_shard shards[NUM_SHARDS];
+
+void CN(Cortecs, Symbol, init)() {
+    for (uint32_t i = 0; i < NUM_SHARDS; i++) {
+        pthread_mutex_init(&shards[i].lock, NULL);
+        shards[i].slots = calloc(MIN_SHARD_CAPACITY, sizeof(CN(Cortecs, Symbol, Entry) *));
+        shards[i].capacity = MIN_SHARD_CAPACITY;
+        shards[i].count = 0;
+    }
+}
+
+void CN(Cortecs, Symbol, cleanup)() {
+    for (uint32_t i = 0; i < NUM_SHARDS; i++) {
+        for (uint32_t j = 0; j < shards[i].capacity; j++) {
+            free(shards[i].slots[j]);
+        }
+        free(shards[i].slots);
+        shards[i].slots = NULL;
+        shards[i].capacity = 0;
+        shards[i].count = 0;
+        pthread_mutex_destroy(&shards[i].lock);
+    }
+}
+
+uint64_t CN(Cortecs, Symbol, hash_bytes)(const char *bytes, uint32_t length) {
+    return CN(Cortecs, Kernel, hash)(bytes, length, 0);
+}
+
+static void grow(symbol_shard *shard) {
+    uint32_t capacity = shard->capacity * 2;
+    CN(Cortecs, Symbol, Entry) **slots = calloc(capacity, sizeof(CN(Cortecs, Symbol, Entry) *));
+    for (uint32_t i = 0; i < shard->capacity; i++) {
+        CN(Cortecs, Symbol, Entry) *entry = shard->slots[i];
+        if (entry == NULL) {
+            continue;
+        }
+
+        uint32_t slot = entry->hash & (capacity - 1);
+        while (slots[slot] != NULL) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        slots[slot] = entry;
+    }
+
+    free(shard->slots);
+    shard->slots = slots;
+    shard->capacity = capacity;
+}
+
+CN(Cortecs, Symbol) CN(Cortecs, Symbol, intern)(const char *bytes, uint32_t length) {
+    uint64_t hash = CN(Cortecs, Symbol, hash_bytes)(bytes, length);
+    symbol_shard *shard = &shards[hash >> (64 - NUM_SHARDS_BITS)];
+    assert(shard->slots != NULL);
+
+    pthread_mutex_lock(&shard->lock);
+
+    uint32_t slot = hash & (shard->capacity - 1);
+    while (shard->slots[slot] != NULL) {
+        CN(Cortecs, Symbol, Entry) *entry = shard->slots[slot];
+        if (entry->hash == hash && entry->length == length && CN(Cortecs, Kernel, equals)(entry->bytes, bytes, length)) {
+            pthread_mutex_unlock(&shard->lock);
+            return (CN(Cortecs, Symbol)){.entry = entry};
+        }
+        slot = (slot + 1) & (shard->capacity - 1);
+    }
+
+    // + null terminator
+    CN(Cortecs, Symbol, Entry) *entry = malloc(sizeof(CN(Cortecs, Symbol, Entry)) + length + 1);
+    entry->hash = hash;
+    entry->length = length;
+    memcpy(entry->bytes, bytes, length);
+    entry->bytes[length] = 0;
+    shard->slots[slot] = entry;
+    shard->count++;
+
+    // keep the load factor at or below 3/4
+    if (shard->count * 4 > shard->capacity * 3) {
+        grow(shard);
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+    return (CN(Cortecs, Symbol)){.entry = entry};
+}
+
+CN(Cortecs, Symbol) CN(Cortecs, Symbol, intern_string)(CN(Cortecs, String) str) {
+    // don't intern the null terminator
+    return CN(Cortecs, Symbol, intern)(CN(Cortecs, String, cstr)(&str), CN(Cortecs, String, capacity)(str) - 1);
+}
+
+CN(Cortecs, Symbol) CN(Cortecs, Symbol, intern_slice)(CN(Cortecs, String, Slice) slice) {
+    return CN(Cortecs, Symbol, intern)(CN(Cortecs, String, Slice, bytes)(slice), slice.length);
+}
+
+bool CN(Cortecs, Symbol, equals)(CN(Cortecs, Symbol) left, CN(Cortecs, Symbol) right) {
+    return left.entry == right.entry;
+}
+
+uint64_t CN(Cortecs, Symbol, hash)(CN(Cortecs, Symbol) symbol) {
+    return symbol.entry->hash;
+}
+
+const char *CN(Cortecs, Symbol, cstr)(CN(Cortecs, Symbol) symbol) {
+    return symbol.entry->bytes;
+}
+
+uint32_t CN(Cortecs, Symbol, length)(CN(Cortecs, Symbol) symbol) {
+    return symbol.entry->length;
+}
\ No newline at end of file
@@ -9,6 +9,7 @@
 // Core Number Types
 // ====================================================================================================================
 typedef uint8_t CN(Cortecs, U8);
+extern cortecs_finalizer_declare(CN(Cortecs, U8));
 #define TYPE_PARAM_T CN(Cortecs, U8)
 #include "array.template.h"
 #include "ptr.template.h"
@@ -21,6 +22,7 @@ typedef uint16_t CN(Cortecs, U16);
 #undef TYPE_PARAM_T
 
 typedef uint32_t CN(Cortecs, U32);
+extern cortecs_finalizer_declare(CN(Cortecs, U32));
 #define TYPE_PARAM_T CN(Cortecs, U32)
 #include "array.template.h"
 #include "ptr.template.h"
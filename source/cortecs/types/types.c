@@ -1,3 +1,5 @@
 #include <cortecs/types.h>
 
+cortecs_finalizer_define(CN(Cortecs, U8));
+cortecs_finalizer_define(CN(Cortecs, U32));
 cortecs_finalizer_define(CN(Cortecs, Char));
\ No newline at end of file
@@ -4,6 +4,12 @@
 #include <cortecs/tokens.h>
 #include <ctype.h>
 
+bool cortecs_lexer_test_never_skip(const char *string, uint32_t length) {
+    UNUSED(string);
+    UNUSED(length);
+    return false;
+}
+
 static const char space_lookup[] = {' ', '\t', '\r', '\v', '\f'};
 static uint32_t lexer_test_space_max_entropy(uint32_t state) {
     UNUSED(state);
@@ -5,35 +5,331 @@
 #include <cortecs/string.h>
 #include <cortecs/tokens.h>
 #include <cortecs/world.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unicode/urename.h>
 #include <unicode/utypes.h>
+#include <unistd.h>
 #include <unity.h>
 
-void cortecs_lexer_test(UText *text, CN(Cortecs, String) gold_text, cortecs_lexer_tag_t tag) {
-    cortecs_lexer_token_t out = cortecs_lexer_next(text);
+// the seed when CORTECS_LEXER_TEST_SEED isn't set
+#define DEFAULT_SEED 0x636f7274656373ULL
+
+cortecs_lexer_test_rng_t cortecs_lexer_test_rng_init(uint64_t seed) {
+    cortecs_lexer_test_rng_t rng = {.state = seed};
+    // scramble the seed so nearby seeds start far apart
+    cortecs_lexer_test_rng_next(&rng);
+    return rng;
+}
+
+uint32_t cortecs_lexer_test_rng_next(cortecs_lexer_test_rng_t *rng) {
+    // splitmix64
+    rng->state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = rng->state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+uint64_t cortecs_lexer_test_seed(void) {
+    const char *seed = getenv("CORTECS_LEXER_TEST_SEED");
+    if (seed == NULL || *seed == 0) {
+        return DEFAULT_SEED;
+    }
+    return strtoull(seed, NULL, 0);
+}
+
+// message is printed when an assertion fails. it carries the seed of the case being checked
+static void check_token(cortecs_lexer_token_t out, CN(Cortecs, String) gold_text, cortecs_lexer_tag_t tag, const char *message) {
     cortecs_span_t gold_span = cortecs_span_of(gold_text);
 
     if (gold_span.lines != out.span.lines) {
         NOOP;
     }
-    TEST_ASSERT_EQUAL_INT32(gold_span.lines, out.span.lines);
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(gold_span.lines, out.span.lines, message);
 
     if (gold_span.columns != out.span.columns) {
         NOOP;
     }
-    TEST_ASSERT_EQUAL_INT32(gold_span.columns, out.span.columns);
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(gold_span.columns, out.span.columns, message);
 
     if (out.tag != tag) {
         NOOP;
     }
-    TEST_ASSERT_TRUE(out.tag == tag);
+    TEST_ASSERT_TRUE_MESSAGE(out.tag == tag, message);
 
     int areEqual = CN(Cortecs, String, equals)(gold_text, out.text);
     if (!areEqual) {
         NOOP;
     }
-    TEST_ASSERT_TRUE(areEqual);
+    TEST_ASSERT_TRUE_MESSAGE(areEqual, message);
+}
+
+void cortecs_lexer_test(UText *text, CN(Cortecs, String) gold_text, cortecs_lexer_tag_t tag) {
+    check_token(cortecs_lexer_next(text), gold_text, tag, NULL);
+}
+
+void cortecs_lexer_test_utf8(const char *input, uint32_t length, uint32_t *offset, CN(Cortecs, String) gold_text, cortecs_lexer_tag_t tag) {
+    check_token(cortecs_lexer_next_utf8(input, length, offset), gold_text, tag, NULL);
+}
+
+// Single token fuzz and exhaustive cases are split into work items that threads take in
+// order. Only the calling thread touches the gc and unity. It lexes the tokens of its items
+// with their text and compares the text with the gold bytes. The other workers lex without
+// text and compare the bytes at the token's offset instead. The first mismatch is kept and
+// the calling thread fails the test with it after every worker has stopped.
+#define MAX_THREADS 64
+#define MAX_MESSAGE_LENGTH 512
+// fuzz tokens are at most this long and start at one of this many offsets
+#define FUZZ_MAX_LENGTH 100
+#define FUZZ_OFFSETS 100
+// exhaustive tokens start at every offset up to this
+#define EXHAUSTIVE_MAX_OFFSET 5
+// exhaustive runs every length whose cases, over every offset, fit in EXHAUSTIVE_MAX_CASES in total.
+// the budgets are fixed rather than scaled with the number of cores so every machine checks the same
+// inputs. //test/cortecs/lexer:lexer_exhaustive defines CORTECS_LEXER_TEST_EXHAUSTIVE to run the full
+// budgets and the default ones keep //test/cortecs/lexer:lexer small
+#ifdef CORTECS_LEXER_TEST_EXHAUSTIVE
+#define FUZZ_CASES_PER_ITEM 100
+#define EXHAUSTIVE_MAX_CASES (1 << 23)
+#else
+#define FUZZ_CASES_PER_ITEM 5
+#define EXHAUSTIVE_MAX_CASES (1 << 16)
+#endif
+// the most states a test config's generator uses
+#define MAX_CONFIG_STATES 16
+
+typedef struct {
+    uint32_t length;
+    uint32_t offset;
+    // the entropy of the first char. splits each length and offset across threads
+    uint32_t first;
+} exhaustive_item_t;
+
+typedef struct lexer_test_runner lexer_test_runner_t;
+
+typedef struct {
+    lexer_test_runner_t *runner;
+    char *input;
+    char *gold;
+    UText *text;
+    // only the calling thread allocates the text of its tokens
+    bool materializes_text;
+} lexer_test_worker_t;
+
+struct lexer_test_runner {
+    cortecs_lexer_test_config_t config;
+    uint64_t seed;
+    uint32_t num_items;
+    // the longest input of any item including the offset and the trailing nul
+    uint32_t max_input_length;
+    void (*run_item)(lexer_test_worker_t *worker, uint32_t item);
+    // fuzz items are numbered by length from start_length then offset. exhaustive items are listed
+    uint32_t start_length;
+    exhaustive_item_t *items;
+    atomic_uint next_item;
+    atomic_bool is_failed;
+    pthread_mutex_t lock;
+    char message[MAX_MESSAGE_LENGTH];
+};
+
+static void report_failure(lexer_test_worker_t *worker, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void report_failure(lexer_test_worker_t *worker, const char *format, ...) {
+    lexer_test_runner_t *runner = worker->runner;
+    pthread_mutex_lock(&runner->lock);
+    if (!atomic_load(&runner->is_failed)) {
+        va_list arguments;
+        va_start(arguments, format);
+        vsnprintf(runner->message, MAX_MESSAGE_LENGTH, format, arguments);
+        va_end(arguments);
+        atomic_store(&runner->is_failed, true);
+    }
+    pthread_mutex_unlock(&runner->lock);
+}
+
+// the gold tokens are ascii so every byte is a column
+static cortecs_span_t gold_span(const char *gold, uint32_t length) {
+    cortecs_span_t span = {.lines = 0, .columns = 0};
+    for (uint32_t i = 0; i < length; i++) {
+        if (gold[i] == '\n') {
+            span.lines++;
+            span.columns = 0;
+        } else {
+            span.columns++;
+        }
+    }
+    return span;
+}
+
+// writes the gold token with non-printable bytes escaped
+static const char *escape_gold(const char *gold, uint32_t length, char *out, uint32_t size) {
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < length && written + 5 < size; i++) {
+        unsigned char c = (unsigned char)gold[i];
+        if (c >= 0x20 && c < 0x7F && c != '\\') {
+            out[written++] = (char)c;
+        } else {
+            written += snprintf(out + written, size - written, "\\x%02X", c);
+        }
+    }
+    out[written] = 0;
+    return out;
+}
+
+static bool token_matches(cortecs_lexer_token_t out, uint32_t offset, uint32_t length, cortecs_lexer_tag_t tag, cortecs_span_t span) {
+    return out.tag == tag && out.offset == offset && out.length == length && out.span.lines == span.lines && out.span.columns == span.columns;
+}
+
+// the token's text is the gold token. lazy tokens are checked against the bytes they were lexed from
+static bool text_matches(lexer_test_worker_t *worker, cortecs_lexer_token_t out, uint32_t length) {
+    if (!worker->materializes_text) {
+        return memcmp(worker->input + out.offset, worker->gold, length) == 0;
+    }
+    return !CN(Cortecs, String, is_null)(out.text) && CN(Cortecs, String, capacity)(out.text) == length + 1 && memcmp(CN(Cortecs, String, cstr)(&out.text), worker->gold, length) == 0;
+}
+
+// lexes the gold token at offset in the worker's input with both lexers. context describes the case when it fails
+static bool check_case(lexer_test_worker_t *worker, uint32_t offset, uint32_t length, const char *context) {
+    cortecs_lexer_config_t config = {.intern_names = false, .lazy_text = !worker->materializes_text};
+    cortecs_lexer_tag_t tag = worker->runner->config.tag;
+    cortecs_span_t span = gold_span(worker->gold, length);
+    uint32_t input_length = offset + length + 1;
+    worker->input[offset + length] = 0;
+
+    // not initializing status to U_ZERO_ERROR here caused utext_openUTF8 to return NULL
+    UErrorCode status = U_ZERO_ERROR;
+    worker->text = utext_openUTF8(worker->text, worker->input, input_length, &status);
+    utext_setNativeIndex(worker->text, offset);
+    cortecs_lexer_token_t utext = cortecs_lexer_next_with_config(worker->text, config);
+
+    uint32_t utf8_offset = offset;
+    cortecs_lexer_token_t utf8 = cortecs_lexer_next_utf8_with_config(worker->input, input_length, &utf8_offset, config);
+
+    const char *lexer;
+    cortecs_lexer_token_t out;
+    if (!token_matches(utext, offset, length, tag, span) || !text_matches(worker, utext, length)) {
+        lexer = "utext";
+        out = utext;
+    } else if (!token_matches(utf8, offset, length, tag, span) || !text_matches(worker, utf8, length) || utf8_offset != offset + length) {
+        lexer = "utf8";
+        out = utf8;
+    } else {
+        return true;
+    }
+
+    char escaped[4 * FUZZ_MAX_LENGTH + 1];
+    report_failure(
+        worker,
+        "%s: expected %s \"%s\" at %" PRIu32 " length %" PRIu32 " but the %s lexer returned %s at %" PRIu32 " length %" PRIu32 "%s",
+        context,
+        cortecs_lexer_tag_to_string(tag),
+        escape_gold(worker->gold, length, escaped, sizeof(escaped)),
+        offset,
+        length,
+        lexer,
+        cortecs_lexer_tag_to_string(out.tag),
+        out.offset,
+        out.length,
+        token_matches(out, offset, length, tag, span) ? " with different text" : "");
+    return false;
+}
+
+static void work(lexer_test_runner_t *runner, bool materializes_text) {
+    lexer_test_worker_t worker = {
+        .runner = runner,
+        .input = calloc(runner->max_input_length, sizeof(char)),
+        .gold = calloc(runner->max_input_length, sizeof(char)),
+        .text = NULL,
+        .materializes_text = materializes_text,
+    };
+    while (!atomic_load(&runner->is_failed)) {
+        uint32_t item = atomic_fetch_add(&runner->next_item, 1);
+        if (item >= runner->num_items) {
+            break;
+        }
+        runner->run_item(&worker, item);
+    }
+    utext_close(worker.text);
+    free(worker.input);
+    free(worker.gold);
+}
+
+static void *run_worker(void *argument) {
+    work(argument, false);
+    return NULL;
+}
+
+// runs every item on all cores. stops at the first mismatch
+static void run_items(lexer_test_runner_t *runner) {
+    atomic_init(&runner->next_item, 0);
+    atomic_init(&runner->is_failed, false);
+    pthread_mutex_init(&runner->lock, NULL);
+
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t num_threads = num_cpus < 1 ? 1 : (uint32_t)num_cpus;
+    num_threads = num_threads < MAX_THREADS ? num_threads : MAX_THREADS;
+    num_threads = num_threads < runner->num_items ? num_threads : runner->num_items;
+
+    // the calling thread is a worker too. items of threads that can't be started go to the others
+    pthread_t threads[MAX_THREADS];
+    bool is_started[MAX_THREADS];
+    for (uint32_t i = 1; i < num_threads; i++) {
+        is_started[i] = pthread_create(&threads[i], NULL, run_worker, runner) == 0;
+    }
+    work(runner, true);
+    for (uint32_t i = 1; i < num_threads; i++) {
+        if (is_started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    pthread_mutex_destroy(&runner->lock);
+}
+
+// writes a random token of length at offset in input and gold
+static void generate_token(cortecs_lexer_test_config_t config, cortecs_lexer_test_rng_t *rng, char *input, uint32_t offset, char *gold, uint32_t length) {
+    while (true) {
+        cortecs_lexer_test_state_t state = {
+            .state = 0,
+            .length = length,
+        };
+        for (uint32_t i = 0; i < length; i++) {
+            state.index = i;
+            cortecs_lexer_test_result_t result = config.next(state, cortecs_lexer_test_rng_next(rng));
+            state.state = result.next_state;
+            input[offset + i] = result.next_char;
+            gold[i] = result.next_char;
+        }
+
+        if (!config.should_skip_token(gold, length)) {
+            return;
+        }
+    }
+}
+
+// each item is a length and offset with its own generator so the cases don't depend on the thread that runs them
+static void run_fuzz_item(lexer_test_worker_t *worker, uint32_t item) {
+    lexer_test_runner_t *runner = worker->runner;
+    uint32_t length = runner->start_length + item / FUZZ_OFFSETS;
+    uint32_t offset = item % FUZZ_OFFSETS;
+    uint64_t seed = runner->seed + item;
+    cortecs_lexer_test_rng_t rng = cortecs_lexer_test_rng_init(seed);
+
+    memset(worker->input, 0, offset);
+    for (int times = 0; times < FUZZ_CASES_PER_ITEM; times++) {
+        generate_token(runner->config, &rng, worker->input, offset, worker->gold, length);
+        char context[128];
+        snprintf(context, sizeof(context), "seed 0x%016" PRIx64 " (CORTECS_LEXER_TEST_SEED=0x%016" PRIx64 " item %" PRIu32 ") case %d", seed, runner->seed, item, times);
+        if (!check_case(worker, offset, length, context)) {
+            return;
+        }
+    }
 }
 
 void cortecs_lexer_test_fuzz(cortecs_lexer_test_config_t config) {
@@ -45,49 +341,28 @@ void cortecs_lexer_test_fuzz(cortecs_lexer_test_config_t config) {
     }
 
     uint32_t max_length;
-    if (config.max_length < 100) {
+    if (config.max_length < FUZZ_MAX_LENGTH) {
         max_length = config.max_length;
     } else {
-        max_length = 100;
+        max_length = FUZZ_MAX_LENGTH;
     }
 
-    for (uint32_t length = start_length; length < max_length; length++) {
-        for (int64_t offset = 0; offset < 100; offset++) {
-            for (int times = 0; times < 100; times++) {
-                int64_t input_length = offset + length + 1;
-                char *input = calloc(input_length, sizeof(char));
-                char *gold = calloc(length + 1, sizeof(char));
-                while (true) {
-                    cortecs_lexer_test_state_t state = {
-                        .state = 0,
-                        .length = length,
-                    };
-                    for (uint32_t i = 0; i < length; i++) {
-                        state.index = i;
-                        cortecs_lexer_test_result_t result = config.next(state, rand());
-                        state.state = result.next_state;
-                        input[offset + i] = result.next_char;
-                        gold[i] = result.next_char;
-                    }
-
-                    if (config.should_skip_token(gold, length)) {
-                        continue;
-                    }
-
-                    break;
-                }
-                input[offset + length] = 0;
+    if (start_length >= max_length) {
+        return;
+    }
 
-                // not initializing status to U_ZERO_ERROR here caused utext_openUTF8 to return NULL
-                UErrorCode status = U_ZERO_ERROR;
-                UText *text = utext_openUTF8(NULL, input, input_length, &status);
-                utext_setNativeIndex(text, offset);
-                cortecs_lexer_test(text, CN(Cortecs, String, new)("%s", gold), config.tag);
-                utext_close(text);
-                free(input);
-                free(gold);
-            }
-        }
+    lexer_test_runner_t runner = {
+        .config = config,
+        .seed = cortecs_lexer_test_seed(),
+        .num_items = (max_length - start_length) * FUZZ_OFFSETS,
+        .max_input_length = FUZZ_OFFSETS + max_length + 1,
+        .run_item = run_fuzz_item,
+        .start_length = start_length,
+        .items = NULL,
+    };
+    run_items(&runner);
+    if (atomic_load(&runner.is_failed)) {
+        TEST_FAIL_MESSAGE(runner.message);
     }
 }
 
@@ -96,7 +371,7 @@ typedef struct {
     cortecs_lexer_tag_t tag;
 } lexer_fuzz_case_t;
 
-static uint32_t lexer_test_fuzz_case(cortecs_lexer_test_config_t config, char *input, uint32_t offset, lexer_fuzz_case_t *out) {
+static uint32_t lexer_test_fuzz_case(cortecs_lexer_test_config_t config, cortecs_lexer_test_rng_t *rng, char *input, uint32_t offset, lexer_fuzz_case_t *out) {
     uint32_t max_length;
     if (config.max_length < 100) {
         max_length = config.max_length;
@@ -108,36 +383,18 @@ static uint32_t lexer_test_fuzz_case(cortecs_lexer_test_config_t config, char *i
     if (max_length == config.min_length) {
         length = config.min_length;
     } else {
-        length = (rand() % (max_length - config.min_length)) + config.min_length;
+        length = (cortecs_lexer_test_rng_next(rng) % (max_length - config.min_length)) + config.min_length;
     }
 
     out->gold = calloc(length + 1, sizeof(char));
-    while (true) {
-        cortecs_lexer_test_state_t state = {
-            .state = 0,
-            .length = length,
-        };
-        for (uint32_t i = 0; i < length; i++) {
-            state.index = i;
-            cortecs_lexer_test_result_t result = config.next(state, rand());
-            state.state = result.next_state;
-            input[offset + i] = result.next_char;
-            out->gold[i] = result.next_char;
-        }
-
-        if (config.should_skip_token(out->gold, length)) {
-            state.state = 0;
-            continue;
-        }
-
-        out->tag = config.tag;
-
-        break;
-    }
+    generate_token(config, rng, input, offset, out->gold, length);
+    out->tag = config.tag;
     return length;
 }
 
 void cortecs_lexer_test_fuzz_multi(cortecs_lexer_test_multi_config_t config) {
+    uint64_t seed = cortecs_lexer_test_seed();
+    cortecs_lexer_test_rng_t rng = cortecs_lexer_test_rng_init(seed);
     char *input = calloc(10150, sizeof(char));
     lexer_fuzz_case_t cases[10000];
 
@@ -146,10 +403,10 @@ void cortecs_lexer_test_fuzz_multi(cortecs_lexer_test_multi_config_t config) {
     uint32_t offset = 0;
     while (offset < 10000) {
         cortecs_lexer_test_config_t next_config = config.configs[curr_config];
-        uint32_t length = lexer_test_fuzz_case(next_config, input, offset, &cases[num_cases]);
+        uint32_t length = lexer_test_fuzz_case(next_config, &rng, input, offset, &cases[num_cases]);
         num_cases++;
         offset += length;
-        uint32_t fuel = rand() % config.num_configs;
+        uint32_t fuel = cortecs_lexer_test_rng_next(&rng) % config.num_configs;
         for (uint32_t i = 0; true; i = (i + 1) % config.num_configs) {
             if (config.transition_to[curr_config][i]) {
                 if (fuel == 0) {
@@ -163,9 +420,14 @@ void cortecs_lexer_test_fuzz_multi(cortecs_lexer_test_multi_config_t config) {
 
     UErrorCode status = U_ZERO_ERROR;
     UText *text = utext_openUTF8(NULL, input, offset + 1, &status);
+    uint32_t utf8_offset = 0;
     for (int i = 0; i < num_cases; i++) {
+        char message[64];
+        snprintf(message, sizeof(message), "seed 0x%016" PRIx64 " token %d", seed, i);
         lexer_fuzz_case_t gold = cases[i];
-        cortecs_lexer_test(text, CN(Cortecs, String, new)("%s", gold.gold), gold.tag);
+        CN(Cortecs, String) gold_text = CN(Cortecs, String, new)("%s", gold.gold);
+        check_token(cortecs_lexer_next(text), gold_text, gold.tag, message);
+        check_token(cortecs_lexer_next_utf8(input, offset + 1, &utf8_offset), gold_text, gold.tag, message);
         free(gold.gold);
     }
     utext_close(text);
@@ -174,27 +436,34 @@ void cortecs_lexer_test_fuzz_multi(cortecs_lexer_test_multi_config_t config) {
 }
 
 void cortecs_lexer_test_exhaustive_two_token(cortecs_lexer_test_multi_config_t config) {
+    uint64_t seed = cortecs_lexer_test_seed();
+    cortecs_lexer_test_rng_t rng = cortecs_lexer_test_rng_init(seed);
     char input[250];
     lexer_fuzz_case_t cases[2];
 
     for (int times = 0; times < 1000; times++) {
         for (uint32_t i = 0; i < config.num_configs; i++) {
             cortecs_lexer_test_config_t first_config = config.configs[i];
-            uint32_t first_length = lexer_test_fuzz_case(first_config, input, 0, &cases[0]);
+            uint32_t first_length = lexer_test_fuzz_case(first_config, &rng, input, 0, &cases[0]);
 
             for (uint32_t j = 0; j < config.num_configs; j++) {
                 if (!config.transition_to[i][j]) {
                     continue;
                 }
                 cortecs_lexer_test_config_t second_config = config.configs[j];
-                uint32_t second_length = lexer_test_fuzz_case(second_config, input, first_length, &cases[1]);
+                uint32_t second_length = lexer_test_fuzz_case(second_config, &rng, input, first_length, &cases[1]);
                 input[first_length + second_length] = 0;
 
+                char message[96];
+                snprintf(message, sizeof(message), "seed 0x%016" PRIx64 " round %d configs %" PRIu32 " and %" PRIu32, seed, times, i, j);
                 UErrorCode status = U_ZERO_ERROR;
                 UText *text = utext_openUTF8(NULL, input, first_length + second_length + 1, &status);
+                uint32_t utf8_offset = 0;
                 for (int i = 0; i < 2; i++) {
                     lexer_fuzz_case_t gold = cases[i];
-                    cortecs_lexer_test(text, CN(Cortecs, String, new)("%s", gold.gold), gold.tag);
+                    CN(Cortecs, String) gold_text = CN(Cortecs, String, new)("%s", gold.gold);
+                    check_token(cortecs_lexer_next(text), gold_text, gold.tag, message);
+                    check_token(cortecs_lexer_next_utf8(input, first_length + second_length + 1, &utf8_offset), gold_text, gold.tag, message);
                 }
                 utext_close(text);
                 free(cases[1].gold);
@@ -204,52 +473,71 @@ void cortecs_lexer_test_exhaustive_two_token(cortecs_lexer_test_multi_config_t c
     }
 }
 
-typedef struct {
-    char *in;
-    char *gold;
-    uint32_t length;
-    uint32_t offset;
-    uint32_t state;
-} cortecs_lexer_exhaustive_state_stm_t;
+// the number of tokens of length the config generates including the ones it skips
+static uint64_t count_tokens(cortecs_lexer_test_config_t config, uint32_t length) {
+    uint64_t counts[MAX_CONFIG_STATES] = {[0] = 1};
+    for (uint32_t index = 0; index < length; index++) {
+        uint64_t next_counts[MAX_CONFIG_STATES] = {0};
+        for (uint32_t state = 0; state < MAX_CONFIG_STATES; state++) {
+            if (counts[state] == 0) {
+                continue;
+            }
 
-static void lexer_test_exhaustive_run(cortecs_lexer_test_config_t config, cortecs_lexer_exhaustive_state_stm_t state, uint32_t index) {
-    if (index == state.length) {
-        if (config.should_skip_token(state.gold, state.length)) {
-            return;
+            cortecs_lexer_test_state_t test_state = {
+                .state = state,
+                .index = index,
+                .length = length,
+            };
+            uint32_t num_chars = config.state_max_entropy(state);
+            for (uint32_t i = 0; i < num_chars; i++) {
+                uint32_t next_state = config.next(test_state, i).next_state;
+                TEST_ASSERT_LESS_THAN_UINT32(MAX_CONFIG_STATES, next_state);
+                next_counts[next_state] += counts[state];
+            }
         }
+        memcpy(counts, next_counts, sizeof(counts));
+    }
 
-        state.in[state.offset + index] = 0;
-        state.gold[index] = 0;
-        UErrorCode status = U_ZERO_ERROR;
-        UText *text = utext_openUTF8(NULL, state.in, state.offset + state.length + 1, &status);
-        utext_setNativeIndex(text, state.offset);
-        cortecs_lexer_test(text, CN(Cortecs, String, new)("%s", state.gold), config.tag);
-        utext_close(text);
+    uint64_t total = 0;
+    for (uint32_t state = 0; state < MAX_CONFIG_STATES; state++) {
+        total += counts[state];
+    }
+    return total;
+}
 
-        return;
+// generates every token that starts with the item's first char and checks it. returns false on the first mismatch
+static bool run_exhaustive(lexer_test_worker_t *worker, exhaustive_item_t item, uint32_t state, uint32_t index) {
+    cortecs_lexer_test_config_t config = worker->runner->config;
+    if (index == item.length) {
+        if (config.should_skip_token(worker->gold, item.length)) {
+            return true;
+        }
+        return check_case(worker, item.offset, item.length, "exhaustive");
     }
 
     cortecs_lexer_test_state_t test_state = {
-        .state = state.state,
+        .state = state,
         .index = index,
-        .length = state.length,
+        .length = item.length,
     };
 
-    uint32_t num_chars = config.state_max_entropy(0);
-    for (uint32_t i = 0; i < num_chars; i++) {
+    uint32_t first = index == 0 ? item.first : 0;
+    uint32_t last = index == 0 ? item.first + 1 : config.state_max_entropy(state);
+    for (uint32_t i = first; i < last; i++) {
         cortecs_lexer_test_result_t result = config.next(test_state, i);
-        state.in[state.offset + index] = result.next_char;
-        state.gold[index] = result.next_char;
-
-        cortecs_lexer_exhaustive_state_stm_t next_state = {
-            .in = state.in,
-            .gold = state.gold,
-            .length = state.length,
-            .offset = state.offset,
-            .state = result.next_state,
-        };
-        lexer_test_exhaustive_run(config, next_state, index + 1);
+        worker->input[item.offset + index] = result.next_char;
+        worker->gold[index] = result.next_char;
+        if (!run_exhaustive(worker, item, result.next_state, index + 1)) {
+            return false;
+        }
     }
+    return true;
+}
+
+static void run_exhaustive_item(lexer_test_worker_t *worker, uint32_t item) {
+    exhaustive_item_t exhaustive_item = worker->runner->items[item];
+    memset(worker->input, 0, exhaustive_item.offset);
+    run_exhaustive(worker, exhaustive_item, 0, 0);
 }
 
 void cortecs_lexer_test_exhaustive(cortecs_lexer_test_config_t config) {
@@ -261,31 +549,53 @@ void cortecs_lexer_test_exhaustive(cortecs_lexer_test_config_t config) {
     }
 
     uint32_t max_length;
-    if (config.max_length < 5 || config.min_length > 5) {
+    if (config.max_length < FUZZ_MAX_LENGTH) {
         max_length = config.max_length;
     } else {
-        max_length = 5;
+        max_length = FUZZ_MAX_LENGTH;
     }
 
-    // These constants were chosen to finish the test in a reasonable amount of time.
-    const uint32_t max_offset = 5;
-    cortecs_lexer_exhaustive_state_stm_t state = {
-        .in = calloc(max_length + max_offset + 1, sizeof(char)),
-        .gold = calloc(max_length + 1, sizeof(char)),
-    };
-    for (uint32_t length = start_length; length <= max_length; length++) {
-        for (uint32_t offset = 0; offset <= max_offset; offset++) {
-            state.length = length;
-            state.offset = offset;
-            lexer_test_exhaustive_run(config, state, 0);
+    // the shortest length always runs. longer lengths run while the total fits in the budget
+    uint32_t end_length = start_length;
+    uint64_t num_cases = count_tokens(config, start_length) * (EXHAUSTIVE_MAX_OFFSET + 1);
+    while (end_length < max_length) {
+        uint64_t length_cases = count_tokens(config, end_length + 1) * (EXHAUSTIVE_MAX_OFFSET + 1);
+        if (num_cases + length_cases > EXHAUSTIVE_MAX_CASES) {
+            break;
         }
+        num_cases += length_cases;
+        end_length++;
     }
-    free(state.in);
-    free(state.gold);
-}
 
-bool cortecs_lexer_test_never_skip(const char *string, uint32_t length) {
-    UNUSED(string);
-    UNUSED(length);
-    return false;
+    uint32_t num_firsts = config.state_max_entropy(0);
+    uint32_t num_items = (end_length - start_length + 1) * (EXHAUSTIVE_MAX_OFFSET + 1) * num_firsts;
+    exhaustive_item_t *items = calloc(num_items, sizeof(exhaustive_item_t));
+    uint32_t item = 0;
+    for (uint32_t length = start_length; length <= end_length; length++) {
+        for (uint32_t offset = 0; offset <= EXHAUSTIVE_MAX_OFFSET; offset++) {
+            for (uint32_t first = 0; first < num_firsts; first++) {
+                items[item] = (exhaustive_item_t){
+                    .length = length,
+                    .offset = offset,
+                    .first = first,
+                };
+                item++;
+            }
+        }
+    }
+
+    lexer_test_runner_t runner = {
+        .config = config,
+        .seed = 0,
+        .num_items = num_items,
+        .max_input_length = EXHAUSTIVE_MAX_OFFSET + end_length + 1,
+        .run_item = run_exhaustive_item,
+        .start_length = start_length,
+        .items = items,
+    };
+    run_items(&runner);
+    free(items);
+    if (atomic_load(&runner.is_failed)) {
+        TEST_FAIL_MESSAGE(runner.message);
+    }
 }
\ No newline at end of file
@@ -33,9 +33,24 @@ typedef struct {
     uint32_t num_configs;
 } cortecs_lexer_test_multi_config_t;
 
+// a splitmix64 generator. fuzz tests give every unit of work its own generator
+// so the cases don't depend on which thread runs them
+typedef struct {
+    uint64_t state;
+} cortecs_lexer_test_rng_t;
+
+cortecs_lexer_test_rng_t cortecs_lexer_test_rng_init(uint64_t seed);
+uint32_t cortecs_lexer_test_rng_next(cortecs_lexer_test_rng_t *rng);
+// the seed fuzz generators are derived from. set CORTECS_LEXER_TEST_SEED to rerun a reported failure
+uint64_t cortecs_lexer_test_seed(void);
+
 void cortecs_lexer_test(UText *text, CN(Cortecs, String) gold, cortecs_lexer_tag_t tag);
+// lexes with cortecs_lexer_next_utf8 starting at offset and advances offset past the token
+void cortecs_lexer_test_utf8(const char *input, uint32_t length, uint32_t *offset, CN(Cortecs, String) gold, cortecs_lexer_tag_t tag);
+// checks random tokens on every core. a failure reports the seed of its case
 void cortecs_lexer_test_fuzz(cortecs_lexer_test_config_t config);
 void cortecs_lexer_test_fuzz_multi(cortecs_lexer_test_multi_config_t config);
+// checks every token on every core up to the longest length that fits in a fixed number of cases
 void cortecs_lexer_test_exhaustive(cortecs_lexer_test_config_t config);
 void cortecs_lexer_test_exhaustive_two_token(cortecs_lexer_test_multi_config_t config);
 bool cortecs_lexer_test_never_skip(const char *, uint32_t);
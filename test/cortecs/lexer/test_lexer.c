@@ -1,6 +1,7 @@
 #include <common.h>
 #include <cortecs/gc.h>
 #include <cortecs/lexer.h>
+#include <cortecs/symbol.h>
 #include <cortecs/tokens.h>
 #include <cortecs/world.h>
 #include <ctype.h>
@@ -9,7 +10,9 @@
 #include <string.h>
 #include <sys/types.h>
 #include <time.h>
+#include <unicode/uchar.h>
 #include <unicode/urename.h>
+#include <unicode/utf8.h>
 #include <unicode/utypes.h>
 #include <unity.h>
 
@@ -33,22 +36,22 @@ static void lexer_test_empty_input(void) {
 }
 
 static void lexer_test_float(void) {
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_float_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_float_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_float_config);
 }
 
 static void lexer_test_bad_float(void) {
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_bad_float_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_bad_float_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_bad_float_config);
 }
 
 static void lexer_test_int(void) {
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_int_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_int_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_int_config);
 }
 
 static void lexer_test_bad_int(void) {
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_bad_int_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_bad_int_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_bad_int_config);
 }
 
@@ -69,22 +72,22 @@ void lexer_test_if(void) {
 }
 
 static void lexer_test_name(void) {
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_name_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_name_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_name_config);
 }
 
 static void lexer_test_type(void) {
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_type_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_type_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_type_config);
 }
 
 static void lexer_test_space(void) {
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_space_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_space_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_space_config);
 }
 
 static void lexer_test_operator(void) {
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_operator_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_operator_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_operator_config);
 }
 
@@ -145,10 +148,7 @@ static void lexer_test_dot(void) {
 }
 
 static void lexer_test_invalid(void) {
-    // currently not running exhaustiveness testing because it takes way too long
-    // maybe reenable them if I ever decide it's worth the effort to change test
-    // implementations for this case
-    // cortecs_lexer_test_exhaustive(cortecs_lexer_test_invalid_config);
+    cortecs_lexer_test_exhaustive(cortecs_lexer_test_invalid_config);
     cortecs_lexer_test_fuzz(cortecs_lexer_test_invalid_config);
 }
 
@@ -223,6 +223,48 @@ void cortecs_lexer_test_multi_token_fuzz(void) {
     free(transition_to);
 }
 
+static void lexer_test_intern_names(void) {
+    const char *input = "foo Bar foo(Bar)";
+    UErrorCode status = U_ZERO_ERROR;
+    UText *text = utext_openUTF8(NULL, input, -1, &status);
+    cortecs_lexer_config_t config = {.intern_names = true};
+
+    cortecs_lexer_token_t tokens[8];
+    for (int i = 0; i < 8; i++) {
+        tokens[i] = cortecs_lexer_next_with_config(text, config);
+    }
+    utext_close(text);
+
+    cortecs_lexer_tag_t gold_tags[] = {
+        CORTECS_LEXER_TAG_NAME,
+        CORTECS_LEXER_TAG_SPACE,
+        CORTECS_LEXER_TAG_TYPE,
+        CORTECS_LEXER_TAG_SPACE,
+        CORTECS_LEXER_TAG_NAME,
+        CORTECS_LEXER_TAG_OPEN_PAREN,
+        CORTECS_LEXER_TAG_TYPE,
+        CORTECS_LEXER_TAG_CLOSE_PAREN,
+    };
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(tokens[i].tag == gold_tags[i]);
+    }
+
+    // names and types are only interned
+    TEST_ASSERT_TRUE(CN(Cortecs, String, is_null)(tokens[0].text));
+    TEST_ASSERT_EQUAL_STRING("foo", CN(Cortecs, Symbol, cstr)(tokens[0].symbol));
+    TEST_ASSERT_EQUAL_STRING("Bar", CN(Cortecs, Symbol, cstr)(tokens[2].symbol));
+    TEST_ASSERT_EQUAL_INT32(3, tokens[0].span.columns);
+
+    // the same name is always the same symbol
+    TEST_ASSERT_TRUE(CN(Cortecs, Symbol, equals)(tokens[0].symbol, tokens[4].symbol));
+    TEST_ASSERT_TRUE(CN(Cortecs, Symbol, equals)(tokens[2].symbol, tokens[6].symbol));
+    TEST_ASSERT_FALSE(CN(Cortecs, Symbol, equals)(tokens[0].symbol, tokens[2].symbol));
+
+    // everything else still has text
+    TEST_ASSERT_NULL(tokens[1].symbol.entry);
+    TEST_ASSERT_EQUAL_STRING(" ", CN(Cortecs, String, cstr)(&tokens[1].text));
+}
+
 void assert_tag_equals(const char *gold, cortecs_lexer_tag_t tag) {
     uint32_t length = strnlen(gold, 32) + 1;
     const char *out = cortecs_lexer_tag_to_string(tag);
@@ -261,6 +303,380 @@ static void lexer_test_tag_string(void) {
     assert_tag_equals("unknown", (cortecs_lexer_tag_t)-1);
 }
 
+static void lexer_test_utf8_empty_input(void) {
+    uint32_t offset = 0;
+    cortecs_lexer_test_utf8(NULL, 0, &offset, (CN(Cortecs, String)){.content = NULL}, CORTECS_LEXER_TAG_INVALID);
+    cortecs_lexer_test_utf8("", 0, &offset, (CN(Cortecs, String)){.content = NULL}, CORTECS_LEXER_TAG_INVALID);
+
+    offset = 7;
+    cortecs_lexer_test_utf8("asdf123", 7, &offset, (CN(Cortecs, String)){.content = NULL}, CORTECS_LEXER_TAG_INVALID);
+    TEST_ASSERT_EQUAL_UINT32(7, offset);
+}
+
+// ascii, non-ascii letters, digits and marks, and ill-formed sequences
+static const char *utf8_pieces[] = {
+    "a", "Z", "_", "1", ".", "d", "u", "l", " ", "\t", "\n", "+", "(", ";", "\x01",
+    "\xC3\xA9", "\xC3\x89", "\xE0\xB8\x81", "\xE0\xB9\x89", "\xD9\xA3", "\xF0\x9F\x98\x80", "\xEF\xBF\xBD",
+    "\x80", "\xC0", "\xE0\xA0", "\xF0\x90\x80", "\xF4\x90\x80\x80", "\xED\xA0\x80", "\xFF",
+};
+
+// fills input with random pieces and returns the number of bytes used
+static uint32_t random_utf8_input(char *input, uint32_t size) {
+    const uint32_t num_pieces = sizeof(utf8_pieces) / sizeof(utf8_pieces[0]);
+    uint32_t length = 0;
+    while (length + 4 < size) {
+        const char *piece = utf8_pieces[rand() % num_pieces];
+        memcpy(input + length, piece, strlen(piece));
+        length += strlen(piece);
+    }
+    return length;
+}
+
+// the bytes are lexed by the generated table and the UText by the hand written lexer
+static void assert_utf8_matches_utext(const char *input, uint32_t length, cortecs_lexer_config_t config) {
+    UErrorCode status = U_ZERO_ERROR;
+    UText *text = utext_openUTF8(NULL, input, length, &status);
+    uint32_t offset = 0;
+    while (true) {
+        uint32_t start = offset;
+        cortecs_lexer_token_t gold = cortecs_lexer_next_with_config(text, config);
+        cortecs_lexer_token_t out = cortecs_lexer_next_utf8_with_config(input, length, &offset, config);
+        TEST_ASSERT_EQUAL_UINT32(start, out.offset);
+        TEST_ASSERT_EQUAL_UINT32(offset - start, out.length);
+        TEST_ASSERT_EQUAL_UINT32(gold.offset, out.offset);
+        TEST_ASSERT_EQUAL_UINT32(gold.length, out.length);
+
+        TEST_ASSERT_TRUE(gold.tag == out.tag);
+        TEST_ASSERT_EQUAL_UINT32(gold.span.lines, out.span.lines);
+        TEST_ASSERT_EQUAL_UINT32(gold.span.columns, out.span.columns);
+        TEST_ASSERT_TRUE(CN(Cortecs, String, equals)(gold.text, out.text));
+        TEST_ASSERT_TRUE(gold.symbol.entry == out.symbol.entry);
+        TEST_ASSERT_TRUE(utext_getNativeIndex(text) == offset);
+
+        if (gold.length == 0) {
+            break;
+        }
+    }
+    utext_close(text);
+}
+
+static void lexer_test_utf8_matches_utext(void) {
+    char input[256];
+    for (int run = 0; run < 2000; run++) {
+        uint32_t length = random_utf8_input(input, sizeof(input));
+        assert_utf8_matches_utext(input, length, (cortecs_lexer_config_t){.intern_names = run % 2 == 0, .lazy_text = false});
+    }
+}
+
+// every input of up to three symbols where a symbol is an ascii byte or one of the pieces.
+// the random inputs and the fuzz tests cover longer tokens
+static void lexer_test_table_matches_utext_exhaustive(void) {
+    const uint32_t num_pieces = sizeof(utf8_pieces) / sizeof(utf8_pieces[0]);
+    const uint32_t num_symbols = 128 + num_pieces;
+    cortecs_lexer_config_t config = {.intern_names = false, .lazy_text = true};
+    char input[12];
+    uint32_t num_inputs = 1;
+    for (uint32_t size = 1; size <= 3; size++) {
+        num_inputs *= num_symbols;
+        for (uint32_t i = 0; i < num_inputs; i++) {
+            uint32_t length = 0;
+            uint32_t symbols = i;
+            for (uint32_t j = 0; j < size; j++) {
+                uint32_t symbol = symbols % num_symbols;
+                symbols /= num_symbols;
+                if (symbol < 128) {
+                    input[length] = (char)symbol;
+                    length++;
+                    continue;
+                }
+                memcpy(input + length, utf8_pieces[symbol - 128], strlen(utf8_pieces[symbol - 128]));
+                length += strlen(utf8_pieces[symbol - 128]);
+            }
+            assert_utf8_matches_utext(input, length, config);
+        }
+    }
+}
+
+static void lexer_test_lazy_text(void) {
+    CN(Cortecs, String) source = CN(Cortecs, String, from_cstr)("let foo = Bar(12) \xE0\xB9\x84\n");
+    const char *bytes = CN(Cortecs, String, cstr)(&source);
+    uint32_t length = CN(Cortecs, String, capacity)(source) - 1;
+    cortecs_lexer_config_t lazy = {.intern_names = false, .lazy_text = true};
+
+    uint32_t eager_offset = 0;
+    uint32_t lazy_offset = 0;
+    while (true) {
+        cortecs_lexer_token_t eager = cortecs_lexer_next_utf8(bytes, length, &eager_offset);
+        cortecs_lexer_token_t out = cortecs_lexer_next_utf8_with_config(bytes, length, &lazy_offset, lazy);
+        TEST_ASSERT_TRUE(eager.tag == out.tag);
+        TEST_ASSERT_EQUAL_UINT32(eager.span.lines, out.span.lines);
+        TEST_ASSERT_EQUAL_UINT32(eager.span.columns, out.span.columns);
+
+        // the text is only materialized on request
+        TEST_ASSERT_TRUE(CN(Cortecs, String, is_null)(out.text));
+        CN(Cortecs, String) text = cortecs_lexer_token_text(out, bytes);
+        TEST_ASSERT_TRUE(CN(Cortecs, String, equals)(eager.text, text));
+        if (CN(Cortecs, String, is_null)(eager.text)) {
+            break;
+        }
+
+        CN(Cortecs, String, Slice) slice = cortecs_lexer_token_slice(out, source);
+        TEST_ASSERT_TRUE(CN(Cortecs, String, Slice, equals)(CN(Cortecs, String, as_slice)(eager.text), slice));
+    }
+}
+
+static void lexer_test_tokenize(void) {
+    char input[1024];
+    for (int run = 0; run < 500; run++) {
+        // short inputs cover the empty input and the column growing past the estimate
+        uint32_t length = random_utf8_input(input, 5 + rand() % (sizeof(input) - 5));
+        cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+        TEST_ASSERT_EQUAL_UINT32(tokens.size, tokens.tags->size);
+        TEST_ASSERT_EQUAL_UINT32(tokens.size, tokens.columns->size);
+
+        cortecs_lexer_config_t config = {.intern_names = false, .lazy_text = true};
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < tokens.size; i++) {
+            cortecs_lexer_token_t gold = cortecs_lexer_next_utf8_with_config(input, length, &offset, config);
+            cortecs_lexer_token_t out = cortecs_lexer_tokens_get(tokens, i);
+            TEST_ASSERT_TRUE(gold.tag == out.tag);
+            TEST_ASSERT_EQUAL_UINT32(gold.offset, out.offset);
+            TEST_ASSERT_EQUAL_UINT32(gold.length, out.length);
+            TEST_ASSERT_EQUAL_UINT32(gold.span.lines, out.span.lines);
+            TEST_ASSERT_EQUAL_UINT32(gold.span.columns, out.span.columns);
+        }
+        TEST_ASSERT_EQUAL_UINT32(length, offset);
+
+        for (uint32_t i = 0; i <= tokens.size; i++) {
+            uint32_t next = i;
+            while (next < tokens.size && (tokens.tags->elements[next] == CORTECS_LEXER_TAG_SPACE || tokens.tags->elements[next] == CORTECS_LEXER_TAG_NEW_LINE)) {
+                next++;
+            }
+            TEST_ASSERT_EQUAL_UINT32(next, cortecs_lexer_tokens_skip_whitespace(tokens, i));
+        }
+    }
+}
+
+static void lexer_test_tokenize_whitespace(void) {
+    const char *input = "let  x\n\n\t = 1";
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, strlen(input));
+    static const cortecs_lexer_tag_t expected[] = {
+        CORTECS_LEXER_TAG_LET,
+        CORTECS_LEXER_TAG_NAME,
+        CORTECS_LEXER_TAG_OPERATOR,
+        CORTECS_LEXER_TAG_INT,
+    };
+
+    uint32_t index = 0;
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        index = cortecs_lexer_tokens_skip_whitespace(tokens, index);
+        TEST_ASSERT_TRUE(index < tokens.size);
+        TEST_ASSERT_TRUE(expected[i] == tokens.tags->elements[index]);
+        index++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(tokens.size, cortecs_lexer_tokens_skip_whitespace(tokens, index));
+}
+
+static void lexer_test_keyword_near_misses(void) {
+    // names that share a hash slot, a prefix or the first and last bytes with a keyword
+    static const struct {
+        const char *input;
+        cortecs_lexer_tag_t tag;
+    } cases[] = {
+        {"if", CORTECS_LEXER_TAG_IF},
+        {"let", CORTECS_LEXER_TAG_LET},
+        {"return", CORTECS_LEXER_TAG_RETURN},
+        {"function", CORTECS_LEXER_TAG_FUNCTION},
+        {"i", CORTECS_LEXER_TAG_NAME},
+        {"iff", CORTECS_LEXER_TAG_NAME},
+        {"lat", CORTECS_LEXER_TAG_NAME},
+        {"returns", CORTECS_LEXER_TAG_NAME},
+        {"rn", CORTECS_LEXER_TAG_NAME},
+        {"functions", CORTECS_LEXER_TAG_NAME},
+        {"fn", CORTECS_LEXER_TAG_NAME},
+        {"functionn", CORTECS_LEXER_TAG_NAME},
+        {"If", CORTECS_LEXER_TAG_TYPE},
+        {"Let", CORTECS_LEXER_TAG_TYPE},
+        {"l\xC3\xA9t", CORTECS_LEXER_TAG_NAME},
+        {"\xC3\x89t", CORTECS_LEXER_TAG_TYPE},
+        {"return\xE0\xB8\x81", CORTECS_LEXER_TAG_NAME},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint32_t length = strlen(cases[i].input);
+        UErrorCode status = U_ZERO_ERROR;
+        UText *text = utext_openUTF8(NULL, cases[i].input, length, &status);
+        TEST_ASSERT_TRUE(cases[i].tag == cortecs_lexer_next(text).tag);
+        utext_close(text);
+
+        uint32_t offset = 0;
+        TEST_ASSERT_TRUE(cases[i].tag == cortecs_lexer_next_utf8(cases[i].input, length, &offset).tag);
+        TEST_ASSERT_EQUAL_UINT32(length, offset);
+    }
+}
+
+static void lexer_test_unicode_classes_match_icu(void) {
+    cortecs_lexer_config_t config = {.intern_names = false, .lazy_text = true};
+    for (UChar32 codepoint = 0x80; codepoint <= UCHAR_MAX_VALUE; codepoint++) {
+        if (U_IS_SURROGATE(codepoint)) {
+            continue;
+        }
+
+        // the codepoint continuing a name and on its own
+        char input[1 + U8_MAX_LENGTH];
+        int32_t length = 1;
+        input[0] = 'a';
+        U8_APPEND_UNSAFE(input, length, codepoint);
+
+        cortecs_lexer_tag_t tag = CORTECS_LEXER_TAG_INVALID;
+        if (u_isalpha(codepoint)) {
+            tag = u_isupper(codepoint) ? CORTECS_LEXER_TAG_TYPE : CORTECS_LEXER_TAG_NAME;
+        } else if (u_isdigit(codepoint)) {
+            tag = CORTECS_LEXER_TAG_INT;
+        }
+
+        uint32_t offset = 0;
+        cortecs_lexer_next_utf8_with_config(input, length, &offset, config);
+        TEST_ASSERT_EQUAL_UINT32(u_isalnum(codepoint) ? length : 1, offset);
+
+        offset = 1;
+        cortecs_lexer_token_t token = cortecs_lexer_next_utf8_with_config(input, length, &offset, config);
+        TEST_ASSERT_TRUE(tag == token.tag);
+        TEST_ASSERT_EQUAL_UINT32(length, offset);
+    }
+}
+
+static void assert_tokens_equal(cortecs_lexer_tokens_t expected, cortecs_lexer_tokens_t actual) {
+    TEST_ASSERT_EQUAL_UINT32(expected.size, actual.size);
+    for (uint32_t i = 0; i < expected.size; i++) {
+        TEST_ASSERT_EQUAL_UINT8(expected.tags->elements[i], actual.tags->elements[i]);
+        TEST_ASSERT_EQUAL_UINT32(expected.offsets->elements[i], actual.offsets->elements[i]);
+        TEST_ASSERT_EQUAL_UINT32(expected.lengths->elements[i], actual.lengths->elements[i]);
+        TEST_ASSERT_EQUAL_UINT32(expected.lines->elements[i], actual.lines->elements[i]);
+        TEST_ASSERT_EQUAL_UINT32(expected.columns->elements[i], actual.columns->elements[i]);
+    }
+}
+
+static void lexer_test_relex(void) {
+    char before[512];
+    char after[1024];
+    char insertion[512];
+    for (int run = 0; run < 2000; run++) {
+        uint32_t length = random_utf8_input(before, 5 + rand() % (sizeof(before) - 5));
+        uint32_t inserted = random_utf8_input(insertion, 5 + rand() % 8) * (rand() % 2);
+
+        // edits anywhere including the start, the end and inside of multi-byte codepoints
+        cortecs_lexer_edit_t edit = {.offset = rand() % (length + 1), .inserted = inserted};
+        edit.removed = rand() % (length - edit.offset + 1) % 8;
+        memcpy(after, before, edit.offset);
+        memcpy(after + edit.offset, insertion, edit.inserted);
+        memcpy(after + edit.offset + edit.inserted, before + edit.offset + edit.removed, length - edit.offset - edit.removed);
+        uint32_t after_length = length - edit.removed + edit.inserted;
+
+        ecs_defer_begin(world);
+        cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(before, length);
+        cortecs_lexer_relex_t relex = cortecs_lexer_relex(tokens, after, after_length, edit);
+        TEST_ASSERT_TRUE(relex.start + relex.removed <= tokens.size);
+        assert_tokens_equal(cortecs_lexer_tokenize(after, after_length), cortecs_lexer_tokens_apply(tokens, relex, edit));
+        ecs_defer_end(world);
+    }
+}
+
+static void lexer_test_relex_resynchronizes(void) {
+    const char *before = "let a = 1\nlet b = 2\nlet c = 3\n";
+    const char *after = "let a = 1\nlet bc = 2\nlet c = 3\n";
+    cortecs_lexer_edit_t edit = {.offset = strlen("let a = 1\nlet b"), .removed = 0, .inserted = 1};
+
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(before, strlen(before));
+    cortecs_lexer_relex_t relex = cortecs_lexer_relex(tokens, after, strlen(after), edit);
+
+    // b is relexed as bc along with the tokens around it. the third line isn't relexed
+    TEST_ASSERT_TRUE(relex.start + relex.removed <= 12);
+    TEST_ASSERT_EQUAL_UINT32(relex.removed, relex.inserted.size);
+    cortecs_lexer_tokens_t applied = cortecs_lexer_tokens_apply(tokens, relex, edit);
+    assert_tokens_equal(cortecs_lexer_tokenize(after, strlen(after)), applied);
+    TEST_ASSERT_EQUAL_UINT32(2, applied.lengths->elements[10]);
+}
+
+static void lexer_test_tokenize_parallel(void) {
+    static char input[64 * 1024];
+    for (int run = 0; run < 200; run++) {
+        uint32_t length = random_utf8_input(input, 5 + rand() % (sizeof(input) - 5));
+        cortecs_lexer_tokens_t expected = cortecs_lexer_tokenize(input, length);
+
+        // more threads than lines leaves some without a chunk
+        for (uint32_t num_threads = 0; num_threads <= 9; num_threads += 3) {
+            assert_tokens_equal(expected, cortecs_lexer_tokenize_parallel(input, length, num_threads));
+        }
+        assert_tokens_equal(expected, cortecs_lexer_tokenize_parallel(input, length, 1000));
+    }
+
+    assert_tokens_equal(cortecs_lexer_tokenize("", 0), cortecs_lexer_tokenize_parallel("", 0, 4));
+    assert_tokens_equal(cortecs_lexer_tokenize("\n\n", 2), cortecs_lexer_tokenize_parallel("\n\n", 2, 4));
+    assert_tokens_equal(cortecs_lexer_tokenize("a b c", 5), cortecs_lexer_tokenize_parallel("a b c", 5, 4));
+}
+
+static void assert_stream_matches_utf8(const char *input, uint32_t length, uint32_t max_chunk_length, cortecs_lexer_config_t config) {
+    cortecs_lexer_stream_t stream;
+    cortecs_lexer_stream_init(&stream, config);
+
+    // every chunk is copied into the same buffer so the stream can't keep reading an old chunk
+    char chunk[16];
+    uint32_t pushed = 0;
+    bool is_finished = false;
+    uint32_t offset = 0;
+    while (true) {
+        cortecs_lexer_token_t out;
+        if (!cortecs_lexer_stream_next(&stream, &out)) {
+            if (is_finished) {
+                break;
+            }
+            if (pushed == length) {
+                cortecs_lexer_stream_finish(&stream);
+                is_finished = true;
+                continue;
+            }
+
+            uint32_t chunk_length = 1 + rand() % max_chunk_length;
+            chunk_length = chunk_length < length - pushed ? chunk_length : length - pushed;
+            memcpy(chunk, input + pushed, chunk_length);
+            cortecs_lexer_stream_push(&stream, chunk, chunk_length);
+            pushed += chunk_length;
+            continue;
+        }
+
+        cortecs_lexer_token_t gold = cortecs_lexer_next_utf8_with_config(input, length, &offset, config);
+        TEST_ASSERT_TRUE(gold.tag == out.tag);
+        TEST_ASSERT_EQUAL_UINT32(gold.offset, out.offset);
+        TEST_ASSERT_EQUAL_UINT32(gold.length, out.length);
+        TEST_ASSERT_EQUAL_UINT32(gold.span.lines, out.span.lines);
+        TEST_ASSERT_EQUAL_UINT32(gold.span.columns, out.span.columns);
+        TEST_ASSERT_TRUE(CN(Cortecs, String, equals)(gold.text, out.text));
+        TEST_ASSERT_TRUE(gold.symbol.entry == out.symbol.entry);
+    }
+
+    // the stream ends where the whole input does
+    TEST_ASSERT_EQUAL_UINT32(0, cortecs_lexer_next_utf8_with_config(input, length, &offset, config).length);
+    TEST_ASSERT_EQUAL_UINT32(length, offset);
+    cortecs_lexer_stream_cleanup(&stream);
+}
+
+static void lexer_test_stream(void) {
+    char input[256];
+    for (int run = 0; run < 2000; run++) {
+        uint32_t length = random_utf8_input(input, 5 + rand() % (sizeof(input) - 5));
+        cortecs_lexer_config_t config = {.intern_names = run % 3 == 0, .lazy_text = run % 3 == 1};
+        // one byte chunks split every multi-byte sequence
+        assert_stream_matches_utf8(input, length, run % 4 == 0 ? 1 : 16, config);
+    }
+
+    // a long token grows the partial token
+    static char name[4096];
+    memset(name, 'a', sizeof(name));
+    assert_stream_matches_utf8(name, sizeof(name), 16, (cortecs_lexer_config_t){.intern_names = false, .lazy_text = false});
+    assert_stream_matches_utf8("", 0, 16, (cortecs_lexer_config_t){.intern_names = false, .lazy_text = false});
+}
+
 int main() {
     UNITY_BEGIN();
 
@@ -304,6 +720,20 @@ int main() {
 
     RUN_TEST(lexer_test_invalid);
 
+    RUN_TEST(lexer_test_intern_names);
+    RUN_TEST(lexer_test_utf8_empty_input);
+    RUN_TEST(lexer_test_utf8_matches_utext);
+    RUN_TEST(lexer_test_table_matches_utext_exhaustive);
+    RUN_TEST(lexer_test_lazy_text);
+    RUN_TEST(lexer_test_tokenize);
+    RUN_TEST(lexer_test_tokenize_whitespace);
+    RUN_TEST(lexer_test_keyword_near_misses);
+    RUN_TEST(lexer_test_unicode_classes_match_icu);
+    RUN_TEST(lexer_test_relex);
+    RUN_TEST(lexer_test_relex_resynchronizes);
+    RUN_TEST(lexer_test_tokenize_parallel);
+    RUN_TEST(lexer_test_stream);
+
     RUN_TEST(cortecs_lexer_test_multi_token_fuzz);
 
     return UNITY_END();
@@ -314,10 +744,12 @@ void setUp() {
     cortecs_world_init();
     cortecs_finalizer_init();
     cortecs_gc_init(NULL);
+    CN(Cortecs, Symbol, init)();
     ecs_defer_begin(world);
 }
 
 void tearDown() {
     ecs_defer_end(world);
+    CN(Cortecs, Symbol, cleanup)();
     cortecs_world_cleanup();
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/lines.h>
+#include <cortecs/span.h>
+#include <cortecs/tokens.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+// ascii, multi-byte codepoints, newlines and ill-formed sequences
+static const char *pieces[] = {
+    "a", "Z", "1", ".", " ", "\n", "\n", "+", "(",
+    "\xC3\xA9", "\xE0\xB8\x81", "\xE0\xB9\x89", "\xF0\x9F\x98\x80", "\x80", "\xE0\xA0", "\xFF",
+};
+
+static uint32_t random_input(char *input, uint32_t size) {
+    const uint32_t num_pieces = sizeof(pieces) / sizeof(pieces[0]);
+    uint32_t length = 0;
+    while (length + 4 < size) {
+        const char *piece = pieces[rand() % num_pieces];
+        memcpy(input + length, piece, strlen(piece));
+        length += strlen(piece);
+    }
+    return length;
+}
+
+static void test_lines_empty(void) {
+    cortecs_lexer_lines_t lines = cortecs_lexer_lines_of("", 0);
+    TEST_ASSERT_EQUAL_UINT32(1, lines.size);
+    TEST_ASSERT_EQUAL_UINT32(0, lines.starts->elements[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, cortecs_lexer_lines_line_of(lines, 0));
+
+    cortecs_span_t position = cortecs_lexer_lines_position(lines, "", 0, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, position.lines);
+    TEST_ASSERT_EQUAL_UINT32(0, position.columns);
+    TEST_ASSERT_EQUAL_UINT32(0, cortecs_lexer_lines_offset(lines, "", 0, (cortecs_span_t){.lines = 3, .columns = 2}));
+}
+
+static void test_lines_of(void) {
+    const char *source = "let a = 1\n\nfunction \xE0\xB8\x81() {\n}";
+    uint32_t length = strlen(source);
+    cortecs_lexer_lines_t lines = cortecs_lexer_lines_of(source, length);
+    TEST_ASSERT_EQUAL_UINT32(4, lines.size);
+    TEST_ASSERT_EQUAL_UINT32(0, lines.starts->elements[0]);
+    TEST_ASSERT_EQUAL_UINT32(10, lines.starts->elements[1]);
+    TEST_ASSERT_EQUAL_UINT32(11, lines.starts->elements[2]);
+    TEST_ASSERT_EQUAL_UINT32(28, lines.starts->elements[3]);
+
+    // the newline is the last column of its line
+    TEST_ASSERT_EQUAL_UINT32(0, cortecs_lexer_lines_line_of(lines, 9));
+    TEST_ASSERT_EQUAL_UINT32(1, cortecs_lexer_lines_line_of(lines, 10));
+    TEST_ASSERT_EQUAL_UINT32(3, cortecs_lexer_lines_line_of(lines, length));
+
+    // the thai codepoint is one column of three bytes
+    cortecs_span_t position = cortecs_lexer_lines_position(lines, source, length, 23);
+    TEST_ASSERT_EQUAL_UINT32(2, position.lines);
+    TEST_ASSERT_EQUAL_UINT32(10, position.columns);
+    TEST_ASSERT_EQUAL_UINT32(23, cortecs_lexer_lines_offset(lines, source, length, position));
+
+    // past the end of a line stops at its newline and past the last line at the end
+    TEST_ASSERT_EQUAL_UINT32(9, cortecs_lexer_lines_offset(lines, source, length, (cortecs_span_t){.lines = 0, .columns = 100}));
+    TEST_ASSERT_EQUAL_UINT32(length, cortecs_lexer_lines_offset(lines, source, length, (cortecs_span_t){.lines = 4, .columns = 0}));
+}
+
+static void test_lines_match_spans(void) {
+    char input[1024];
+    for (int run = 0; run < 500; run++) {
+        uint32_t length = random_input(input, 5 + rand() % (sizeof(input) - 5));
+        cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+        cortecs_lexer_lines_t lines = cortecs_lexer_lines_of(input, length);
+        cortecs_lexer_lines_t token_lines = cortecs_lexer_tokens_lines(tokens);
+        TEST_ASSERT_EQUAL_UINT32(lines.size, token_lines.size);
+        TEST_ASSERT_TRUE(memcmp(lines.starts->elements, token_lines.starts->elements, lines.size * sizeof(uint32_t)) == 0);
+
+        // the position of every token is the sum of the spans before it
+        cortecs_span_t sum = {.lines = 0, .columns = 0};
+        for (uint32_t i = 0; i <= tokens.size; i++) {
+            uint32_t offset = i < tokens.size ? tokens.offsets->elements[i] : length;
+            cortecs_span_t position = cortecs_lexer_lines_position(lines, input, length, offset);
+            TEST_ASSERT_EQUAL_UINT32(sum.lines, position.lines);
+            TEST_ASSERT_EQUAL_UINT32(sum.columns, position.columns);
+            TEST_ASSERT_EQUAL_UINT32(offset, cortecs_lexer_lines_offset(lines, input, length, position));
+            if (i < tokens.size) {
+                sum = cortecs_span_add(sum, cortecs_lexer_tokens_get(tokens, i).span);
+            }
+        }
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_lines_empty);
+    RUN_TEST(test_lines_of);
+    RUN_TEST(test_lines_match_spans);
+    return UNITY_END();
+}
+
+void setUp() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    ecs_defer_begin(world);
+}
+
+void tearDown() {
+    ecs_defer_end(world);
+    cortecs_world_cleanup();
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/source.h>
+#include <cortecs/string.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+static CN(Cortecs, String) write_temporary_file(const char *content, uint32_t length) {
+    char path[] = "/tmp/cortecs_source_XXXXXX";
+    int file = mkstemp(path);
+    TEST_ASSERT_TRUE(file >= 0);
+    TEST_ASSERT_TRUE(write(file, content, length) == (ssize_t)length);
+    close(file);
+    return CN(Cortecs, String, from_cstr)(path);
+}
+
+static void test_source_open(void) {
+    const char *content = "function ผลรวม(n) {\n    return n + 1\n}\n";
+    uint32_t length = strlen(content);
+    CN(Cortecs, String) path = write_temporary_file(content, length);
+
+    CN(Cortecs, Ptr, CT(cortecs_lexer_source_t)) source = cortecs_lexer_source_open(path);
+    TEST_ASSERT_NOT_NULL(source);
+    TEST_ASSERT_EQUAL_UINT32(length, source->length);
+    TEST_ASSERT_TRUE(memcmp(content, source->bytes, length) == 0);
+
+    // the byte lexer and the UText lexer read the mapping in place
+    UErrorCode status = U_ZERO_ERROR;
+    UText *text = cortecs_lexer_source_utext(source, NULL, &status);
+    TEST_ASSERT_TRUE(U_SUCCESS(status));
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(source->bytes, source->length);
+    for (uint32_t i = 0; i < tokens.size; i++) {
+        cortecs_lexer_token_t token = cortecs_lexer_next(text);
+        TEST_ASSERT_TRUE(token.tag == tokens.tags->elements[i]);
+        TEST_ASSERT_EQUAL_UINT32(token.offset, tokens.offsets->elements[i]);
+        TEST_ASSERT_EQUAL_UINT32(token.length, tokens.lengths->elements[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(length, tokens.offsets->elements[tokens.size - 1] + tokens.lengths->elements[tokens.size - 1]);
+    utext_close(text);
+
+    unlink(CN(Cortecs, String, cstr)(&path));
+}
+
+static void test_source_open_empty(void) {
+    CN(Cortecs, String) path = write_temporary_file("", 0);
+    CN(Cortecs, Ptr, CT(cortecs_lexer_source_t)) source = cortecs_lexer_source_open(path);
+    TEST_ASSERT_NOT_NULL(source);
+    TEST_ASSERT_EQUAL_UINT32(0, source->length);
+    TEST_ASSERT_EQUAL_UINT32(0, cortecs_lexer_tokenize(source->bytes, source->length).size);
+    unlink(CN(Cortecs, String, cstr)(&path));
+}
+
+static void test_source_open_missing(void) {
+    TEST_ASSERT_NULL(cortecs_lexer_source_open(CN(Cortecs, String, from_cstr)("/tmp/cortecs_source_missing/file")));
+    // directories can't be mapped
+    TEST_ASSERT_NULL(cortecs_lexer_source_open(CN(Cortecs, String, from_cstr)("/tmp")));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_source_open);
+    RUN_TEST(test_source_open_empty);
+    RUN_TEST(test_source_open_missing);
+    return UNITY_END();
+}
+
+void setUp() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    cortecs_lexer_source_init();
+    ecs_defer_begin(world);
+}
+
+void tearDown() {
+    // the sources are collected and unmapped here
+    ecs_defer_end(world);
+    cortecs_world_cleanup();
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <cortecs/span.h>
+#include <cortecs/string.h>
 #include <stdint.h>
 #include <unity.h>
 
@@ -92,10 +93,41 @@ static void test_span_add(void) {
     }
 }
 
+static void run_test_span_of(const char *text, uint32_t lines, uint32_t columns) {
+    // short enough to be stored inline
+    cortecs_span_t out = cortecs_span_of(CN(Cortecs, String, from_cstr)(text));
+    TEST_ASSERT_EQUAL_UINT32(lines, out.lines);
+    TEST_ASSERT_EQUAL_UINT32(columns, out.columns);
+}
+
+static void test_span_of(void) {
+    run_test_span_of("", 0, 0);
+    run_test_span_of("abc", 0, 3);
+    run_test_span_of("\n", 1, 0);
+    run_test_span_of("ab\ncd", 1, 2);
+    run_test_span_of("a\n\nb\n", 3, 0);
+    // columns count codepoints like the lexer. ไ้ is two codepoints
+    run_test_span_of("\xE0\xB9\x84\xE0\xB9\x89", 0, 2);
+    run_test_span_of("a\n\xE0\xB9\x84" "b", 1, 2);
+
+    // the text ends at the first null
+    cortecs_span_t early_null = cortecs_span_of(CN(Cortecs, String, from_bytes)("ab\0\ncd", 6));
+    TEST_ASSERT_EQUAL_UINT32(0, early_null.lines);
+    TEST_ASSERT_EQUAL_UINT32(2, early_null.columns);
+    early_null = cortecs_span_of(CN(Cortecs, String, from_bytes)("a\nb\0\n\nc", 7));
+    TEST_ASSERT_EQUAL_UINT32(1, early_null.lines);
+    TEST_ASSERT_EQUAL_UINT32(1, early_null.columns);
+
+    cortecs_span_t null_span = cortecs_span_of((CN(Cortecs, String)){.content = NULL});
+    TEST_ASSERT_EQUAL_UINT32(0, null_span.lines);
+    TEST_ASSERT_EQUAL_UINT32(0, null_span.columns);
+}
+
 int main() {
     UNITY_BEGIN();
     RUN_TEST(test_span_compare);
     RUN_TEST(test_span_add);
+    RUN_TEST(test_span_of);
     return UNITY_END();
 }
 
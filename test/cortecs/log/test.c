@@ -3,7 +3,9 @@
 #include <cortecs/string.h>
 #include <cortecs/world.h>
 #include <flecs.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unity.h>
 
 void test_open_log(void) {
@@ -98,12 +100,330 @@ void test_write_two_messages(void) {
     cortecs_world_cleanup();
 }
 
+static void write_numbered_message(CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream, int number) {
+    cJSON *message = cJSON_CreateObject();
+    cJSON_AddStringToObject(message, "message", "rotation");
+    cJSON_AddNumberToObject(message, "event_id", number);
+    CN(Cortecs, Log, write)(log_stream, message);
+    cJSON_Delete(message);
+}
+
+static cJSON *read_first_line(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return NULL;
+    }
+    char line[1024];
+    char *read = fgets(line, sizeof(line), file);
+    fclose(file);
+    if (read == NULL) {
+        return NULL;
+    }
+    return cJSON_Parse(line);
+}
+
+void test_rotate_by_size(void) {
+    const char *path = "./test_rotate_by_size.log";
+    char segment[64];
+    for (int i = 1; i < 16; i++) {
+        snprintf(segment, sizeof(segment), "%s.%d", path, i);
+        remove(segment);
+    }
+    remove(path);
+
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    CN(Cortecs, Log, init)();
+
+    ecs_defer_begin(world);
+
+    CN(Cortecs, Log, Config) config = {
+        .max_segment_bytes = 128,
+        .max_segment_seconds = 0,
+        .max_segments = 2,
+        .encoding = CORTECS_LOG_ENCODING_JSON,
+    };
+    CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream = CN(Cortecs, Log, open_with_config)(CN(Cortecs, String, new)("%s", path), config);
+    TEST_ASSERT_NOT_NULL(log_stream);
+
+    for (int i = 1; i <= 20; i++) {
+        write_numbered_message(log_stream, i);
+    }
+    uint64_t segments = log_stream->segment;
+    TEST_ASSERT_TRUE(segments > 3);
+
+    // collecting the log joins the rotation worker
+    ecs_defer_end(world);
+
+    // the two most recent rotated segments are kept and older ones are deleted
+    snprintf(segment, sizeof(segment), "%s.%d", path, (int)segments - 3);
+    FILE *expired = fopen(segment, "r");
+    TEST_ASSERT_NULL(expired);
+
+    for (uint64_t i = segments - 2; i <= segments; i++) {
+        const char *segment_path = path;
+        if (i != segments) {
+            snprintf(segment, sizeof(segment), "%s.%d", path, (int)i);
+            segment_path = segment;
+        }
+
+        cJSON *header = read_first_line(segment_path);
+        TEST_ASSERT_NOT_NULL(header);
+        TEST_ASSERT_EQUAL_STRING("cortecs_log_segment", cJSON_GetObjectItem(header, "method")->valuestring);
+        TEST_ASSERT_EQUAL_UINT64(i, (uint64_t)cJSON_GetObjectItem(header, "segment")->valuedouble);
+
+        // the header of a segment continues from the last event of the previous segment
+        double sequence = cJSON_GetObjectItem(header, "sequence")->valuedouble;
+        double last_event_id = cJSON_GetObjectItem(header, "last_event_id")->valuedouble;
+        TEST_ASSERT_TRUE(sequence > 0);
+        TEST_ASSERT_TRUE(sequence == last_event_id);
+        cJSON_Delete(header);
+    }
+
+    cortecs_world_cleanup();
+}
+
+void test_rotate_by_time(void) {
+    const char *path = "./test_rotate_by_time.log";
+    char segment[64];
+    for (int i = 1; i < 4; i++) {
+        snprintf(segment, sizeof(segment), "%s.%d", path, i);
+        remove(segment);
+    }
+    remove(path);
+
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    CN(Cortecs, Log, init)();
+
+    ecs_defer_begin(world);
+
+    CN(Cortecs, Log, Config) config = {
+        .max_segment_bytes = 0,
+        .max_segment_seconds = 60,
+        .max_segments = 0,
+        .encoding = CORTECS_LOG_ENCODING_JSON,
+    };
+    CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream = CN(Cortecs, Log, open_with_config)(CN(Cortecs, String, new)("%s", path), config);
+    TEST_ASSERT_NOT_NULL(log_stream);
+
+    write_numbered_message(log_stream, 1);
+    TEST_ASSERT_EQUAL_UINT64(1, log_stream->segment);
+
+    // the segment was opened a minute ago instead of sleeping for one
+    log_stream->segment_opened -= 60;
+    write_numbered_message(log_stream, 2);
+    TEST_ASSERT_EQUAL_UINT64(2, log_stream->segment);
+
+    // the new segment's clock starts at the rotation
+    write_numbered_message(log_stream, 3);
+    TEST_ASSERT_EQUAL_UINT64(2, log_stream->segment);
+
+    // collecting the log joins the rotation worker
+    ecs_defer_end(world);
+
+    snprintf(segment, sizeof(segment), "%s.1", path);
+    cJSON *header = read_first_line(segment);
+    TEST_ASSERT_NOT_NULL(header);
+    TEST_ASSERT_EQUAL_UINT64(1, (uint64_t)cJSON_GetObjectItem(header, "segment")->valuedouble);
+    cJSON_Delete(header);
+
+    header = read_first_line(path);
+    TEST_ASSERT_NOT_NULL(header);
+    TEST_ASSERT_EQUAL_UINT64(2, (uint64_t)cJSON_GetObjectItem(header, "segment")->valuedouble);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(header, "sequence")->valuedouble == 2);
+    cJSON_Delete(header);
+
+    cortecs_world_cleanup();
+}
+
+void test_interned_encoding(void) {
+    const char *path = "./test_interned_encoding.log";
+    remove(path);
+
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    CN(Cortecs, Log, init)();
+
+    ecs_defer_begin(world);
+
+    CN(Cortecs, Log, Config) config = {
+        .max_segment_bytes = 0,
+        .max_segment_seconds = 0,
+        .max_segments = 0,
+        .encoding = CORTECS_LOG_ENCODING_INTERNED,
+    };
+    CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream = CN(Cortecs, Log, open_with_config)(CN(Cortecs, String, new)("%s", path), config);
+
+    size_t json_size = 0;
+    for (int i = 0; i < 100; i++) {
+        cJSON *message = cJSON_CreateObject();
+        cJSON_AddStringToObject(message, "method", "cortecs_gc_inc");
+        cJSON_AddStringToObject(message, "file", "source/cortecs/gc/gc.c");
+        cJSON_AddNumberToObject(message, "line", i);
+        cJSON_AddNumberToObject(message, "offset", -i);
+        cJSON_AddNumberToObject(message, "ratio", i + 0.5);
+        cJSON_AddBoolToObject(message, "is_array", i % 2 == 0);
+        char *json = cJSON_PrintUnformatted(message);
+        json_size += strlen(json) + 1;
+        cJSON_free(json);
+        CN(Cortecs, Log, write)(log_stream, message);
+        cJSON_Delete(message);
+    }
+
+    ecs_defer_end(world);
+
+    FILE *file = fopen(path, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+
+    // strings are only written once so the messages are much smaller than their json
+    TEST_ASSERT_TRUE((size_t)size < json_size / 2);
+
+    CN(Cortecs, Log, Decoder) decoder;
+    CN(Cortecs, Log, Decoder, open)(&decoder, file);
+    for (int i = 0; i < 100; i++) {
+        cJSON *message = CN(Cortecs, Log, Decoder, next)(&decoder);
+        TEST_ASSERT_NOT_NULL(message);
+        TEST_ASSERT_EQUAL_STRING("cortecs_gc_inc", cJSON_GetObjectItem(message, "method")->valuestring);
+        TEST_ASSERT_EQUAL_STRING("source/cortecs/gc/gc.c", cJSON_GetObjectItem(message, "file")->valuestring);
+        TEST_ASSERT_TRUE(cJSON_GetObjectItem(message, "line")->valuedouble == i);
+        TEST_ASSERT_TRUE(cJSON_GetObjectItem(message, "offset")->valuedouble == -i);
+        TEST_ASSERT_TRUE(cJSON_GetObjectItem(message, "ratio")->valuedouble == i + 0.5);
+        TEST_ASSERT_TRUE(cJSON_IsTrue(cJSON_GetObjectItem(message, "is_array")) == (i % 2 == 0));
+        cJSON_Delete(message);
+    }
+    TEST_ASSERT_NULL(CN(Cortecs, Log, Decoder, next)(&decoder));
+    CN(Cortecs, Log, Decoder, close)(&decoder);
+    fclose(file);
+
+    cortecs_world_cleanup();
+}
+
+void test_rotate_expires_earlier_runs(void) {
+    const char *path = "./test_rotate_expires_earlier_runs.log";
+    char segment[64];
+    for (int i = 1; i < 16; i++) {
+        snprintf(segment, sizeof(segment), "%s.%d", path, i);
+        remove(segment);
+    }
+    remove(path);
+
+    // segments left by an earlier run with a gap where one was deleted by hand
+    for (int i = 1; i <= 5; i++) {
+        if (i != 3) {
+            snprintf(segment, sizeof(segment), "%s.%d", path, i);
+            FILE *file = fopen(segment, "w");
+            fclose(file);
+        }
+    }
+
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    CN(Cortecs, Log, init)();
+
+    ecs_defer_begin(world);
+
+    CN(Cortecs, Log, Config) config = {
+        .max_segment_bytes = 128,
+        .max_segment_seconds = 0,
+        .max_segments = 2,
+        .encoding = CORTECS_LOG_ENCODING_JSON,
+    };
+    CN(Cortecs, Ptr, CT(CN(Cortecs, Log))) log_stream = CN(Cortecs, Log, open_with_config)(CN(Cortecs, String, new)("%s", path), config);
+    TEST_ASSERT_NOT_NULL(log_stream);
+    TEST_ASSERT_EQUAL_UINT64(6, log_stream->segment);
+
+    // rotates once
+    while (log_stream->segment == 6) {
+        write_numbered_message(log_stream, 1);
+    }
+
+    ecs_defer_end(world);
+
+    // the earlier run's segments count against max_segments
+    for (int i = 1; i <= 6; i++) {
+        snprintf(segment, sizeof(segment), "%s.%d", path, i);
+        FILE *file = fopen(segment, "r");
+        if (i >= 5) {
+            TEST_ASSERT_NOT_NULL(file);
+            fclose(file);
+        } else {
+            TEST_ASSERT_NULL(file);
+        }
+    }
+
+    cortecs_world_cleanup();
+}
+
+void test_open_missing_directory(void) {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    CN(Cortecs, Log, init)();
+
+    // the failed open leaves nothing for the finalizer to clean up
+    ecs_defer_begin(world);
+    TEST_ASSERT_NULL(CN(Cortecs, Log, open)(CN(Cortecs, String, new)("%s", "./missing/directory/test.log")));
+    ecs_defer_end(world);
+
+    cortecs_world_cleanup();
+}
+
+// decodes a segment of the bytes after the magic. a corrupt segment ends the messages
+static cJSON *decode_first(const char *path, const uint8_t *bytes, size_t size) {
+    FILE *file = fopen(path, "wb+");
+    fwrite(CORTECS_LOG_INTERNED_MAGIC, 1, CORTECS_LOG_INTERNED_MAGIC_SIZE, file);
+    fwrite(bytes, 1, size, file);
+    rewind(file);
+
+    CN(Cortecs, Log, Decoder) decoder;
+    CN(Cortecs, Log, Decoder, open)(&decoder, file);
+    cJSON *message = CN(Cortecs, Log, Decoder, next)(&decoder);
+    CN(Cortecs, Log, Decoder, close)(&decoder);
+    fclose(file);
+    remove(path);
+    return message;
+}
+
+void test_decode_corrupt(void) {
+    // a string as long as UINT64_MAX would wrap its allocation to nothing
+    const uint8_t huge_length[] = {CORTECS_LOG_RECORD_STRING, 1, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 'a'};
+    TEST_ASSERT_NULL(decode_first("./test_decode_corrupt.log", huge_length, sizeof(huge_length)));
+
+    // longer than the rest of the file
+    const uint8_t long_length[] = {CORTECS_LOG_RECORD_STRING, 1, 0x80, 0x80, 0x80, 0x01, 'a'};
+    TEST_ASSERT_NULL(decode_first("./test_decode_corrupt.log", long_length, sizeof(long_length)));
+
+    // an id of 2^31 would overflow a 32 bit capacity while growing the table
+    const uint8_t huge_id[] = {CORTECS_LOG_RECORD_STRING, 0x80, 0x80, 0x80, 0x80, 0x08, 1, 'a'};
+    TEST_ASSERT_NULL(decode_first("./test_decode_corrupt.log", huge_id, sizeof(huge_id)));
+
+    // the same records with sane values decode
+    const uint8_t valid[] = {CORTECS_LOG_RECORD_STRING, 1, 1, 'a', CORTECS_LOG_RECORD_MESSAGE, 1, 1, CORTECS_LOG_VALUE_TRUE};
+    cJSON *message = decode_first("./test_decode_corrupt.log", valid, sizeof(valid));
+    TEST_ASSERT_NOT_NULL(message);
+    TEST_ASSERT_TRUE(cJSON_IsTrue(cJSON_GetObjectItem(message, "a")));
+    cJSON_Delete(message);
+}
+
 int main() {
     UNITY_BEGIN();
 
     RUN_TEST(test_open_log);
     RUN_TEST(test_write_one_message);
     RUN_TEST(test_write_two_messages);
+    RUN_TEST(test_rotate_by_size);
+    RUN_TEST(test_rotate_by_time);
+    RUN_TEST(test_rotate_expires_earlier_runs);
+    RUN_TEST(test_open_missing_directory);
+    RUN_TEST(test_interned_encoding);
+    RUN_TEST(test_decode_corrupt);
 
     return UNITY_END();
 }
@@ -0,0 +1,276 @@
+#include <cortecs/ast_entities.h>
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/parser.h>
+#include <cortecs/span.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#define MAX_ENTRIES 256
+
+typedef struct {
+    const char *input;
+    cortecs_lexer_tokens_t tokens;
+    cortecs_ast_t ast;
+    ecs_entity_t root;
+    ecs_entity_t *entities;
+} spawned_t;
+
+// the tree's columns are only alive until the next resolve
+static spawned_t spawn_under(const char *input, ecs_entity_t parent, cortecs_span_t span) {
+    spawned_t spawned = {.input = input};
+    spawned.tokens = cortecs_lexer_tokenize(input, strlen(input));
+    spawned.ast = cortecs_parser_parse(input, spawned.tokens);
+    spawned.entities = malloc(spawned.ast.size * sizeof(ecs_entity_t));
+    spawned.root = cortecs_ast_entities_spawn(spawned.ast, spawned.tokens, spawned.ast.root, parent, span, spawned.entities);
+    return spawned;
+}
+
+static spawned_t spawn(const char *input) {
+    return spawn_under(input, 0, (cortecs_span_t){.lines = 0, .columns = 0});
+}
+
+// spawned entities are only created once the world stops deferring
+static void resolve(void) {
+    ecs_defer_end(world);
+    cortecs_ast_entities_resolve();
+    ecs_defer_begin(world);
+}
+
+static uint32_t find_node(spawned_t spawned, cortecs_ast_tag_t tag, const char *text) {
+    for (uint32_t node = 0; node < spawned.ast.size; node++) {
+        uint32_t token = spawned.ast.tokens->elements[node];
+        if (spawned.ast.tags->elements[node] == tag && token < spawned.tokens.size && spawned.tokens.lengths->elements[token] == strlen(text) && memcmp(spawned.input + spawned.tokens.offsets->elements[token], text, strlen(text)) == 0) {
+            return node;
+        }
+    }
+    TEST_FAIL_MESSAGE(text);
+    return 0;
+}
+
+static cortecs_span_t position_of(ecs_entity_t entity) {
+    return ecs_get(world, entity, cortecs_ast_position_t)->start;
+}
+
+static void assert_position(uint32_t lines, uint32_t columns, ecs_entity_t entity) {
+    cortecs_span_t position = position_of(entity);
+    TEST_ASSERT_EQUAL_UINT32(lines, position.lines);
+    TEST_ASSERT_EQUAL_UINT32(columns, position.columns);
+}
+
+typedef struct {
+    cortecs_ast_tag_t tag;
+    uint32_t depth;
+    cortecs_span_t start;
+} entry_t;
+
+static void collect(ecs_entity_t entity, entry_t *entries, uint32_t *size) {
+    TEST_ASSERT_LESS_THAN_UINT32(MAX_ENTRIES, *size);
+    const cortecs_ast_node_t *node = ecs_get(world, entity, cortecs_ast_node_t);
+    entries[*size] = (entry_t){
+        .tag = node->tag,
+        .depth = node->depth,
+        .start = position_of(entity),
+    };
+    (*size)++;
+
+    ecs_iter_t it = ecs_children(world, entity);
+    while (ecs_children_next(&it)) {
+        for (int32_t i = 0; i < it.count; i++) {
+            collect(it.entities[i], entries, size);
+        }
+    }
+}
+
+static int compare_entries(const void *left, const void *right) {
+    const entry_t *left_entry = left;
+    const entry_t *right_entry = right;
+    int compare = cortecs_span_compare(left_entry->start, right_entry->start);
+    if (compare != 0) {
+        return compare;
+    }
+    if (left_entry->depth != right_entry->depth) {
+        return left_entry->depth < right_entry->depth ? -1 : 1;
+    }
+    return (int)left_entry->tag - (int)right_entry->tag;
+}
+
+// the edited tree has the same nodes at the same positions as the tree spawned from the edited text
+static void assert_same_tree(ecs_entity_t edited, ecs_entity_t expected) {
+    entry_t edited_entries[MAX_ENTRIES];
+    entry_t expected_entries[MAX_ENTRIES];
+    uint32_t num_edited = 0;
+    uint32_t num_expected = 0;
+    collect(edited, edited_entries, &num_edited);
+    collect(expected, expected_entries, &num_expected);
+    qsort(edited_entries, num_edited, sizeof(entry_t), compare_entries);
+    qsort(expected_entries, num_expected, sizeof(entry_t), compare_entries);
+
+    TEST_ASSERT_EQUAL_UINT32(num_expected, num_edited);
+    for (uint32_t i = 0; i < num_expected; i++) {
+        TEST_ASSERT_EQUAL_INT(expected_entries[i].tag, edited_entries[i].tag);
+        TEST_ASSERT_EQUAL_UINT32(expected_entries[i].depth, edited_entries[i].depth);
+        TEST_ASSERT_EQUAL_UINT32(expected_entries[i].start.lines, edited_entries[i].start.lines);
+        TEST_ASSERT_EQUAL_UINT32(expected_entries[i].start.columns, edited_entries[i].start.columns);
+    }
+}
+
+static void test_ast_entities_positions(void) {
+    spawned_t spawned = spawn("function f(x: I32) {\n    let ñame = (x + 1) * x\n    return ñame\n}\n\nfunction g() {}\n");
+    ecs_entity_t function = spawned.entities[find_node(spawned, CORTECS_AST_FUNCTION, "f")];
+    ecs_entity_t parameter = spawned.entities[find_node(spawned, CORTECS_AST_PARAMETER, "x")];
+    ecs_entity_t let = spawned.entities[find_node(spawned, CORTECS_AST_LET, "ñame")];
+    ecs_entity_t times = spawned.entities[find_node(spawned, CORTECS_AST_BINARY_P5, "*")];
+    ecs_entity_t plus = spawned.entities[find_node(spawned, CORTECS_AST_BINARY_P4, "+")];
+    ecs_entity_t one = spawned.entities[find_node(spawned, CORTECS_AST_ATOMIC, "1")];
+    ecs_entity_t returned = spawned.entities[find_node(spawned, CORTECS_AST_ATOMIC, "ñame")];
+    ecs_entity_t last = spawned.entities[find_node(spawned, CORTECS_AST_FUNCTION, "g")];
+    resolve();
+
+    assert_position(0, 0, spawned.root);
+    // nodes start where the parser's extent of them starts
+    assert_position(0, 0, function);
+    assert_position(0, 11, parameter);
+    assert_position(1, 4, let);
+    assert_position(1, 15, times);
+    assert_position(1, 16, plus);
+    assert_position(1, 20, one);
+    // columns count codepoints
+    assert_position(2, 11, returned);
+    assert_position(5, 0, last);
+
+    // spans are relative to the parent
+    const cortecs_span_t *span = ecs_get(world, one, cortecs_span_t);
+    TEST_ASSERT_EQUAL_UINT32(0, span->lines);
+    TEST_ASSERT_EQUAL_UINT32(4, span->columns);
+    span = ecs_get(world, last, cortecs_span_t);
+    TEST_ASSERT_EQUAL_UINT32(5, span->lines);
+    TEST_ASSERT_EQUAL_UINT32(0, span->columns);
+    free(spawned.entities);
+}
+
+static void test_ast_entities_other_parent(void) {
+    // like an entity for the file the tree is in
+    ecs_entity_t file = ecs_new(world);
+    spawned_t spawned = spawn_under("function f() {\n    return 1\n}\n", file, (cortecs_span_t){.lines = 2, .columns = 0});
+    ecs_entity_t one = spawned.entities[find_node(spawned, CORTECS_AST_ATOMIC, "1")];
+    resolve();
+
+    // the root is resolved like the roots spawned under nothing
+    TEST_ASSERT_EQUAL_UINT32(0, ecs_get(world, spawned.root, cortecs_ast_node_t)->depth);
+    TEST_ASSERT_EQUAL_UINT64(file, ecs_get_parent(world, spawned.root));
+    assert_position(2, 0, spawned.root);
+    assert_position(3, 11, one);
+    free(spawned.entities);
+}
+
+// a left associative chain is as deep as it's long so spawn and resolve can't recurse
+static void test_ast_entities_deep(void) {
+    const uint32_t num_operators = 100000;
+    const char *prefix = "function f() {\n    let x = a";
+    char *input = malloc(strlen(prefix) + 4 * num_operators + 4);
+    uint32_t length = sprintf(input, "%s", prefix);
+    for (uint32_t i = 0; i < num_operators; i++) {
+        length += sprintf(input + length, " + a");
+    }
+    sprintf(input + length, "\n}\n");
+
+    spawned_t spawned = spawn(input);
+    uint32_t let = find_node(spawned, CORTECS_AST_LET, "x");
+    uint32_t sum = cortecs_ast_child(spawned.ast, let, 0);
+    uint32_t last = cortecs_ast_child(spawned.ast, sum, 1);
+    uint32_t first = find_node(spawned, CORTECS_AST_ATOMIC, "a");
+    resolve();
+
+    TEST_ASSERT_EQUAL_UINT32(ecs_get(world, spawned.entities[let], cortecs_ast_node_t)->depth + 1 + num_operators, ecs_get(world, spawned.entities[first], cortecs_ast_node_t)->depth);
+    assert_position(1, 12, spawned.entities[sum]);
+    assert_position(1, 12, spawned.entities[first]);
+    assert_position(1, 12 + 4 * num_operators, spawned.entities[last]);
+    free(spawned.entities);
+    free(input);
+}
+
+static void test_ast_entities_rename(void) {
+    spawned_t before = spawn("function f() {\n    let x = a + b\n    return x\n}\n");
+    ecs_entity_t let = before.entities[find_node(before, CORTECS_AST_LET, "x")];
+    ecs_entity_t a = before.entities[find_node(before, CORTECS_AST_ATOMIC, "a")];
+    resolve();
+
+    // only the value after the name moves. the return is on another line
+    TEST_ASSERT_EQUAL_UINT32(1, cortecs_ast_entities_shift(let, (cortecs_span_t){.lines = 1, .columns = 9}, (cortecs_span_t){.lines = 1, .columns = 11}));
+    spawned_t after = spawn("function f() {\n    let xyz = a + b\n    return x\n}\n");
+    resolve();
+    assert_same_tree(before.root, after.root);
+
+    // b is a later sibling of a
+    TEST_ASSERT_EQUAL_UINT32(1, cortecs_ast_entities_shift(a, (cortecs_span_t){.lines = 1, .columns = 15}, (cortecs_span_t){.lines = 1, .columns = 19}));
+    spawned_t renamed = spawn("function f() {\n    let xyz = alpha + b\n    return x\n}\n");
+    resolve();
+    assert_same_tree(before.root, renamed.root);
+
+    free(before.entities);
+    free(after.entities);
+    free(renamed.entities);
+}
+
+static void test_ast_entities_insert_line(void) {
+    spawned_t before = spawn("function f() {\n    let x = 1\n    return x\n}\nfunction g() {\n    return\n}\n");
+    ecs_entity_t body = before.entities[find_node(before, CORTECS_AST_BODY, "{")];
+    resolve();
+
+    // the return and g move down a line. nothing under them changes
+    TEST_ASSERT_EQUAL_UINT32(2, cortecs_ast_entities_shift(body, (cortecs_span_t){.lines = 2, .columns = 0}, (cortecs_span_t){.lines = 3, .columns = 0}));
+    spawned_t after = spawn("function f() {\n    let x = 1\n    let y = 2\n    return x\n}\nfunction g() {\n    return\n}\n");
+    cortecs_ast_entities_spawn(after.ast, after.tokens, find_node(after, CORTECS_AST_LET, "y"), body, (cortecs_span_t){.lines = 2, .columns = 4}, NULL);
+    resolve();
+    assert_same_tree(before.root, after.root);
+
+    free(before.entities);
+    free(after.entities);
+}
+
+static void test_ast_entities_delete_line(void) {
+    spawned_t before = spawn("function f() {\n    let x = 1\n    let y = 2\n    return x\n}\nfunction g() {\n    return\n}\n");
+    ecs_entity_t body = before.entities[find_node(before, CORTECS_AST_BODY, "{")];
+    ecs_entity_t let = before.entities[find_node(before, CORTECS_AST_LET, "y")];
+    resolve();
+
+    ecs_delete(world, let);
+    TEST_ASSERT_EQUAL_UINT32(2, cortecs_ast_entities_shift(body, (cortecs_span_t){.lines = 3, .columns = 0}, (cortecs_span_t){.lines = 2, .columns = 0}));
+    spawned_t after = spawn("function f() {\n    let x = 1\n    return x\n}\nfunction g() {\n    return\n}\n");
+    resolve();
+    assert_same_tree(before.root, after.root);
+
+    free(before.entities);
+    free(after.entities);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ast_entities_positions);
+    RUN_TEST(test_ast_entities_other_parent);
+    RUN_TEST(test_ast_entities_deep);
+    RUN_TEST(test_ast_entities_rename);
+    RUN_TEST(test_ast_entities_insert_line);
+    RUN_TEST(test_ast_entities_delete_line);
+    return UNITY_END();
+}
+
+void setUp() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    cortecs_span_init();
+    cortecs_ast_entities_init();
+    ecs_defer_begin(world);
+}
+
+void tearDown() {
+    ecs_defer_end(world);
+    cortecs_world_cleanup();
+}
\ No newline at end of file
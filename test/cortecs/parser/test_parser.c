@@ -0,0 +1,405 @@
+#include <cortecs/gc.h>
+#include <cortecs/lexer.h>
+#include <cortecs/parser.h>
+#include <cortecs/tokens.h>
+#include <cortecs/world.h>
+#include <flecs.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+
+#define MAX_TREE_LENGTH 1024
+
+// writes the node as an s-expression of its tag, its token's text and its children
+static uint32_t write_tree(cortecs_ast_t ast, const char *input, cortecs_lexer_tokens_t tokens, uint32_t node, char *out, uint32_t size) {
+    uint32_t written = snprintf(out, size, "(%s", cortecs_ast_tag_to_string(ast.tags->elements[node]));
+    uint32_t token = ast.tokens->elements[node];
+    if (ast.tags->elements[node] != CORTECS_AST_FILE && token < tokens.size) {
+        written += snprintf(out + written, size - written, " %.*s", (int)tokens.lengths->elements[token], input + tokens.offsets->elements[token]);
+    }
+    for (uint32_t i = 0; i < ast.num_children->elements[node]; i++) {
+        written += snprintf(out + written, size - written, " ");
+        written += write_tree(ast, input, tokens, cortecs_ast_child(ast, node, i), out + written, size - written);
+    }
+    written += snprintf(out + written, size - written, ")");
+    return written;
+}
+
+// every node but the root is the child of exactly one node that comes after it
+static void assert_well_formed(cortecs_ast_t ast) {
+    TEST_ASSERT_EQUAL_UINT32(ast.size - 1, ast.root);
+    TEST_ASSERT_EQUAL_UINT8(CORTECS_AST_FILE, ast.tags->elements[ast.root]);
+
+    uint32_t *parents = malloc(ast.size * sizeof(uint32_t));
+    memset(parents, 0xFF, ast.size * sizeof(uint32_t));
+    uint32_t num_errors = 0;
+    for (uint32_t node = 0; node < ast.size; node++) {
+        for (uint32_t i = 0; i < ast.num_children->elements[node]; i++) {
+            uint32_t child = cortecs_ast_child(ast, node, i);
+            TEST_ASSERT_LESS_THAN_UINT32(node, child);
+            TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, parents[child]);
+            parents[child] = node;
+        }
+        num_errors += ast.tags->elements[node] == CORTECS_AST_ERROR;
+    }
+    for (uint32_t node = 0; node < ast.root; node++) {
+        TEST_ASSERT_NOT_EQUAL(UINT32_MAX, parents[node]);
+    }
+
+    // children are in order inside their parent's tokens and a node's descendants are the nodes just before it
+    uint32_t *firsts = malloc(ast.size * sizeof(uint32_t));
+    for (uint32_t node = 0; node < ast.size; node++) {
+        uint32_t start = ast.token_starts->elements[node];
+        uint32_t end = ast.token_ends->elements[node];
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(end, start);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(ast.tokens->elements[node], start);
+        firsts[node] = node;
+        uint32_t previous_end = start;
+        for (uint32_t i = 0; i < ast.num_children->elements[node]; i++) {
+            uint32_t child = cortecs_ast_child(ast, node, i);
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(ast.token_starts->elements[child], previous_end);
+            previous_end = ast.token_ends->elements[child];
+            if (i > 0) {
+                TEST_ASSERT_EQUAL_UINT32(cortecs_ast_child(ast, node, i - 1), firsts[child] - 1);
+            }
+        }
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(end, previous_end);
+        if (ast.num_children->elements[node] > 0) {
+            TEST_ASSERT_EQUAL_UINT32(node - 1, cortecs_ast_child(ast, node, ast.num_children->elements[node] - 1));
+            firsts[node] = firsts[cortecs_ast_child(ast, node, 0)];
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(num_errors, ast.num_errors);
+    free(parents);
+    free(firsts);
+}
+
+static void assert_parses(const char *input, const char *gold) {
+    uint32_t length = strlen(input);
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+    cortecs_ast_t ast = cortecs_parser_parse(input, tokens);
+    assert_well_formed(ast);
+
+    char tree[MAX_TREE_LENGTH];
+    write_tree(ast, input, tokens, ast.root, tree, sizeof(tree));
+    TEST_ASSERT_EQUAL_STRING(gold, tree);
+}
+
+// parses the expression as the value of a let and compares the value's tree
+static void assert_expression(const char *expression, const char *gold) {
+    char input[256];
+    snprintf(input, sizeof(input), "function f() {\n    let x = %s\n}\n", expression);
+    char tree[MAX_TREE_LENGTH];
+    snprintf(tree, sizeof(tree), "(file (function f (body { (let x %s))))", gold);
+    assert_parses(input, tree);
+}
+
+static void test_parser_empty(void) {
+    assert_parses("", "(file)");
+    assert_parses("\n  \n", "(file)");
+}
+
+static void test_parser_functions(void) {
+    assert_parses("function f() {}", "(file (function f (body {)))");
+    assert_parses(
+        "function add(x: I32, y: I32): I32 {\n    return x + y\n}\n",
+        "(file (function add (parameter x (type I32)) (parameter y (type I32)) (type I32) (body { (return return (binary_p4 + (atomic x) (atomic y))))))");
+    assert_parses(
+        "function greet() {\n    println(name)\n    return\n}\n\nfunction main() {\n}\n",
+        "(file (function greet (body { (function_call println (atomic name)) (return return))) (function main (body {)))");
+    assert_parses(
+        "function f(\n    x: I32,\n    y: F32\n) {\n}",
+        "(file (function f (parameter x (type I32)) (parameter y (type F32)) (body {)))");
+}
+
+static void test_parser_precedence(void) {
+    assert_expression("a + b * c", "(binary_p4 + (atomic a) (binary_p5 * (atomic b) (atomic c)))");
+    assert_expression("a * b + c", "(binary_p4 + (binary_p5 * (atomic a) (atomic b)) (atomic c))");
+    assert_expression("a - b - c", "(binary_p4 - (binary_p4 - (atomic a) (atomic b)) (atomic c))");
+    assert_expression("a | b == c < d + e % f", "(binary_p1 | (atomic a) (binary_p2 == (atomic b) (binary_p3 < (atomic c) (binary_p4 + (atomic d) (binary_p5 % (atomic e) (atomic f))))))");
+    assert_expression("a % b + c < d == e & f", "(binary_p1 & (binary_p2 == (binary_p3 < (binary_p4 + (binary_p5 % (atomic a) (atomic b)) (atomic c)) (atomic d)) (atomic e)) (atomic f))");
+    assert_expression("a <= b != c", "(binary_p2 != (binary_p3 <= (atomic a) (atomic b)) (atomic c))");
+    assert_expression("-a * !b", "(binary_p5 * (unary - (atomic a)) (unary ! (atomic b)))");
+    assert_expression("(a + b) * c", "(binary_p5 * (expression ( (binary_p4 + (atomic a) (atomic b))) (atomic c))");
+    assert_expression("1 + 2.5 * Pi", "(binary_p4 + (atomic 1) (binary_p5 * (atomic 2.5) (atomic Pi)))");
+    // an operator at the end of a line continues the expression on the next
+    assert_expression("a +\n        b", "(binary_p4 + (atomic a) (atomic b))");
+}
+
+static void test_parser_calls(void) {
+    assert_expression("f()", "(function_call f)");
+    assert_expression("f(a, g(b), 1 + 2)", "(function_call f (atomic a) (function_call g (atomic b)) (binary_p4 + (atomic 1) (atomic 2)))");
+    assert_expression("f (a) * g(\n        b,\n        c\n    )", "(binary_p5 * (function_call f (atomic a)) (function_call g (atomic b) (atomic c)))");
+    assert_expression("fib(n - 1) + fib(n - 2)", "(binary_p4 + (function_call fib (binary_p4 - (atomic n) (atomic 1))) (function_call fib (binary_p4 - (atomic n) (atomic 2))))");
+}
+
+static void test_parser_statements(void) {
+    assert_parses(
+        "function f() {\n    let a = 1\n    let b = a\n        * 2\n    b\n}",
+        "(file (function f (body { (let a (atomic 1)) (let b (atomic a)) (unary * (atomic 2)) (atomic b))))");
+    assert_parses(
+        "function f() { return 1 }",
+        "(file (function f (body { (return return (atomic 1)))))");
+}
+
+static void test_parser_errors(void) {
+    // a missing name
+    assert_parses(
+        "function f() {\n    let = 1\n    return 2\n}",
+        "(file (function f (body { (let = (error =)) (return return (atomic 2)))))");
+    // two expressions on a line
+    assert_parses(
+        "function f() {\n    a b c\n    return\n}",
+        "(file (function f (body { (atomic a) (error b) (return return))))");
+    // an operator without a right operand
+    assert_parses(
+        "function f() {\n    let x = a +\n}",
+        "(file (function f (body { (let x (binary_p4 + (atomic a) (error }))))))");
+    // an unclosed parenthesis
+    assert_parses(
+        "function f() {\n    g(a\n}",
+        "(file (function f (body { (function_call g (atomic a) (error })))))");
+    // an unclosed body ends at the end of the input
+    assert_parses("function f() {\n    return 1\n", "(file (function f (body { (return return (atomic 1)) (error))))");
+    // anything but a function at the top level
+    assert_parses("let x = 1\n}\nfunction f() {}", "(file (error let) (error }) (function f (body {)))");
+    assert_parses("function (x: I32) {}\nfunction g() {}", "(file (function ( (error ()) (function g (body {)))");
+    assert_parses("function f(x I32) {\n}\nfunction g() {}", "(file (function f (parameter x (error I32))) (error }) (function g (body {)))");
+}
+
+static void test_parser_generics(void) {
+    assert_parses(
+        "function identity<T>(t: T): T {\n    return t\n}\n",
+        "(file (function identity (type_parameter T) (parameter t (type T)) (type T) (body { (return return (atomic t)))))");
+    assert_parses(
+        "function first<K, V>(map: Map<K, V>, key: K): Option<V> {}",
+        "(file (function first (type_parameter K) (type_parameter V) (parameter map (type Map (type K) (type V))) (parameter key (type K)) (type Option (type V)) (body {)))");
+    assert_expression("identity<I32>(1)", "(function_call identity (type I32) (atomic 1))");
+    assert_expression("make<K, V>()", "(function_call make (type K) (type V))");
+    // a >> closes two lists of type arguments
+    assert_parses(
+        "function f(x: Foo<Bar<I32>, Baz>): Map<K, List<V>> {}",
+        "(file (function f (parameter x (type Foo (type Bar (type I32)) (type Baz))) (type Map (type K) (type List (type V))) (body {)))");
+    assert_expression("f<List<T>>(x)", "(function_call f (type List (type T)) (atomic x))");
+    assert_expression("f<A<B<C>>>(x)", "(function_call f (type A (type B (type C))) (atomic x))");
+    assert_parses("function f(x: Foo<Bar>>) {}", "(file (function f (parameter x (type Foo (type Bar)) (error >>))))");
+    // a < that isn't right after the name, isn't followed by a type or whose > isn't followed by a ( is an operator
+    assert_expression("a < B", "(binary_p3 < (atomic a) (atomic B))");
+    assert_expression("x<Y", "(binary_p3 < (atomic x) (atomic Y))");
+    assert_expression("a<b>(c)", "(binary_p3 > (binary_p3 < (atomic a) (atomic b)) (expression ( (atomic c)))");
+    assert_expression("a<B>c", "(binary_p3 > (binary_p3 < (atomic a) (atomic B)) (atomic c))");
+    assert_expression("a<B>>(c)", "(binary_p3 >> (binary_p3 < (atomic a) (atomic B)) (expression ( (atomic c)))");
+}
+
+// nesting past the limit is an error instead of a stack overflow
+static void test_parser_depth(void) {
+    static char input[600000];
+    uint32_t length = 0;
+    length += sprintf(input + length, "function f() {\n    let x = ");
+    for (int i = 0; i < 100000; i++) {
+        input[length++] = '(';
+    }
+    length += sprintf(input + length, "1\n    let y = ");
+    for (int i = 0; i < 100000; i++) {
+        input[length++] = '-';
+        input[length++] = ' ';
+    }
+    length += sprintf(input + length, "1\n    return x\n}\nfunction g(x: ");
+    for (int i = 0; i < 100000; i++) {
+        length += sprintf(input + length, "A<");
+    }
+    length += sprintf(input + length, "A) {}\n");
+
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+    cortecs_ast_t ast = cortecs_parser_parse(input, tokens);
+    assert_well_formed(ast);
+    TEST_ASSERT_EQUAL_UINT32(3, ast.num_errors);
+    TEST_ASSERT_EQUAL_UINT32(2, ast.num_children->elements[ast.root]);
+
+    // the statements after the deep ones still parse
+    uint32_t body = cortecs_ast_child(ast, cortecs_ast_child(ast, ast.root, 0), 0);
+    TEST_ASSERT_EQUAL_UINT32(3, ast.num_children->elements[body]);
+    TEST_ASSERT_EQUAL_UINT8(CORTECS_AST_RETURN, ast.tags->elements[cortecs_ast_child(ast, body, 2)]);
+}
+
+// the fuzz tests start from CORTECS_PARSER_TEST_SEED when it's set and from the clock otherwise
+static uint64_t test_seed(const char *test) {
+    const char *variable = getenv("CORTECS_PARSER_TEST_SEED");
+    uint64_t seed = variable != NULL ? strtoull(variable, NULL, 0) : (uint64_t)time(NULL);
+    printf("%s: seed 0x%016" PRIx64 " (rerun with CORTECS_PARSER_TEST_SEED=0x%016" PRIx64 ")\n", test, seed, seed);
+    return seed;
+}
+
+// a number below bound from a splitmix64 stream
+static uint32_t random_below(uint64_t *state, uint32_t bound) {
+    *state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = *state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (uint32_t)((z ^ (z >> 31)) >> 32) % bound;
+}
+
+// random token soup always parses to a well formed tree
+static void test_parser_fuzz(void) {
+    static const char *pieces[] = {
+        "function", "let", "return", "f", "x", "I32", "1", "2.5", "(", ")", "{", "}",
+        ",", ":", "+", "*", "==", "<", "-", "\n", " ", "if", ".", ";"};
+    const uint32_t num_pieces = sizeof(pieces) / sizeof(pieces[0]);
+    char input[512];
+    uint64_t state = test_seed("test_parser_fuzz");
+    for (int times = 0; times < 5000; times++) {
+        uint32_t length = 0;
+        while (length + 16 < sizeof(input)) {
+            const char *piece = pieces[random_below(&state, num_pieces)];
+            memcpy(input + length, piece, strlen(piece));
+            length += strlen(piece);
+            input[length++] = ' ';
+        }
+        cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(input, length);
+        assert_well_formed(cortecs_parser_parse(input, tokens));
+    }
+}
+
+static void assert_column_equal(CN(Cortecs, Array, CT(CN(Cortecs, U32))) expected, CN(Cortecs, Array, CT(CN(Cortecs, U32))) actual, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        TEST_ASSERT_EQUAL_UINT32(expected->elements[i], actual->elements[i]);
+    }
+}
+
+static void assert_ast_equal(cortecs_ast_t expected, cortecs_ast_t actual) {
+    TEST_ASSERT_EQUAL_UINT32(expected.size, actual.size);
+    TEST_ASSERT_EQUAL_UINT32(expected.root, actual.root);
+    TEST_ASSERT_EQUAL_UINT32(expected.num_errors, actual.num_errors);
+    TEST_ASSERT_EQUAL_UINT32(expected.children->size, actual.children->size);
+    for (uint32_t i = 0; i < expected.size; i++) {
+        TEST_ASSERT_EQUAL_UINT8(expected.tags->elements[i], actual.tags->elements[i]);
+    }
+    assert_column_equal(expected.tokens, actual.tokens, expected.size);
+    assert_column_equal(expected.token_starts, actual.token_starts, expected.size);
+    assert_column_equal(expected.token_ends, actual.token_ends, expected.size);
+    assert_column_equal(expected.first_children, actual.first_children, expected.size);
+    assert_column_equal(expected.num_children, actual.num_children, expected.size);
+    assert_column_equal(expected.children, actual.children, expected.children->size);
+}
+
+// reparses the edit of before into after and checks the tree is the tree of after
+static cortecs_parser_reparse_t assert_reparses(const char *before, const char *after, cortecs_lexer_edit_t edit) {
+    uint32_t length = strlen(after);
+    cortecs_lexer_tokens_t tokens = cortecs_lexer_tokenize(before, strlen(before));
+    cortecs_ast_t ast = cortecs_parser_parse(before, tokens);
+    cortecs_lexer_relex_t relex = cortecs_lexer_relex(tokens, after, length, edit);
+    cortecs_parser_reparse_t reparse = cortecs_parser_reparse(ast, tokens, after, relex, edit);
+    cortecs_ast_t applied = cortecs_parser_apply(ast, relex, reparse);
+    assert_well_formed(applied);
+    assert_ast_equal(cortecs_parser_parse(after, cortecs_lexer_tokenize(after, length)), applied);
+
+    // reused nodes are identical to the old ones up to where their tokens moved
+    for (uint32_t i = 0; i < reparse.inserted.size; i++) {
+        uint32_t old = reparse.reused->elements[i];
+        if (old != UINT32_MAX) {
+            TEST_ASSERT_EQUAL_UINT8(ast.tags->elements[old], applied.tags->elements[reparse.first + i]);
+            TEST_ASSERT_EQUAL_UINT32(ast.num_children->elements[old], applied.num_children->elements[reparse.first + i]);
+        }
+    }
+    return reparse;
+}
+
+static void test_parser_reparse(void) {
+    const char *before =
+        "function f(x: I32) {\n    let a = x + 1\n    return a\n}\n"
+        "function g() {\n    println(a, b)\n}\n"
+        "function h(): F32 {\n    return 2.5 * Pi\n}\n";
+
+    // renaming a in f only reparses f and keeps the nodes that don't contain it
+    const char *after = "function f(x: I32) {\n    let ab = x + 1\n    return a\n}\n"
+                        "function g() {\n    println(a, b)\n}\n"
+                        "function h(): F32 {\n    return 2.5 * Pi\n}\n";
+    cortecs_parser_reparse_t reparse = assert_reparses(before, after, (cortecs_lexer_edit_t){.offset = strlen("function f(x: I32) {\n    let a"), .removed = 0, .inserted = 1});
+    TEST_ASSERT_EQUAL_UINT32(0, reparse.first_item);
+    TEST_ASSERT_EQUAL_UINT32(1, reparse.removed_items);
+    // the let and the function and body around it
+    TEST_ASSERT_EQUAL_UINT32(3, reparse.changed->size);
+
+    // editing g starts at g
+    after = "function f(x: I32) {\n    let a = x + 1\n    return a\n}\n"
+            "function g() {\n    println(a, c)\n}\n"
+            "function h(): F32 {\n    return 2.5 * Pi\n}\n";
+    reparse = assert_reparses(before, after, (cortecs_lexer_edit_t){.offset = strlen(before) - strlen("b)\n}\nfunction h(): F32 {\n    return 2.5 * Pi\n}\n"), .removed = 1, .inserted = 1});
+    TEST_ASSERT_EQUAL_UINT32(1, reparse.first_item);
+    TEST_ASSERT_EQUAL_UINT32(1, reparse.removed_items);
+
+    // an unclosed body takes the lines of g up to its } so parsing stops at h
+    after = "function f(x: I32) {\n    let a = x + 1\n    return a\n\n"
+            "function g() {\n    println(a, b)\n}\n"
+            "function h(): F32 {\n    return 2.5 * Pi\n}\n";
+    reparse = assert_reparses(before, after, (cortecs_lexer_edit_t){.offset = strlen("function f(x: I32) {\n    let a = x + 1\n    return a\n"), .removed = 1, .inserted = 0});
+    TEST_ASSERT_EQUAL_UINT32(2, reparse.removed_items);
+}
+
+// random edits of random functions reparse to the same tree as parsing the edited text
+static void test_parser_reparse_fuzz(void) {
+    static const char *lines[] = {
+        "function f(x: I32) {\n", "function g(): F32 {\n", "    let a = x + 1\n", "    return a * (b - 2)\n",
+        "    println(a, b)\n", "}\n", "\n", "    let = \n", "let x = 1\n"};
+    static const char *pieces[] = {
+        "function", "let", "return", "f", "x", "I32", "1", "(", ")", "{", "}", ",", ":", "+", "*", "\n", " ", "}\nfunction g() {\n"};
+    const uint32_t num_lines = sizeof(lines) / sizeof(lines[0]);
+    const uint32_t num_pieces = sizeof(pieces) / sizeof(pieces[0]);
+    char before[1024];
+    char after[1024];
+    uint64_t state = test_seed("test_parser_reparse_fuzz");
+    for (int times = 0; times < 3000; times++) {
+        uint32_t length = 0;
+        while (length + 32 < sizeof(before) / 2) {
+            // mostly well formed functions
+            const char *line = random_below(&state, 4) == 0 ? lines[random_below(&state, num_lines)] : lines[(length / 24) % 6];
+            memcpy(before + length, line, strlen(line));
+            length += strlen(line);
+        }
+        before[length] = '\0';
+
+        cortecs_lexer_edit_t edit = {.offset = random_below(&state, length + 1), .inserted = 0};
+        edit.removed = random_below(&state, length - edit.offset + 1) % 12;
+        memcpy(after, before, edit.offset);
+        for (int i = random_below(&state, 3); i > 0; i--) {
+            const char *piece = pieces[random_below(&state, num_pieces)];
+            memcpy(after + edit.offset + edit.inserted, piece, strlen(piece));
+            edit.inserted += strlen(piece);
+        }
+        memcpy(after + edit.offset + edit.inserted, before + edit.offset + edit.removed, length - edit.offset - edit.removed);
+        after[length - edit.removed + edit.inserted] = '\0';
+        assert_reparses(before, after, edit);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_parser_empty);
+    RUN_TEST(test_parser_functions);
+    RUN_TEST(test_parser_precedence);
+    RUN_TEST(test_parser_calls);
+    RUN_TEST(test_parser_statements);
+    RUN_TEST(test_parser_errors);
+    RUN_TEST(test_parser_generics);
+    RUN_TEST(test_parser_depth);
+    RUN_TEST(test_parser_fuzz);
+    RUN_TEST(test_parser_reparse);
+    RUN_TEST(test_parser_reparse_fuzz);
+    return UNITY_END();
+}
+
+void setUp() {
+    cortecs_world_init();
+    cortecs_finalizer_init();
+    cortecs_gc_init(NULL);
+    ecs_defer_begin(world);
+}
+
+void tearDown() {
+    ecs_defer_end(world);
+    cortecs_world_cleanup();
+}
\ No newline at end of file
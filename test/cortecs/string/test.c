@@ -1,7 +1,10 @@
 #include <cortecs/gc.h>
+#include <cortecs/kernel.h>
 #include <cortecs/string.h>
+#include <cortecs/symbol.h>
 #include <cortecs/world.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unity.h>
@@ -10,7 +13,7 @@ static void run_test_new_string(const char *target) {
     uint32_t target_length = strlen(target) + 1;
     CN(Cortecs, String) out = CN(Cortecs, String, new)("%s", target);
     TEST_ASSERT_EQUAL_UINT32(target_length, CN(Cortecs, String, capacity)(out));
-    TEST_ASSERT_EQUAL_MEMORY(target, out.content->elements, target_length);
+    TEST_ASSERT_EQUAL_MEMORY(target, CN(Cortecs, String, cstr)(&out), target_length);
 }
 
 static void test_copy_cstring(void) {
@@ -18,6 +21,208 @@ static void test_copy_cstring(void) {
     run_test_new_string("hello world");
 }
 
+static void test_copy_long_cstring(void) {
+    // longer than the scratch buffer used for formatting
+    char target[1024];
+    memset(target, 'a', sizeof(target) - 1);
+    target[sizeof(target) - 1] = 0;
+    run_test_new_string(target);
+}
+
+static void test_format(void) {
+    CN(Cortecs, String) out = CN(Cortecs, String, new)("%s %" PRIu32 " %c", "foo", UINT32_C(42), 'x');
+    TEST_ASSERT_EQUAL_UINT32(sizeof("foo 42 x"), CN(Cortecs, String, capacity)(out));
+    TEST_ASSERT_EQUAL_STRING("foo 42 x", CN(Cortecs, String, cstr)(&out));
+}
+
+static void test_from_bytes(void) {
+    const char *source = "hello world";
+    CN(Cortecs, String) out = CN(Cortecs, String, from_bytes)(source, 5);
+    TEST_ASSERT_EQUAL_UINT32(6, CN(Cortecs, String, capacity)(out));
+    TEST_ASSERT_EQUAL_STRING("hello", CN(Cortecs, String, cstr)(&out));
+
+    CN(Cortecs, String) empty = CN(Cortecs, String, from_bytes)(source, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, CN(Cortecs, String, capacity)(empty));
+    TEST_ASSERT_EQUAL_STRING("", CN(Cortecs, String, cstr)(&empty));
+}
+
+static void test_from_cstr(void) {
+    CN(Cortecs, String) out = CN(Cortecs, String, from_cstr)("hello world");
+    CN(Cortecs, String) expected = CN(Cortecs, String, new)("%s", "hello world");
+    TEST_ASSERT_TRUE(CN(Cortecs, String, equals)(out, expected));
+}
+
+static void test_builder_append(void) {
+    CN(Cortecs, String, Builder) builder = CN(Cortecs, String, Builder, new)(0);
+    CN(Cortecs, String, Builder, append_bytes)(&builder, "hello", 5);
+    CN(Cortecs, String, Builder, append_codepoint)(&builder, ' ');
+    CN(Cortecs, String, Builder, append_string)(&builder, CN(Cortecs, String, from_cstr)("world"));
+    CN(Cortecs, String, Builder, append_format)(&builder, " %d", 42);
+    CN(Cortecs, String) out = CN(Cortecs, String, Builder, finish)(&builder);
+
+    TEST_ASSERT_EQUAL_UINT32(sizeof("hello world 42"), CN(Cortecs, String, capacity)(out));
+    TEST_ASSERT_EQUAL_STRING("hello world 42", CN(Cortecs, String, cstr)(&out));
+}
+
+static void test_builder_codepoints(void) {
+    CN(Cortecs, String, Builder) builder = CN(Cortecs, String, Builder, new)(0);
+    // 1, 2, 3, and 4 byte encodings
+    CN(Cortecs, String, Builder, append_codepoint)(&builder, 0x41);
+    CN(Cortecs, String, Builder, append_codepoint)(&builder, 0xE9);
+    CN(Cortecs, String, Builder, append_codepoint)(&builder, 0xE44);
+    CN(Cortecs, String, Builder, append_codepoint)(&builder, 0x1F600);
+    CN(Cortecs, String) out = CN(Cortecs, String, Builder, finish)(&builder);
+
+    TEST_ASSERT_EQUAL_STRING("A\xC3\xA9\xE0\xB9\x84\xF0\x9F\x98\x80", CN(Cortecs, String, cstr)(&out));
+}
+
+static void test_builder_growth(void) {
+    CN(Cortecs, String, Builder) builder = CN(Cortecs, String, Builder, new)(0);
+    char expected[4096];
+    for (uint32_t i = 0; i < sizeof(expected) - 1; i++) {
+        expected[i] = (char)('a' + i % 26);
+        CN(Cortecs, String, Builder, append_bytes)(&builder, &expected[i], 1);
+    }
+    expected[sizeof(expected) - 1] = 0;
+
+    // longer than the remaining capacity
+    char long_value[512];
+    memset(long_value, 'z', sizeof(long_value) - 1);
+    long_value[sizeof(long_value) - 1] = 0;
+    CN(Cortecs, String, Builder, append_format)(&builder, "%s", long_value);
+
+    CN(Cortecs, String) out = CN(Cortecs, String, Builder, finish)(&builder);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected) + sizeof(long_value) - 1, CN(Cortecs, String, capacity)(out));
+    TEST_ASSERT_EQUAL_MEMORY(expected, CN(Cortecs, String, cstr)(&out), sizeof(expected) - 1);
+    TEST_ASSERT_EQUAL_STRING(long_value, CN(Cortecs, String, cstr)(&out) + sizeof(expected) - 1);
+}
+
+static void test_symbol_intern(void) {
+    CN(Cortecs, Symbol) foo = CN(Cortecs, Symbol, intern)("foobar", 3);
+    CN(Cortecs, Symbol) foo_again = CN(Cortecs, Symbol, intern_string)(CN(Cortecs, String, from_cstr)("foo"));
+    CN(Cortecs, Symbol) foobar = CN(Cortecs, Symbol, intern)("foobar", 6);
+
+    TEST_ASSERT_TRUE(CN(Cortecs, Symbol, equals)(foo, foo_again));
+    TEST_ASSERT_FALSE(CN(Cortecs, Symbol, equals)(foo, foobar));
+    TEST_ASSERT_EQUAL_STRING("foo", CN(Cortecs, Symbol, cstr)(foo));
+    TEST_ASSERT_EQUAL_UINT32(3, CN(Cortecs, Symbol, length)(foo));
+    TEST_ASSERT_TRUE(CN(Cortecs, Symbol, hash)(foo) == CN(Cortecs, Symbol, hash_bytes)("foo", 3));
+}
+
+static void test_symbol_table_growth(void) {
+    // enough symbols to grow every shard
+    CN(Cortecs, Symbol) symbols[16384];
+    char name[sizeof("symbol_16384")];
+    for (uint32_t i = 0; i < 16384; i++) {
+        int length = snprintf(name, sizeof(name), "symbol_%" PRIu32, i);
+        symbols[i] = CN(Cortecs, Symbol, intern)(name, length);
+    }
+
+    for (uint32_t i = 0; i < 16384; i++) {
+        int length = snprintf(name, sizeof(name), "symbol_%" PRIu32, i);
+        CN(Cortecs, Symbol) symbol = CN(Cortecs, Symbol, intern)(name, length);
+        TEST_ASSERT_TRUE(CN(Cortecs, Symbol, equals)(symbols[i], symbol));
+        TEST_ASSERT_EQUAL_STRING(name, CN(Cortecs, Symbol, cstr)(symbol));
+    }
+}
+
+static void test_slice(void) {
+    CN(Cortecs, String) str = CN(Cortecs, String, from_cstr)("hello world, hello world");
+    CN(Cortecs, String, Slice) whole = CN(Cortecs, String, as_slice)(str);
+    TEST_ASSERT_EQUAL_UINT32(24, whole.length);
+
+    CN(Cortecs, String, Slice) world_slice = CN(Cortecs, String, slice)(str, 6, 5);
+    TEST_ASSERT_TRUE(world_slice.content == str.content);
+    TEST_ASSERT_EQUAL_MEMORY("world", CN(Cortecs, String, Slice, bytes)(world_slice), 5);
+
+    CN(Cortecs, String, Slice) orl = CN(Cortecs, String, Slice, slice)(world_slice, 1, 3);
+    TEST_ASSERT_EQUAL_UINT32(7, orl.offset);
+    TEST_ASSERT_EQUAL_MEMORY("orl", CN(Cortecs, String, Slice, bytes)(orl), 3);
+
+    CN(Cortecs, String) copy = CN(Cortecs, String, Slice, to_string)(orl);
+    TEST_ASSERT_EQUAL_STRING("orl", CN(Cortecs, String, cstr)(&copy));
+}
+
+static void test_slice_equals(void) {
+    CN(Cortecs, String) left = CN(Cortecs, String, from_cstr)("foo bar foo");
+    CN(Cortecs, String) right = CN(Cortecs, String, from_cstr)("foo");
+
+    CN(Cortecs, String, Slice) first = CN(Cortecs, String, slice)(left, 0, 3);
+    CN(Cortecs, String, Slice) bar = CN(Cortecs, String, slice)(left, 4, 3);
+    CN(Cortecs, String, Slice) last = CN(Cortecs, String, slice)(left, 8, 3);
+    CN(Cortecs, String, Slice) other = CN(Cortecs, String, as_slice)(right);
+    CN(Cortecs, String, Slice) empty = CN(Cortecs, String, slice)(left, 3, 0);
+
+    TEST_ASSERT_TRUE(CN(Cortecs, String, Slice, equals)(first, last));
+    TEST_ASSERT_TRUE(CN(Cortecs, String, Slice, equals)(first, other));
+    TEST_ASSERT_FALSE(CN(Cortecs, String, Slice, equals)(first, bar));
+    TEST_ASSERT_FALSE(CN(Cortecs, String, Slice, equals)(first, empty));
+    TEST_ASSERT_TRUE(CN(Cortecs, String, Slice, equals)(empty, CN(Cortecs, String, slice)(right, 1, 0)));
+}
+
+static void test_slice_keeps_content_alive(void) {
+    ecs_defer_end(world);
+
+    ecs_defer_begin(world);
+    CN(Cortecs, String) str = CN(Cortecs, String, from_cstr)("hello world, hello world");
+    CN(Cortecs, Array, CT(CN(Cortecs, String, Slice))) slices = cortecs_gc_alloc_array(CN(Cortecs, String, Slice), 1);
+    cortecs_gc_inc(slices);
+    cortecs_gc_inc(str.content);
+    slices->elements[0] = CN(Cortecs, String, slice)(str, 6, 5);
+    ecs_defer_end(world);
+
+    // the slice holds the only reference to the content
+    TEST_ASSERT_TRUE(cortecs_gc_is_alive(str.content));
+    TEST_ASSERT_EQUAL_MEMORY("world", CN(Cortecs, String, Slice, bytes)(slices->elements[0]), 5);
+
+    // collecting the slices releases the content
+    cortecs_gc_dec(slices);
+    TEST_ASSERT_FALSE(cortecs_gc_is_alive(str.content));
+
+    ecs_defer_begin(world);
+}
+
+static void test_inline_strings(void) {
+    // the longest inline string
+    CN(Cortecs, String) short_str = CN(Cortecs, String, from_cstr)("abcdefghijklmn");
+    TEST_ASSERT_TRUE(CN(Cortecs, String, is_inline)(short_str));
+    TEST_ASSERT_EQUAL_UINT32(15, CN(Cortecs, String, capacity)(short_str));
+    TEST_ASSERT_EQUAL_STRING("abcdefghijklmn", CN(Cortecs, String, cstr)(&short_str));
+
+    // the shortest gc allocated string
+    CN(Cortecs, String) long_str = CN(Cortecs, String, from_cstr)("abcdefghijklmno");
+    TEST_ASSERT_FALSE(CN(Cortecs, String, is_inline)(long_str));
+    TEST_ASSERT_EQUAL_UINT32(16, CN(Cortecs, String, capacity)(long_str));
+    TEST_ASSERT_EQUAL_STRING("abcdefghijklmno", CN(Cortecs, String, cstr)(&long_str));
+
+    CN(Cortecs, String) empty = CN(Cortecs, String, new)("");
+    TEST_ASSERT_TRUE(CN(Cortecs, String, is_inline)(empty));
+    TEST_ASSERT_FALSE(CN(Cortecs, String, is_null)(empty));
+    TEST_ASSERT_TRUE(CN(Cortecs, String, is_null)((CN(Cortecs, String)){.content = NULL}));
+
+    // a gc allocated string with inline sized content still equals the inline string
+    CN(Cortecs, String, Builder) builder = CN(Cortecs, String, Builder, new)(64);
+    CN(Cortecs, String, Builder, append_bytes)(&builder, "abc", 3);
+    CN(Cortecs, String) allocated = CN(Cortecs, String, Builder, finish)(&builder);
+    TEST_ASSERT_FALSE(CN(Cortecs, String, is_inline)(allocated));
+    TEST_ASSERT_TRUE(CN(Cortecs, String, equals)(allocated, CN(Cortecs, String, from_cstr)("abc")));
+    TEST_ASSERT_FALSE(CN(Cortecs, String, equals)(allocated, CN(Cortecs, String, from_cstr)("abd")));
+}
+
+static void test_inline_strings_dont_allocate(void) {
+    cortecs_gc_stats_t before = cortecs_gc_stats();
+    CN(Cortecs, String) str = CN(Cortecs, String, new)("%d", 12345);
+
+    CN(Cortecs, String, Builder) builder = CN(Cortecs, String, Builder, new)(0);
+    CN(Cortecs, String, Builder, append_string)(&builder, str);
+    CN(Cortecs, String, Builder, append_codepoint)(&builder, 0xE44);
+    CN(Cortecs, String) built = CN(Cortecs, String, Builder, finish)(&builder);
+    cortecs_gc_stats_t after = cortecs_gc_stats();
+
+    TEST_ASSERT_TRUE(before.allocations == after.allocations);
+    TEST_ASSERT_EQUAL_STRING("12345\xE0\xB9\x84", CN(Cortecs, String, cstr)(&built));
+}
+
 static void test_equality(const char *left, const char *right, bool areEqual) {
     CN(Cortecs, String) left_str = CN(Cortecs, String, new)("%s", left);
     CN(Cortecs, String) right_str = CN(Cortecs, String, new)("%s", right);
@@ -34,10 +239,272 @@ static void test_string_equals(void) {
     test_equality("foo", "foobar", false);
 }
 
+static const CN(Cortecs, Kernel, Isa) kernel_isas[] = {
+    CORTECS_KERNEL_ISA_SCALAR,
+    CORTECS_KERNEL_ISA_SSE2,
+    CORTECS_KERNEL_ISA_AVX2,
+};
+
+#define KERNEL_TEST_MAX_LENGTH 100
+
+static void test_kernel_equals(void) {
+    char left[KERNEL_TEST_MAX_LENGTH];
+    char right[KERNEL_TEST_MAX_LENGTH];
+    srand(0);
+    for (uint32_t i = 0; i < KERNEL_TEST_MAX_LENGTH; i++) {
+        left[i] = (char)(rand() % 256);
+    }
+
+    for (size_t isa = 0; isa < sizeof(kernel_isas) / sizeof(kernel_isas[0]); isa++) {
+        if (!CN(Cortecs, Kernel, set_isa)(kernel_isas[isa])) {
+            continue;
+        }
+
+        for (uint32_t length = 0; length <= KERNEL_TEST_MAX_LENGTH; length++) {
+            memcpy(right, left, length);
+            TEST_ASSERT_TRUE(CN(Cortecs, Kernel, equals)(left, right, length));
+
+            // differences after a null terminator are still differences
+            for (uint32_t i = 0; i < length; i++) {
+                right[i] ^= 1;
+                TEST_ASSERT_FALSE(CN(Cortecs, Kernel, equals)(left, right, length));
+                right[i] ^= 1;
+            }
+        }
+    }
+    CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, detect_isa)());
+}
+
+typedef struct {
+    const char *bytes;
+    bool is_valid;
+} utf8_case;
+
+static const utf8_case utf8_cases[] = {
+    {"a", true},
+    {"\xC2\x80", true},
+    {"\xDF\xBF", true},
+    {"\xE0\xA0\x80", true},
+    {"\xE0\xB9\x84", true},
+    {"\xED\x9F\xBF", true},
+    {"\xEF\xBF\xBF", true},
+    {"\xF0\x90\x80\x80", true},
+    {"\xF4\x8F\xBF\xBF", true},
+    // unexpected continuation bytes
+    {"\x80", false},
+    {"\xBF", false},
+    // overlong encodings
+    {"\xC0\x80", false},
+    {"\xC1\xBF", false},
+    {"\xE0\x9F\xBF", false},
+    {"\xF0\x8F\xBF\xBF", false},
+    // surrogates
+    {"\xED\xA0\x80", false},
+    {"\xED\xBF\xBF", false},
+    // above U+10FFFF
+    {"\xF4\x90\x80\x80", false},
+    {"\xF5\x80\x80\x80", false},
+    {"\xFF", false},
+    // truncated sequences
+    {"\xC2", false},
+    {"\xE0\xA0", false},
+    {"\xF0\x90\x80", false},
+    {"\xE0\xA0" "a", false},
+};
+
+static void test_kernel_validate_utf8(void) {
+    char buffer[KERNEL_TEST_MAX_LENGTH];
+    for (size_t isa = 0; isa < sizeof(kernel_isas) / sizeof(kernel_isas[0]); isa++) {
+        if (!CN(Cortecs, Kernel, set_isa)(kernel_isas[isa])) {
+            continue;
+        }
+
+        TEST_ASSERT_TRUE(CN(Cortecs, Kernel, validate_utf8)("", 0));
+        for (size_t i = 0; i < sizeof(utf8_cases) / sizeof(utf8_cases[0]); i++) {
+            uint32_t length = strlen(utf8_cases[i].bytes);
+
+            // move the case across every block boundary both at the end of the input and followed by ascii
+            for (uint32_t offset = 0; offset + length <= KERNEL_TEST_MAX_LENGTH; offset++) {
+                memset(buffer, 'a', sizeof(buffer));
+                memcpy(buffer + offset, utf8_cases[i].bytes, length);
+                const char *isa_name = CN(Cortecs, Kernel, isa_name)(kernel_isas[isa]);
+                bool is_valid = CN(Cortecs, Kernel, validate_utf8)(buffer, offset + length);
+                TEST_ASSERT_TRUE_MESSAGE(is_valid == utf8_cases[i].is_valid, isa_name);
+                is_valid = CN(Cortecs, Kernel, validate_utf8)(buffer, sizeof(buffer));
+                TEST_ASSERT_TRUE_MESSAGE(is_valid == utf8_cases[i].is_valid, isa_name);
+            }
+        }
+    }
+    CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, detect_isa)());
+}
+
+static void test_kernel_validate_utf8_matches_scalar(void) {
+    // mostly valid sequences with some random bytes so errors land at every position
+    static const char *pieces[] = {"a", "\xC3\xA9", "\xE0\xB8\x81", "\xF0\x9F\x98\x80", "\xED\x9F\xBF"};
+    char buffer[KERNEL_TEST_MAX_LENGTH];
+    srand(0);
+    for (uint32_t run = 0; run < 10000; run++) {
+        uint32_t length = 0;
+        while (length + 4 <= sizeof(buffer)) {
+            if (rand() % 64 == 0) {
+                buffer[length++] = (char)(rand() % 256);
+            } else {
+                const char *piece = pieces[rand() % 5];
+                memcpy(buffer + length, piece, strlen(piece));
+                length += strlen(piece);
+            }
+        }
+        length = rand() % (length + 1);
+
+        CN(Cortecs, Kernel, set_isa)(CORTECS_KERNEL_ISA_SCALAR);
+        bool expected = CN(Cortecs, Kernel, validate_utf8)(buffer, length);
+        for (size_t isa = 1; isa < sizeof(kernel_isas) / sizeof(kernel_isas[0]); isa++) {
+            if (CN(Cortecs, Kernel, set_isa)(kernel_isas[isa])) {
+                TEST_ASSERT_TRUE_MESSAGE(CN(Cortecs, Kernel, validate_utf8)(buffer, length) == expected, CN(Cortecs, Kernel, isa_name)(kernel_isas[isa]));
+            }
+        }
+    }
+    CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, detect_isa)());
+}
+
+static void test_kernel_count_codepoints(void) {
+    static const uint32_t codepoints[] = {'a', 0x80, 0xE44, 0x10000, 0x10FFFF};
+    srand(0);
+    for (uint32_t length = 0; length < 200; length++) {
+        CN(Cortecs, String, Builder) builder = CN(Cortecs, String, Builder, new)(0);
+        for (uint32_t i = 0; i < length; i++) {
+            CN(Cortecs, String, Builder, append_codepoint)(&builder, codepoints[rand() % 5]);
+        }
+        CN(Cortecs, String) str = CN(Cortecs, String, Builder, finish)(&builder);
+        const char *bytes = CN(Cortecs, String, cstr)(&str);
+        uint32_t size = CN(Cortecs, String, capacity)(str) - 1;
+
+        for (size_t isa = 0; isa < sizeof(kernel_isas) / sizeof(kernel_isas[0]); isa++) {
+            if (!CN(Cortecs, Kernel, set_isa)(kernel_isas[isa])) {
+                continue;
+            }
+
+            TEST_ASSERT_EQUAL_UINT32(length, CN(Cortecs, Kernel, count_codepoints)(bytes, size));
+            TEST_ASSERT_TRUE(CN(Cortecs, Kernel, validate_utf8)(bytes, size));
+        }
+    }
+    CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, detect_isa)());
+}
+
+static void test_kernel_count_lines(void) {
+    static const char *pieces[] = {"a", "\n", "\xC3\xA9", "\xE0\xB8\x81", "\xF0\x9F\x98\x80"};
+    char buffer[4 * KERNEL_TEST_MAX_LENGTH];
+    srand(0);
+    for (uint32_t run = 0; run < 1000; run++) {
+        uint32_t length = 0;
+        uint32_t newlines = 0;
+        uint32_t columns = 0;
+        while (length + 4 <= sizeof(buffer) && rand() % 256 != 0) {
+            // newlines are rare in some runs so the last one is often far from the end
+            uint32_t piece = rand() % (run % 2 == 0 ? 5 : 64);
+            piece = piece < 5 ? piece : 0;
+            if (piece == 1) {
+                newlines++;
+                columns = 0;
+            } else {
+                columns++;
+            }
+            memcpy(buffer + length, pieces[piece], strlen(pieces[piece]));
+            length += strlen(pieces[piece]);
+        }
+
+        for (size_t isa = 0; isa < sizeof(kernel_isas) / sizeof(kernel_isas[0]); isa++) {
+            if (!CN(Cortecs, Kernel, set_isa)(kernel_isas[isa])) {
+                continue;
+            }
+
+            CN(Cortecs, Kernel, Lines) lines = CN(Cortecs, Kernel, count_lines)(buffer, length);
+            TEST_ASSERT_EQUAL_UINT32(newlines, lines.newlines);
+            TEST_ASSERT_EQUAL_UINT32(columns, lines.columns);
+        }
+    }
+
+    // enough newlines to overflow per byte counters
+    uint32_t length = 100000;
+    char *newlines = malloc(length);
+    memset(newlines, '\n', length);
+    for (size_t isa = 0; isa < sizeof(kernel_isas) / sizeof(kernel_isas[0]); isa++) {
+        if (CN(Cortecs, Kernel, set_isa)(kernel_isas[isa])) {
+            TEST_ASSERT_EQUAL_UINT32(length, CN(Cortecs, Kernel, count_lines)(newlines, length).newlines);
+        }
+    }
+    free(newlines);
+    CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, detect_isa)());
+}
+
+static void test_kernel_skip_either(void) {
+    uint8_t bytes[KERNEL_TEST_MAX_LENGTH];
+    for (uint32_t length = 0; length < KERNEL_TEST_MAX_LENGTH; length++) {
+        // every byte before stop is skipped
+        for (uint32_t stop = 0; stop <= length; stop++) {
+            for (uint32_t i = 0; i < length; i++) {
+                bytes[i] = i % 3 == 0 ? 7 : 8;
+            }
+            if (stop < length) {
+                bytes[stop] = 9;
+            }
+
+            for (size_t isa = 0; isa < sizeof(kernel_isas) / sizeof(kernel_isas[0]); isa++) {
+                if (!CN(Cortecs, Kernel, set_isa)(kernel_isas[isa])) {
+                    continue;
+                }
+
+                TEST_ASSERT_EQUAL_UINT32(stop, CN(Cortecs, Kernel, skip_either)(bytes, length, 7, 8));
+                // the second byte is always 8 so only the first can be skipped
+                TEST_ASSERT_EQUAL_UINT32(stop == 0 ? 0 : 1, CN(Cortecs, Kernel, skip_either)(bytes, length, 7, 7));
+            }
+        }
+    }
+    CN(Cortecs, Kernel, set_isa)(CN(Cortecs, Kernel, detect_isa)());
+}
+
+static void test_kernel_hash(void) {
+    char bytes[KERNEL_TEST_MAX_LENGTH] = {0};
+    TEST_ASSERT_TRUE(CN(Cortecs, Kernel, hash)("foo", 3, 0) == CN(Cortecs, Kernel, hash)("foo", 3, 0));
+    TEST_ASSERT_TRUE(CN(Cortecs, Kernel, hash)("foo", 3, 0) != CN(Cortecs, Kernel, hash)("foo", 3, 1));
+
+    // every byte of every length contributes to the hash
+    for (uint32_t length = 1; length <= KERNEL_TEST_MAX_LENGTH; length++) {
+        uint64_t hash = CN(Cortecs, Kernel, hash)(bytes, length, 0);
+        TEST_ASSERT_TRUE(hash != CN(Cortecs, Kernel, hash)(bytes, length - 1, 0));
+        for (uint32_t i = 0; i < length; i++) {
+            bytes[i] = 1;
+            TEST_ASSERT_TRUE(hash != CN(Cortecs, Kernel, hash)(bytes, length, 0));
+            bytes[i] = 0;
+        }
+    }
+}
+
 int main() {
     UNITY_BEGIN();
     RUN_TEST(test_copy_cstring);
+    RUN_TEST(test_copy_long_cstring);
+    RUN_TEST(test_format);
+    RUN_TEST(test_from_bytes);
+    RUN_TEST(test_from_cstr);
+    RUN_TEST(test_inline_strings);
+    RUN_TEST(test_inline_strings_dont_allocate);
+    RUN_TEST(test_builder_append);
+    RUN_TEST(test_builder_codepoints);
+    RUN_TEST(test_builder_growth);
+    RUN_TEST(test_symbol_intern);
+    RUN_TEST(test_symbol_table_growth);
+    RUN_TEST(test_slice);
+    RUN_TEST(test_slice_equals);
+    RUN_TEST(test_slice_keeps_content_alive);
     RUN_TEST(test_string_equals);
+    RUN_TEST(test_kernel_equals);
+    RUN_TEST(test_kernel_validate_utf8);
+    RUN_TEST(test_kernel_validate_utf8_matches_scalar);
+    RUN_TEST(test_kernel_count_codepoints);
+    RUN_TEST(test_kernel_count_lines);
+    RUN_TEST(test_kernel_skip_either);
+    RUN_TEST(test_kernel_hash);
     return UNITY_END();
 }
 
@@ -45,10 +512,13 @@ void setUp() {
     cortecs_world_init();
     cortecs_finalizer_init();
     cortecs_gc_init(NULL);
+    CN(Cortecs, String, init)();
+    CN(Cortecs, Symbol, init)();
     ecs_defer_begin(world);
 }
 
 void tearDown() {
     ecs_defer_end(world);
+    CN(Cortecs, Symbol, cleanup)();
     cortecs_world_cleanup();
 }
\ No newline at end of file